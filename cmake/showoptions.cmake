@@ -29,6 +29,8 @@ else()
   message(STATUS "Use PCH               : No")
 endif()
 
+message(STATUS "Cells per grid side   : ${GRID_CELLS}")
+
 if(DEBUG)
   message(STATUS "Build in debug-mode   : Yes")
 else()
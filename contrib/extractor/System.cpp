@@ -282,11 +282,27 @@ void ReadLiquidTypeTableDBC()
 
 // Map file format data
 static char const* MAP_MAGIC         = "MAPS";
-static char const* MAP_VERSION_MAGIC = "v1.3";
+static char const* MAP_VERSION_MAGIC = "v1.4";
 static char const* MAP_AREA_MAGIC    = "AREA";
 static char const* MAP_HEIGHT_MAGIC  = "MHGT";
 static char const* MAP_LIQUID_MAGIC  = "MLIQ";
 
+// sections start at multiples of this, so the data in them is aligned when the file is mapped into memory
+#define MAP_SECTION_ALIGNMENT 16
+
+uint32 alignSectionOffset(uint32 offset)
+{
+    return (offset + MAP_SECTION_ALIGNMENT - 1) & ~uint32(MAP_SECTION_ALIGNMENT - 1);
+}
+
+void writeSectionPadding(FILE* output, uint32 offset)
+{
+    static char const zero[MAP_SECTION_ALIGNMENT] = {};
+    long pos = ftell(output);
+    if (pos < long(offset))
+        fwrite(zero, 1, offset - pos, output);
+}
+
 struct map_fileheader
 {
     uint32 mapMagic;
@@ -431,7 +447,7 @@ bool ConvertADT(char* filename, char* filename2, int cell_y, int cell_x, uint32
         }
     }
 
-    map.areaMapOffset = sizeof(map);
+    map.areaMapOffset = alignSectionOffset(sizeof(map));
     map.areaMapSize   = sizeof(map_areaHeader);
 
     map_areaHeader areaHeader;
@@ -560,7 +576,7 @@ bool ConvertADT(char* filename, char* filename2, int cell_y, int cell_x, uint32
             maxHeight = CONF_use_minHeight;
     }
 
-    map.heightMapOffset = map.areaMapOffset + map.areaMapSize;
+    map.heightMapOffset = alignSectionOffset(map.areaMapOffset + map.areaMapSize);
     map.heightMapSize = sizeof(map_heightHeader);
 
     map_heightHeader heightHeader;
@@ -803,7 +819,7 @@ bool ConvertADT(char* filename, char* filename2, int cell_y, int cell_x, uint32
                     liquid_height[y][x] = CONF_use_minHeight;
             }
         }
-        map.liquidMapOffset = map.heightMapOffset + map.heightMapSize;
+        map.liquidMapOffset = alignSectionOffset(map.heightMapOffset + map.heightMapSize);
         map.liquidMapSize = sizeof(map_liquidHeader);
         liquidHeader.fourcc = *(uint32 const*)MAP_LIQUID_MAGIC;
         liquidHeader.flags = 0;
@@ -837,9 +853,9 @@ bool ConvertADT(char* filename, char* filename2, int cell_y, int cell_x, uint32
     uint16 holes[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
 
     if (map.liquidMapOffset)
-        map.holesOffset = map.liquidMapOffset + map.liquidMapSize;
+        map.holesOffset = alignSectionOffset(map.liquidMapOffset + map.liquidMapSize);
     else
-        map.holesOffset = map.heightMapOffset + map.heightMapSize;
+        map.holesOffset = alignSectionOffset(map.heightMapOffset + map.heightMapSize);
 
     map.holesSize = sizeof(holes);
     memset(holes, 0, map.holesSize);
@@ -864,11 +880,13 @@ bool ConvertADT(char* filename, char* filename2, int cell_y, int cell_x, uint32
     }
     fwrite(&map, sizeof(map), 1, output);
     // Store area data
+    writeSectionPadding(output, map.areaMapOffset);
     fwrite(&areaHeader, sizeof(areaHeader), 1, output);
     if (!(areaHeader.flags & MAP_AREA_NO_AREA))
         fwrite(area_flags, sizeof(area_flags), 1, output);
 
     // Store height data
+    writeSectionPadding(output, map.heightMapOffset);
     fwrite(&heightHeader, sizeof(heightHeader), 1, output);
     if (!(heightHeader.flags & MAP_HEIGHT_NO_HEIGHT))
     {
@@ -892,6 +910,7 @@ bool ConvertADT(char* filename, char* filename2, int cell_y, int cell_x, uint32
     // Store liquid data if need
     if (map.liquidMapOffset)
     {
+        writeSectionPadding(output, map.liquidMapOffset);
         fwrite(&liquidHeader, sizeof(liquidHeader), 1, output);
         if (!(liquidHeader.flags & MAP_LIQUID_NO_TYPE))
         {
@@ -906,6 +925,7 @@ bool ConvertADT(char* filename, char* filename2, int cell_y, int cell_x, uint32
     }
 
     // store hole data
+    writeSectionPadding(output, map.holesOffset);
     fwrite(holes, map.holesSize, 1, output);
 
     fclose(output);
@@ -62,7 +62,8 @@ namespace MMAP
     // see following files:
     // contrib/extractor/system.cpp
     // src/game/GridMap.cpp
-    static char const* MAP_VERSION_MAGIC = "v1.3";
+    static char const* MAP_VERSION_MAGIC = "v1.4";
+    static char const* MAP_VERSION_MAGIC_UNALIGNED = "v1.3";
 
     struct MeshData
     {
@@ -0,0 +1,5 @@
+ALTER TABLE db_version CHANGE COLUMN required_12939_01_mangos_command required_12940_01_mangos_command bit;
+
+DELETE FROM command WHERE name='server dbstats';
+INSERT INTO command VALUES
+('server dbstats',3,'Syntax: .server dbstats\r\n\r\nShow for each database and async connection the number of queued and executed requests and the latency between queueing and execution.');
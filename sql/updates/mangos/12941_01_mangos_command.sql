@@ -0,0 +1,5 @@
+ALTER TABLE db_version CHANGE COLUMN required_12940_01_mangos_command required_12941_01_mangos_command bit;
+
+DELETE FROM command WHERE name='server recvqueue';
+INSERT INTO command VALUES
+('server recvqueue',3,'Syntax: .server recvqueue [#count]\r\n\r\nShow the #count (default 10) sessions with the most received packets not handled yet and the number of packets handled per session update.');
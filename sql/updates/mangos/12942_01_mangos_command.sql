@@ -0,0 +1,5 @@
+ALTER TABLE db_version CHANGE COLUMN required_12941_01_mangos_command required_12942_01_mangos_command bit;
+
+DELETE FROM command WHERE name='server network';
+INSERT INTO command VALUES
+('server network',3,'Syntax: .server network\r\n\r\nShow the connections of every network thread, how many it accepted and their average and longest time from accept until the thread took over the socket.');
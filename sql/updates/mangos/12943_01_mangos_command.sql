@@ -0,0 +1,5 @@
+ALTER TABLE db_version CHANGE COLUMN required_12942_01_mangos_command required_12943_01_mangos_command bit;
+
+DELETE FROM command WHERE name='server opcodestats';
+INSERT INTO command VALUES
+('server opcodestats',3,'Syntax: .server opcodestats [#count] [time|in|out]\r\n\r\nShow the #count (default 10) opcodes with the most handler time, received bytes or sent bytes since server start, with their packet counts and handler time histogram.');
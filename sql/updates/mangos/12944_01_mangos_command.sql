@@ -0,0 +1,5 @@
+ALTER TABLE db_version CHANGE COLUMN required_12943_01_mangos_command required_12944_01_mangos_command bit;
+
+DELETE FROM command WHERE name='server recvqueue';
+INSERT INTO command VALUES
+('server recvqueue',3,'Syntax: .server recvqueue [#count]\r\n\r\nShow the #count (default 10) sessions with the most received packets not handled yet, including packets deferred by the opcode rate limits, with the packets deferred and dropped by the rate limits and the session updates stopped by the time budget since login.');
@@ -0,0 +1,5 @@
+ALTER TABLE db_version CHANGE COLUMN required_12944_01_mangos_command required_12945_01_mangos_command bit;
+
+DELETE FROM command WHERE name='server compression';
+INSERT INTO command VALUES
+('server compression',3,'Syntax: .server compression\r\n\r\nShow how many update packets were compressed and how many of them at the fastest level, the ratio of their size before and after compression and the time spent compressing in total, in the last world tick and at most in one tick.');
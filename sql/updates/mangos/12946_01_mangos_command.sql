@@ -0,0 +1,5 @@
+ALTER TABLE db_version CHANGE COLUMN required_12945_01_mangos_command required_12946_01_mangos_command bit;
+
+DELETE FROM command WHERE name='server mapstats';
+INSERT INTO command VALUES
+('server mapstats',3,'Syntax: .server mapstats [#count]\r\n\r\nShow the number of map update threads, the grid preload counters and the #count (default 10) loaded maps with the longest last update time, including their worst update time.');
@@ -0,0 +1,5 @@
+ALTER TABLE db_version CHANGE COLUMN required_12946_01_mangos_command required_12947_01_mangos_command bit;
+
+DELETE FROM command WHERE name='debug terrainbench';
+INSERT INTO command VALUES
+('debug terrainbench',3,'Syntax: .debug terrainbench [#count]\r\n\r\nCompare the time of #count (default 1000) ground height and line of sight queries at random points around you, done one by one and as a batch, and show the number of different results.');
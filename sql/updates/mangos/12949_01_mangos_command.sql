@@ -0,0 +1,5 @@
+ALTER TABLE db_version CHANGE COLUMN required_12948_01_mangos_command required_12949_01_mangos_command bit;
+
+DELETE FROM command WHERE name='server mapstats';
+INSERT INTO command VALUES
+('server mapstats',3,'Syntax: .server mapstats [#count]\r\n\r\nShow the number of map update threads, the grid preload, line of sight cache and pathfinding service counters and the #count (default 10) loaded maps with the longest last update time, including their worst update time and line of sight cache hit rate.');
@@ -459,7 +459,7 @@ void AchievementMgr::ResetAchievementCriteria(AchievementCriteriaTypes type, uin
 void AchievementMgr::DeleteFromDB(ObjectGuid guid)
 {
     uint32 lowguid = guid.GetCounter();
-    CharacterDatabase.BeginTransaction();
+    CharacterDatabase.BeginTransaction(lowguid);
     CharacterDatabase.PExecute("DELETE FROM character_achievement WHERE guid = %u", lowguid);
     CharacterDatabase.PExecute("DELETE FROM character_achievement_progress WHERE guid = %u", lowguid);
     CharacterDatabase.CommitTransaction();
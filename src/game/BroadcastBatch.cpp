@@ -0,0 +1,76 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "BroadcastBatch.h"
+#include "WorldSession.h"
+
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#  define BROADCAST_THREAD_LOCAL __declspec(thread)
+#else
+#  define BROADCAST_THREAD_LOCAL thread_local
+#endif
+
+static BROADCAST_THREAD_LOCAL BroadcastBatch* s_currentBatch = nullptr;
+
+BroadcastBatch::~BroadcastBatch()
+{
+    MANGOS_ASSERT(m_pending.empty());
+}
+
+void BroadcastBatch::Begin()
+{
+    MANGOS_ASSERT(!s_currentBatch && "BroadcastBatch nested on one thread");
+    s_currentBatch = this;
+}
+
+void BroadcastBatch::End()
+{
+    // unbind first, sessions must write to their sockets now
+    s_currentBatch = nullptr;
+
+    for (PendingMap::iterator itr = m_pending.begin(); itr != m_pending.end(); ++itr)
+        itr->first->SendPackets(itr->second);
+
+    m_pending.clear();
+}
+
+void BroadcastBatch::Add(WorldSession* session, SharedWorldPacket const& packet)
+{
+    m_pending[session].push_back(packet);
+}
+
+void BroadcastBatch::Flush(WorldSession* session)
+{
+    if (m_pending.empty())
+        return;
+
+    PendingMap::iterator itr = m_pending.find(session);
+    if (itr == m_pending.end())
+        return;
+
+    PacketList packets;
+    packets.swap(itr->second);
+    m_pending.erase(itr);
+
+    session->SendPackets(packets);
+}
+
+BroadcastBatch* BroadcastBatch::Current()
+{
+    return s_currentBatch;
+}
@@ -0,0 +1,80 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_BROADCASTBATCH_H
+#define MANGOS_BROADCASTBATCH_H
+
+#include "Common.h"
+#include "WorldPacket.h"
+
+#include <unordered_map>
+#include <vector>
+
+class WorldSession;
+
+/**
+ * Collects broadcast packets per receiving session while a map is updated.
+ *
+ * A batch is bound to the thread updating its map, WorldSession::SendPacket(SharedWorldPacket const&)
+ * adds to the bound batch instead of writing to the socket, and every session is flushed with a
+ * single socket lock when the update ends. Packets sent directly to a session first flush what is
+ * batched for it on this thread, so the client still receives everything in send order.
+ */
+class BroadcastBatch
+{
+    public:
+        typedef std::vector<SharedWorldPacket> PacketList;
+
+        BroadcastBatch() {}
+        ~BroadcastBatch();
+
+        /// Batch broadcasts of the calling thread until End()
+        void Begin();
+
+        /// Send everything batched and unbind from the calling thread
+        void End();
+
+        void Add(WorldSession* session, SharedWorldPacket const& packet);
+
+        /// Send what is batched for one session now
+        void Flush(WorldSession* session);
+
+        /// Batch bound to the calling thread, nullptr outside of map updates
+        static BroadcastBatch* Current();
+
+    private:
+        typedef std::unordered_map<WorldSession*, PacketList> PendingMap;
+
+        PendingMap m_pending;
+};
+
+/// Binds a batch to the calling thread for the lifetime of the guard
+class BroadcastBatchGuard
+{
+    public:
+        explicit BroadcastBatchGuard(BroadcastBatch& batch) : m_batch(batch) { m_batch.Begin(); }
+        ~BroadcastBatchGuard() { m_batch.End(); }
+
+    private:
+        BroadcastBatchGuard(BroadcastBatchGuard const&);
+        BroadcastBatchGuard& operator=(BroadcastBatchGuard const&);
+
+        BroadcastBatch& m_batch;
+};
+
+#endif
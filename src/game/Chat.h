@@ -34,6 +34,7 @@ struct SpellEntry;
 
 class QueryResult;
 class ChatHandler;
+class Database;
 class WorldSession;
 class WorldPacket;
 class GMTicket;
@@ -230,6 +231,7 @@ class MANGOS_DLL_SPEC ChatHandler
         bool HandleDebugSpellCheckCommand(char* args);
         bool HandleDebugSpellCoefsCommand(char* args);
         bool HandleDebugSpellModsCommand(char* args);
+        bool HandleDebugTerrainBenchCommand(char* args);
         bool HandleDebugUpdateWorldStateCommand(char* args);
 
         bool HandleDebugPlayCinematicCommand(char* args);
@@ -523,6 +525,12 @@ class MANGOS_DLL_SPEC ChatHandler
         bool HandleServerInfoCommand(char* args);
         bool HandleServerLogFilterCommand(char* args);
         bool HandleServerLogLevelCommand(char* args);
+        bool HandleServerMapStatsCommand(char* args);
+        bool HandleServerRecvQueueCommand(char* args);
+        bool HandleServerNetworkCommand(char* args);
+        bool HandleServerOpcodeStatsCommand(char* args);
+        bool HandleServerCompressionCommand(char* args);
+        bool HandleServerDbStatsCommand(char* args);
         bool HandleServerMotdCommand(char* args);
         bool HandleServerPLimitCommand(char* args);
         bool HandleServerResetAllRaidCommand(char* args);
@@ -687,6 +695,7 @@ class MANGOS_DLL_SPEC ChatHandler
         bool ShowPlayerListHelper(QueryResult* result, uint32* limit = nullptr, bool title = true, bool error = true);
         void ShowSpellListHelper(Player* target, SpellEntry const* spellInfo, LocaleConstant loc);
         void ShowPoolListHelper(uint16 pool_id);
+        void ShowDatabaseAsyncStats(char const* name, Database& db);
         void ShowTicket(GMTicket const* ticket);
         void ShowTriggerListHelper(AreaTriggerEntry const* atEntry);
         void ShowTriggerTargetListHelper(uint32 id, AreaTrigger const* at, bool subpart = false);
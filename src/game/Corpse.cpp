@@ -103,7 +103,7 @@ void Corpse::SaveToDB()
     MANGOS_ASSERT(GetType() != CORPSE_BONES);
 
     // prevent DB data inconsistence problems and duplicates
-    CharacterDatabase.BeginTransaction();
+    CharacterDatabase.BeginTransaction(GetOwnerGuid().GetCounter());
     DeleteFromDB();
 
     std::ostringstream ss;
@@ -186,6 +186,10 @@ void Creature::AddToWorld()
     SetEliteIfChosen();
 
     SummonCreaturePool();
+
+    // later changes are applied by Creature::Update on scaling epoch change
+    if (isAlive())
+        SetStatsBasedOnPlayerMaxLevel();
 }
 
 void Creature::RemoveFromWorld()
@@ -445,6 +449,10 @@ bool Creature::UpdateEntry(uint32 Entry, Team team, const CreatureData* data /*=
     if (eventData)
         ApplyGameEventSpells(eventData, true);
 
+    // SelectLevel reset the level, scale again when the entry changes while in world
+    if (IsInWorld() && isAlive())
+        SetStatsBasedOnPlayerMaxLevel();
+
     return true;
 }
 
@@ -631,7 +639,9 @@ void Creature::Update(uint32 update_diff, uint32 diff)
 
             RegenerateAll(update_diff);
 
-            this->SetStatsBasedOnPlayerMaxLevel();
+            // rescale when max player level or difficulty changed since the last check, or something else set the level
+            if (m_scalingEpoch != sMapMgr.GetScalingEpoch() || getLevel() != m_currentLevel)
+                SetStatsBasedOnPlayerMaxLevel();
             break;
         }
         default:
@@ -1645,6 +1655,9 @@ void Creature::SetDeathState(DeathState s)
 
         Unit::SetDeathState(ALIVE);
 
+        // respawn selected a new template level
+        SetStatsBasedOnPlayerMaxLevel();
+
         SetHealth(GetMaxHealth());
         SetLootRecipient(nullptr);
         if (GetTemporaryFactionFlags() & TEMPFACTION_RESTORE_RESPAWN)
@@ -2765,6 +2778,9 @@ bool Creature::IsTappedBy(Player* plr) const
 
 void Creature::SetStatsBasedOnPlayerMaxLevel()
 {
+    // read first, a change made meanwhile is seen at next update
+    m_scalingEpoch = sMapMgr.GetScalingEpoch();
+
     uint32 maxPlayerLevel = sMapMgr.GetMaxPlayerLevel();
     GameDifficulty gameDifficulty = sMapMgr.GetCurrentDifficulty();
     uint32 currentLevel = this->getLevel();
@@ -502,6 +502,7 @@ class MANGOS_DLL_SPEC Creature : public Unit
         bool Create(uint32 guidlow, CreatureCreatePos& cPos, CreatureInfo const* cinfo, Team team = TEAM_NONE, const CreatureData* data = nullptr, GameEventCreatureData const* eventData = nullptr);
         bool LoadCreatureAddon(bool reload);
         void SelectLevel(const CreatureInfo* cinfo, float percentHealth = 100.0f);
+        void SetStatsBasedOnPlayerMaxLevel();               // rescale to MapManager max player level and difficulty if they changed
         void LoadEquipment(uint32 equip_entry, bool force = false);
 
         bool HasStaticDBSpawnData() const;                  // listed in `creature` table and have fixed in DB guid
@@ -800,7 +801,6 @@ class MANGOS_DLL_SPEC Creature : public Unit
         void SetEliteIfChosen();
         bool CanBeModded() const;
         void SummonCreaturePool();
-        void SetStatsBasedOnPlayerMaxLevel();
 
         // below fields has potential for optimization
         bool m_AlreadyCallAssistance;
@@ -822,6 +822,7 @@ class MANGOS_DLL_SPEC Creature : public Unit
         bool IsPlayerSummon() const;
         uint32 m_currentLevel = 0;
         GameDifficulty m_currentDifficulty = DIFFICULTY_NORMAL;
+        uint32 m_scalingEpoch = 0;                          // MapManager scaling epoch the stats were last checked for
         GridReference<Creature> m_gridRef;
         CreatureInfo const* m_creatureInfo;                 // in difficulty mode > 0 can different from ObjMgr::GetCreatureTemplate(GetEntry())
 };
@@ -1866,7 +1866,12 @@ void GameObject::UpdateCollisionState() const
     if (!m_model || !IsInWorld())
         return;
 
-    m_model->enable(IsCollisionEnabled() ? GetPhaseMask() : 0);
+    uint32 phaseMask = IsCollisionEnabled() ? GetPhaseMask() : 0;
+    if (m_model->getPhaseMask() == phaseMask)
+        return;
+
+    m_model->enable(phaseMask);
+    GetMap()->UpdateGameObjectModelCollision(*m_model);
 }
 
 void GameObject::UpdateModel()
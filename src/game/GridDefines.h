@@ -42,9 +42,16 @@ class Camera;
 #define MIN_GRID_DELAY          (MINUTE*IN_MILLISECONDS)
 #define MIN_MAP_UPDATE_DELAY    50
 
-#define MAX_NUMBER_OF_CELLS     1
+// Cells per grid side. Grid notifiers (visibility, AoE searchers, broadcasts) only visit the cells
+// touched by their radius, so finer cells mean fewer objects walked for small radius searches.
+// Can be set at build time with -DGRID_CELLS=N, must fit the 6 bit cell fields of Cell
+#ifndef MAX_NUMBER_OF_CELLS
+#define MAX_NUMBER_OF_CELLS     8
+#endif
 #define SIZE_OF_GRID_CELL       (SIZE_OF_GRIDS/MAX_NUMBER_OF_CELLS)
 
+static_assert(MAX_NUMBER_OF_CELLS >= 1 && MAX_NUMBER_OF_CELLS <= 64, "MAX_NUMBER_OF_CELLS must be in range 1..64");
+
 #define CENTER_GRID_CELL_ID     (MAX_NUMBER_OF_CELLS*MAX_NUMBER_OF_GRIDS/2)
 #define CENTER_GRID_CELL_OFFSET (SIZE_OF_GRID_CELL/2)
 
@@ -24,6 +24,7 @@
 #include "DBCEnums.h"
 #include "DBCStores.h"
 #include "GridMap.h"
+#include "GridPreloader.h"
 #include "VMapFactory.h"
 #include "MoveMap.h"
 #include "World.h"
@@ -31,9 +32,25 @@
 #include "Util.h"
 
 #include <mutex>
+#include <type_traits>
+
+#if PLATFORM == PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GRIDMAP_USE_SSE2
+#include <emmintrin.h>
+#endif
 
 char const* MAP_MAGIC         = "MAPS";
-char const* MAP_VERSION_MAGIC = "v1.3";
+char const* MAP_VERSION_MAGIC = "v1.4";                     // sections aligned for use in place from a file mapping
+char const* MAP_VERSION_MAGIC_UNALIGNED = "v1.3";           // sections are read into own arrays
 char const* MAP_AREA_MAGIC    = "AREA";
 char const* MAP_HEIGHT_MAGIC  = "MHGT";
 char const* MAP_LIQUID_MAGIC  = "MLIQ";
@@ -66,6 +83,9 @@ GridMap::GridMap()
     m_liquidFlags = nullptr;
     m_liquidEntry = nullptr;
     m_liquid_map  = nullptr;
+
+    m_mappedData = nullptr;
+    m_mappedSize = 0;
 }
 
 GridMap::~GridMap()
@@ -88,6 +108,14 @@ bool GridMap::loadData(char* filename)
     if (header.mapMagic     == *((uint32 const*)(MAP_MAGIC)) &&
             header.versionMagic == *((uint32 const*)(MAP_VERSION_MAGIC)) &&
             IsAcceptableClientBuild(header.buildMagic))
+    {
+        fclose(in);
+        return loadMappedData(filename, header);
+    }
+
+    if (header.mapMagic     == *((uint32 const*)(MAP_MAGIC)) &&
+            header.versionMagic == *((uint32 const*)(MAP_VERSION_MAGIC_UNALIGNED)) &&
+            IsAcceptableClientBuild(header.buildMagic))
     {
         // loadup area data
         if (header.areaMapOffset && !loadAreaData(in, header.areaMapOffset, header.areaMapSize))
@@ -132,12 +160,21 @@ bool GridMap::loadData(char* filename)
 
 void GridMap::unloadData()
 {
-    delete[] m_area_map;
-    delete[] m_V9;
-    delete[] m_V8;
-    delete[] m_liquidEntry;
-    delete[] m_liquidFlags;
-    delete[] m_liquid_map;
+    if (m_mappedData)
+    {
+        unmapFile();
+        m_mappedData = nullptr;
+        m_mappedSize = 0;
+    }
+    else
+    {
+        delete[] m_area_map;
+        delete[] m_V9;
+        delete[] m_V8;
+        delete[] m_liquidEntry;
+        delete[] m_liquidFlags;
+        delete[] m_liquid_map;
+    }
 
     m_area_map = nullptr;
     m_V9 = nullptr;
@@ -159,8 +196,9 @@ bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
     m_gridArea = header.gridArea;
     if (!(header.flags & MAP_AREA_NO_AREA))
     {
-        m_area_map = new uint16 [16 * 16];
-        fread(m_area_map, sizeof(uint16), 16 * 16, in);
+        uint16* areaMap = new uint16 [16 * 16];
+        fread(areaMap, sizeof(uint16), 16 * 16, in);
+        m_area_map = areaMap;
     }
 
     return true;
@@ -179,28 +217,34 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
     {
         if ((header.flags & MAP_HEIGHT_AS_INT16))
         {
-            m_uint16_V9 = new uint16 [129 * 129];
-            m_uint16_V8 = new uint16 [128 * 128];
-            fread(m_uint16_V9, sizeof(uint16), 129 * 129, in);
-            fread(m_uint16_V8, sizeof(uint16), 128 * 128, in);
+            uint16* v9 = new uint16 [129 * 129];
+            uint16* v8 = new uint16 [128 * 128];
+            fread(v9, sizeof(uint16), 129 * 129, in);
+            fread(v8, sizeof(uint16), 128 * 128, in);
+            m_uint16_V9 = v9;
+            m_uint16_V8 = v8;
             m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 65535;
             m_gridGetHeight = &GridMap::getHeightFromUint16;
         }
         else if ((header.flags & MAP_HEIGHT_AS_INT8))
         {
-            m_uint8_V9 = new uint8 [129 * 129];
-            m_uint8_V8 = new uint8 [128 * 128];
-            fread(m_uint8_V9, sizeof(uint8), 129 * 129, in);
-            fread(m_uint8_V8, sizeof(uint8), 128 * 128, in);
+            uint8* v9 = new uint8 [129 * 129];
+            uint8* v8 = new uint8 [128 * 128];
+            fread(v9, sizeof(uint8), 129 * 129, in);
+            fread(v8, sizeof(uint8), 128 * 128, in);
+            m_uint8_V9 = v9;
+            m_uint8_V8 = v8;
             m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 255;
             m_gridGetHeight = &GridMap::getHeightFromUint8;
         }
         else
         {
-            m_V9 = new float [129 * 129];
-            m_V8 = new float [128 * 128];
-            fread(m_V9, sizeof(float), 129 * 129, in);
-            fread(m_V8, sizeof(float), 128 * 128, in);
+            float* v9 = new float [129 * 129];
+            float* v8 = new float [128 * 128];
+            fread(v9, sizeof(float), 129 * 129, in);
+            fread(v8, sizeof(float), 128 * 128, in);
+            m_V9 = v9;
+            m_V8 = v8;
             m_gridGetHeight = &GridMap::getHeightFromFloat;
         }
     }
@@ -237,17 +281,223 @@ bool GridMap::loadGridMapLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
 
     if (!(header.flags & MAP_LIQUID_NO_TYPE))
     {
-        m_liquidEntry = new uint16[16 * 16];
-        fread(m_liquidEntry, sizeof(uint16), 16 * 16, in);
+        uint16* liquidEntry = new uint16[16 * 16];
+        fread(liquidEntry, sizeof(uint16), 16 * 16, in);
+        m_liquidEntry = liquidEntry;
 
-        m_liquidFlags = new uint8[16 * 16];
-        fread(m_liquidFlags, sizeof(uint8), 16 * 16, in);
+        uint8* liquidFlags = new uint8[16 * 16];
+        fread(liquidFlags, sizeof(uint8), 16 * 16, in);
+        m_liquidFlags = liquidFlags;
     }
 
     if (!(header.flags & MAP_LIQUID_NO_HEIGHT))
     {
-        m_liquid_map = new float [m_liquid_width * m_liquid_height];
-        fread(m_liquid_map, sizeof(float), m_liquid_width * m_liquid_height, in);
+        float* liquidMap = new float [m_liquid_width * m_liquid_height];
+        fread(liquidMap, sizeof(float), m_liquid_width * m_liquid_height, in);
+        m_liquid_map = liquidMap;
+    }
+
+    return true;
+}
+
+bool GridMap::loadMappedData(char const* filename, GridMapFileHeader const& header)
+{
+    if (!mapFile(filename))
+    {
+        sLog.outError("Can't map file '%s' into memory", filename);
+        return false;
+    }
+
+    bool result = true;
+
+    if (header.areaMapOffset && !mapAreaData(header.areaMapOffset))
+    {
+        sLog.outError("Error loading map area data\n");
+        result = false;
+    }
+    else if (header.holesOffset && !mapHolesData(header.holesOffset))
+    {
+        sLog.outError("Error loading map holes data\n");
+        result = false;
+    }
+    else if (header.heightMapOffset && !mapHeightData(header.heightMapOffset))
+    {
+        sLog.outError("Error loading map height data\n");
+        result = false;
+    }
+    else if (header.liquidMapOffset && !mapGridMapLiquidData(header.liquidMapOffset))
+    {
+        sLog.outError("Error loading map liquids data\n");
+        result = false;
+    }
+
+    if (!result)
+        unloadData();
+
+    return result;
+}
+
+bool GridMap::mapFile(char const* filename)
+{
+#if PLATFORM == PLATFORM_WINDOWS
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart)
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);                                      // the mapping keeps the file open
+
+    if (!mapping)
+        return false;
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);                                   // the view keeps the mapping
+    if (!data)
+        return false;
+
+    m_mappedSize = size_t(size.QuadPart);
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);                                              // the mapping keeps the file open
+
+    if (data == MAP_FAILED)
+        return false;
+
+    // read the pages in the background, queries fault in what isn't there yet
+    posix_madvise(data, st.st_size, POSIX_MADV_WILLNEED);
+
+    m_mappedSize = size_t(st.st_size);
+#endif
+
+    m_mappedData = static_cast<char const*>(data);
+    return true;
+}
+
+void GridMap::unmapFile()
+{
+#if PLATFORM == PLATFORM_WINDOWS
+    UnmapViewOfFile(m_mappedData);
+#else
+    munmap(const_cast<char*>(m_mappedData), m_mappedSize);
+#endif
+}
+
+template<typename T>
+T const* GridMap::getMapped(uint32 offset, uint32 count) const
+{
+    // sections of aligned files start at multiples of 16, their data is aligned for its type
+    if (offset % std::alignment_of<T>::value || offset > m_mappedSize || count > (m_mappedSize - offset) / sizeof(T))
+        return nullptr;
+
+    return reinterpret_cast<T const*>(m_mappedData + offset);
+}
+
+bool GridMap::mapAreaData(uint32 offset)
+{
+    GridMapAreaHeader const* header = getMapped<GridMapAreaHeader>(offset, 1);
+    if (!header || header->fourcc != *((uint32 const*)(MAP_AREA_MAGIC)))
+        return false;
+
+    m_gridArea = header->gridArea;
+    if (!(header->flags & MAP_AREA_NO_AREA))
+    {
+        m_area_map = getMapped<uint16>(offset + sizeof(GridMapAreaHeader), 16 * 16);
+        if (!m_area_map)
+            return false;
+    }
+
+    return true;
+}
+
+bool GridMap::mapHeightData(uint32 offset)
+{
+    GridMapHeightHeader const* header = getMapped<GridMapHeightHeader>(offset, 1);
+    if (!header || header->fourcc != *((uint32 const*)(MAP_HEIGHT_MAGIC)))
+        return false;
+
+    m_gridHeight = header->gridHeight;
+    m_gridGetHeight = &GridMap::getHeightFromFlat;
+
+    if (header->flags & MAP_HEIGHT_NO_HEIGHT)
+        return true;
+
+    offset += sizeof(GridMapHeightHeader);
+
+    if ((header->flags & MAP_HEIGHT_AS_INT16))
+    {
+        m_uint16_V9 = getMapped<uint16>(offset, 129 * 129);
+        m_uint16_V8 = getMapped<uint16>(offset + 129 * 129 * sizeof(uint16), 128 * 128);
+        m_gridIntHeightMultiplier = (header->gridMaxHeight - header->gridHeight) / 65535;
+        m_gridGetHeight = &GridMap::getHeightFromUint16;
+    }
+    else if ((header->flags & MAP_HEIGHT_AS_INT8))
+    {
+        m_uint8_V9 = getMapped<uint8>(offset, 129 * 129);
+        m_uint8_V8 = getMapped<uint8>(offset + 129 * 129 * sizeof(uint8), 128 * 128);
+        m_gridIntHeightMultiplier = (header->gridMaxHeight - header->gridHeight) / 255;
+        m_gridGetHeight = &GridMap::getHeightFromUint8;
+    }
+    else
+    {
+        m_V9 = getMapped<float>(offset, 129 * 129);
+        m_V8 = getMapped<float>(offset + 129 * 129 * sizeof(float), 128 * 128);
+        m_gridGetHeight = &GridMap::getHeightFromFloat;
+    }
+
+    return m_V9 && m_V8;
+}
+
+bool GridMap::mapHolesData(uint32 offset)
+{
+    // too small to be worth a pointer into the mapping
+    uint16 const* holes = getMapped<uint16>(offset, 16 * 16);
+    if (!holes)
+        return false;
+
+    memcpy(m_holes, holes, sizeof(m_holes));
+    return true;
+}
+
+bool GridMap::mapGridMapLiquidData(uint32 offset)
+{
+    GridMapLiquidHeader const* header = getMapped<GridMapLiquidHeader>(offset, 1);
+    if (!header || header->fourcc != *((uint32 const*)(MAP_LIQUID_MAGIC)))
+        return false;
+
+    m_liquidType    = header->liquidType;
+    m_liquid_offX   = header->offsetX;
+    m_liquid_offY   = header->offsetY;
+    m_liquid_width  = header->width;
+    m_liquid_height = header->height;
+    m_liquidLevel   = header->liquidLevel;
+
+    offset += sizeof(GridMapLiquidHeader);
+
+    if (!(header->flags & MAP_LIQUID_NO_TYPE))
+    {
+        m_liquidEntry = getMapped<uint16>(offset, 16 * 16);
+        m_liquidFlags = getMapped<uint8>(offset + 16 * 16 * sizeof(uint16), 16 * 16);
+        if (!m_liquidEntry || !m_liquidFlags)
+            return false;
+
+        offset += 16 * 16 * (sizeof(uint16) + sizeof(uint8));
+    }
+
+    if (!(header->flags & MAP_LIQUID_NO_HEIGHT))
+    {
+        m_liquid_map = getMapped<float>(offset, m_liquid_width * m_liquid_height);
+        if (!m_liquid_map)
+            return false;
     }
 
     return true;
@@ -383,7 +633,7 @@ float GridMap::getHeightFromUint8(float x, float y) const
     y_int &= (MAP_RESOLUTION - 1);
 
     int32 a, b, c;
-    uint8* V9_h1_ptr = &m_uint8_V9[x_int * 128 + x_int + y_int];
+    uint8 const* V9_h1_ptr = &m_uint8_V9[x_int * 128 + x_int + y_int];
     if (x + y < 1)
     {
         if (x > y)
@@ -451,7 +701,7 @@ float GridMap::getHeightFromUint16(float x, float y) const
     y_int &= (MAP_RESOLUTION - 1);
 
     int32 a, b, c;
-    uint16* V9_h1_ptr = &m_uint16_V9[x_int * 128 + x_int + y_int];
+    uint16 const* V9_h1_ptr = &m_uint16_V9[x_int * 128 + x_int + y_int];
     if (x + y < 1)
     {
         if (x > y)
@@ -503,6 +753,102 @@ float GridMap::getHeightFromUint16(float x, float y) const
     return (float)((a * x) + (b * y) + c) * m_gridIntHeightMultiplier + m_gridHeight;
 }
 
+void GridMap::getHeights(float const* x, float const* y, float* heights, uint32 count)
+{
+#ifdef GRIDMAP_USE_SSE2
+    if (m_gridGetHeight == &GridMap::getHeightFromFloat && m_V8 && m_V9)
+        getHeightsInterpolated(m_V9, m_V8, x, y, heights, count, true);
+    else if (m_gridGetHeight == &GridMap::getHeightFromUint16 && m_uint16_V8 && m_uint16_V9)
+        getHeightsInterpolated(m_uint16_V9, m_uint16_V8, x, y, heights, count, false);
+    else if (m_gridGetHeight == &GridMap::getHeightFromUint8 && m_uint8_V8 && m_uint8_V9)
+        getHeightsInterpolated(m_uint8_V9, m_uint8_V8, x, y, heights, count, false);
+    else
+#endif
+        for (uint32 i = 0; i < count; ++i)
+            heights[i] = getHeight(x[i], y[i]);
+}
+
+#ifdef GRIDMAP_USE_SSE2
+static inline __m128 SelectPs(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+/// Same calculation as getHeightFrom*(), the corners are loaded per position and the triangle is selected and interpolated for 4 positions at once
+template<typename T>
+void GridMap::getHeightsInterpolated(T const* V9, T const* V8, float const* x, float const* y, float* heights, uint32 count, bool checkHoles) const
+{
+    bool isFloat = std::is_floating_point<T>::value;
+
+    for (uint32 first = 0; first < count; first += 4)
+    {
+        uint32 n = std::min<uint32>(count - first, 4);
+        float fx[4], fy[4], h1[4], h2[4], h3[4], h4[4], h5[4];
+        uint32 hole[4];
+
+        for (uint32 i = 0; i < 4; ++i)
+        {
+            if (i >= n)
+            {
+                fx[i] = fy[i] = h1[i] = h2[i] = h3[i] = h4[i] = h5[i] = 0.0f;
+                hole[i] = 0;
+                continue;
+            }
+
+            float px = MAP_RESOLUTION * (32 - x[first + i] / SIZE_OF_GRIDS);
+            float py = MAP_RESOLUTION * (32 - y[first + i] / SIZE_OF_GRIDS);
+
+            int x_int = (int)px;
+            int y_int = (int)py;
+            fx[i] = px - x_int;
+            fy[i] = py - y_int;
+            x_int &= (MAP_RESOLUTION - 1);
+            y_int &= (MAP_RESOLUTION - 1);
+
+            hole[i] = checkHoles && isHole(x_int, y_int) ? 0xFFFFFFFF : 0;
+
+            T const* V9_h1_ptr = &V9[x_int * 128 + x_int + y_int];
+            h1[i] = float(V9_h1_ptr[0]);
+            h2[i] = float(V9_h1_ptr[129]);
+            h3[i] = float(V9_h1_ptr[1]);
+            h4[i] = float(V9_h1_ptr[130]);
+            h5[i] = 2 * float(V8[x_int * 128 + y_int]);
+        }
+
+        __m128 vx = _mm_loadu_ps(fx);
+        __m128 vy = _mm_loadu_ps(fy);
+        __m128 vh1 = _mm_loadu_ps(h1);
+        __m128 vh2 = _mm_loadu_ps(h2);
+        __m128 vh3 = _mm_loadu_ps(h3);
+        __m128 vh4 = _mm_loadu_ps(h4);
+        __m128 vh5 = _mm_loadu_ps(h5);
+
+        // triangles 1 and 2 (x + y < 1), triangles 1 and 3 (x > y)
+        __m128 upper = _mm_cmplt_ps(_mm_add_ps(vx, vy), _mm_set1_ps(1.0f));
+        __m128 right = _mm_cmpgt_ps(vx, vy);
+
+        // coefficients of h = a*x + b*y + c of all four triangles
+        __m128 a = SelectPs(upper,
+                            SelectPs(right, _mm_sub_ps(vh2, vh1), _mm_sub_ps(_mm_sub_ps(vh5, vh1), vh3)),
+                            SelectPs(right, _mm_sub_ps(_mm_add_ps(vh2, vh4), vh5), _mm_sub_ps(vh4, vh3)));
+        __m128 b = SelectPs(upper,
+                            SelectPs(right, _mm_sub_ps(_mm_sub_ps(vh5, vh1), vh2), _mm_sub_ps(vh3, vh1)),
+                            SelectPs(right, _mm_sub_ps(vh4, vh2), _mm_sub_ps(_mm_add_ps(vh3, vh4), vh5)));
+        __m128 c = SelectPs(upper, vh1, _mm_sub_ps(vh5, vh4));
+
+        __m128 h = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, vx), _mm_mul_ps(b, vy)), c);
+        if (!isFloat)
+            h = _mm_add_ps(_mm_mul_ps(h, _mm_set1_ps(m_gridIntHeightMultiplier)), _mm_set1_ps(m_gridHeight));
+        h = SelectPs(_mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<__m128i const*>(hole))), _mm_set1_ps(INVALID_HEIGHT_VALUE), h);
+
+        float result[4];
+        _mm_storeu_ps(result, h);
+        for (uint32 i = 0; i < n; ++i)
+            heights[first + i] = result[i];
+    }
+}
+#endif
+
 float GridMap::getLiquidLevel(float x, float y)
 {
     if (!m_liquid_map)
@@ -654,7 +1000,7 @@ bool GridMap::ExistMap(uint32 mapid, int gx, int gy)
     GridMapFileHeader header;
     fread(&header, sizeof(header), 1, pf);
     if (header.mapMagic     != *((uint32 const*)(MAP_MAGIC)) ||
-            header.versionMagic != *((uint32 const*)(MAP_VERSION_MAGIC)) ||
+            (header.versionMagic != *((uint32 const*)(MAP_VERSION_MAGIC)) && header.versionMagic != *((uint32 const*)(MAP_VERSION_MAGIC_UNALIGNED))) ||
             !IsAcceptableClientBuild(header.buildMagic))
     {
         sLog.outError("Map file '%s' is non-compatible version (outdated?). Please, create new using ad.exe program.", tmp);
@@ -843,6 +1189,118 @@ float TerrainInfo::GetHeightStatic(float x, float y, float z, bool useVmaps/*=tr
         }
     }
 
+    return SelectStaticHeight(z, mapHeight, vmapHeight);
+}
+
+void TerrainInfo::GetHeightsStatic(TerrainHeightQuery* queries, uint32 count, bool useVmaps/*=true*/, float maxSearchDist/*=DEFAULT_HEIGHT_SEARCH*/) const
+{
+    if (!count)
+        return;
+
+    // positions on the same grid are handled together, in the order given within a grid
+    std::vector<uint32> gridKeys(count);
+    std::vector<uint32> order(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        int gx = (int)(32 - queries[i].x / SIZE_OF_GRIDS);
+        int gy = (int)(32 - queries[i].y / SIZE_OF_GRIDS);
+        gridKeys[i] = uint32(gx) << 16 | uint32(gy & 0xFFFF);
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&gridKeys](uint32 a, uint32 b) { return gridKeys[a] < gridKeys[b]; });
+
+    std::vector<float> xs(count);
+    std::vector<float> ys(count);
+    std::vector<float> mapHeights(count, VMAP_INVALID_HEIGHT_VALUE);
+    for (uint32 k = 0; k < count; ++k)
+    {
+        xs[k] = queries[order[k]].x;
+        ys[k] = queries[order[k]].y;
+    }
+
+    // find raw .map surface under Z coordinates (or well-defined above)
+    for (uint32 first = 0; first < count;)
+    {
+        uint32 last = first + 1;
+        while (last < count && gridKeys[order[last]] == gridKeys[order[first]])
+            ++last;
+
+        if (GridMap* gmap = const_cast<TerrainInfo*>(this)->GetGrid(xs[first], ys[first]))
+            gmap->getHeights(&xs[first], &ys[first], &mapHeights[first], last - first);
+
+        first = last;
+    }
+
+    std::vector<VMAP::HeightQuery> vmapQueries;
+    VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+    if (useVmaps && vmgr->isHeightCalcEnabled())
+    {
+        // same searches as GetHeightStatic(), each one for all positions still without height
+        vmapQueries.resize(count);
+        for (uint32 k = 0; k < count; ++k)
+        {
+            VMAP::HeightQuery& query = vmapQueries[k];
+            query.x = xs[k];
+            query.y = ys[k];
+            query.z = queries[order[k]].z + 2.f;
+            query.maxSearchDist = maxSearchDist;
+            if (mapHeights[k] > INVALID_HEIGHT && query.z - mapHeights[k] > maxSearchDist)
+                query.maxSearchDist = query.z - mapHeights[k] + 1.0f;
+        }
+        vmgr->getHeights(GetMapId(), &vmapQueries[0], count);
+
+        std::vector<VMAP::HeightQuery> retries;
+        std::vector<uint32> retryIndex;
+
+        // if not found in expected range, look for infinity range (case of far above floor, but below terrain-height)
+        for (uint32 k = 0; k < count; ++k)
+        {
+            if (vmapQueries[k].height <= INVALID_HEIGHT)
+            {
+                retries.push_back(vmapQueries[k]);
+                retries.back().maxSearchDist = 10000.0f;
+                retryIndex.push_back(k);
+            }
+        }
+
+        if (!retries.empty())
+        {
+            vmgr->getHeights(GetMapId(), &retries[0], retries.size());
+            for (size_t i = 0; i < retries.size(); ++i)
+                vmapQueries[retryIndex[i]].height = retries[i].height;
+        }
+
+        // still not found, look near terrain height
+        retries.clear();
+        retryIndex.clear();
+        for (uint32 k = 0; k < count; ++k)
+        {
+            if (vmapQueries[k].height <= INVALID_HEIGHT && mapHeights[k] > INVALID_HEIGHT && vmapQueries[k].z < mapHeights[k])
+            {
+                retries.push_back(vmapQueries[k]);
+                retries.back().z = mapHeights[k] + 2.0f;
+                retries.back().maxSearchDist = DEFAULT_HEIGHT_SEARCH;
+                retryIndex.push_back(k);
+            }
+        }
+
+        if (!retries.empty())
+        {
+            vmgr->getHeights(GetMapId(), &retries[0], retries.size());
+            for (size_t i = 0; i < retries.size(); ++i)
+                vmapQueries[retryIndex[i]].height = retries[i].height;
+        }
+    }
+
+    for (uint32 k = 0; k < count; ++k)
+    {
+        TerrainHeightQuery& query = queries[order[k]];
+        query.height = SelectStaticHeight(query.z, mapHeights[k], vmapQueries.empty() ? VMAP_INVALID_HEIGHT_VALUE : vmapQueries[k].height);
+    }
+}
+
+float TerrainInfo::SelectStaticHeight(float z, float mapHeight, float vmapHeight)
+{
     // mapHeight set for any above raw ground Z or <= INVALID_HEIGHT
     // vmapheight set for any under Z value or <= INVALID_HEIGHT
     if (vmapHeight > INVALID_HEIGHT)
@@ -1171,21 +1629,27 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
 
         if (!m_GridMaps[x][y])
         {
-            GridMap* map = new GridMap();
+            // the grid may be read already by the preload thread
+            GridMap* map = sGridPreloader.TakeGridMap(m_mapId, x, y);
+            if (!map)
+            {
+                map = new GridMap();
 
-            // map file name
-            int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
-            char* tmp = new char[len];
-            snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, x, y);
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Loading map %s", tmp);
+                // map file name
+                int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
+                char* tmp = new char[len];
+                snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, x, y);
+                DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Loading map %s", tmp);
 
-            if (!map->loadData(tmp))
-            {
-                sLog.outError("Error load map file: \n %s\n", tmp);
-                // ASSERT(false);
+                if (!map->loadData(tmp))
+                {
+                    sLog.outError("Error load map file: \n %s\n", tmp);
+                    // ASSERT(false);
+                }
+
+                delete[] tmp;
             }
 
-            delete[] tmp;
             m_GridMaps[x][y] = map;
 
             // load VMAPs for current map/grid...
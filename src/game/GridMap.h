@@ -127,22 +127,22 @@ class GridMap
 
         // Area data
         uint16 m_gridArea;
-        uint16* m_area_map;
+        uint16 const* m_area_map;
 
         // Height level data
         float m_gridHeight;
         float m_gridIntHeightMultiplier;
         union
         {
-            float* m_V9;
-            uint16* m_uint16_V9;
-            uint8* m_uint8_V9;
+            float const* m_V9;
+            uint16 const* m_uint16_V9;
+            uint8 const* m_uint8_V9;
         };
         union
         {
-            float* m_V8;
-            uint16* m_uint16_V8;
-            uint8* m_uint8_V8;
+            float const* m_V8;
+            uint16 const* m_uint16_V8;
+            uint8 const* m_uint8_V8;
         };
 
         // Liquid data
@@ -152,14 +152,27 @@ class GridMap
         uint8 m_liquid_width;
         uint8 m_liquid_height;
         float m_liquidLevel;
-        uint16* m_liquidEntry;
-        uint8* m_liquidFlags;
-        float* m_liquid_map;
+        uint16 const* m_liquidEntry;
+        uint8 const* m_liquidFlags;
+        float const* m_liquid_map;
+
+        // read-only mapping of a whole .map file in aligned layout, the data above points into it
+        char const* m_mappedData;
+        size_t m_mappedSize;
 
         bool loadAreaData(FILE* in, uint32 offset, uint32 size);
         bool loadHeightData(FILE* in, uint32 offset, uint32 size);
         bool loadGridMapLiquidData(FILE* in, uint32 offset, uint32 size);
         bool loadHolesData(FILE* in, uint32 offset, uint32 size);
+
+        bool loadMappedData(char const* filename, GridMapFileHeader const& header);
+        bool mapFile(char const* filename);
+        void unmapFile();
+        template<typename T> T const* getMapped(uint32 offset, uint32 count) const;
+        bool mapAreaData(uint32 offset);
+        bool mapHeightData(uint32 offset);
+        bool mapGridMapLiquidData(uint32 offset);
+        bool mapHolesData(uint32 offset);
         bool isHole(int row, int col) const;
 
         // Get height functions and pointers
@@ -169,6 +182,7 @@ class GridMap
         float getHeightFromUint16(float x, float y) const;
         float getHeightFromUint8(float x, float y) const;
         float getHeightFromFlat(float x, float y) const;
+        template<typename T> void getHeightsInterpolated(T const* V9, T const* V8, float const* x, float const* y, float* heights, uint32 count, bool checkHoles) const;
 
     public:
 
@@ -183,6 +197,8 @@ class GridMap
 
         uint16 getArea(float x, float y);
         float getHeight(float x, float y) { return (this->*m_gridGetHeight)(x, y); }
+        /// getHeight() of count positions, the heightmap interpolation is done for 4 positions at a time where possible
+        void getHeights(float const* x, float const* y, float* heights, uint32 count);
         float getLiquidLevel(float x, float y);
         uint8 getTerrainType(float x, float y);
         GridMapLiquidStatus getLiquidStatus(float x, float y, float z, uint8 ReqLiquidType, GridMapLiquidData* data = 0);
@@ -212,6 +228,13 @@ class MANGOS_DLL_SPEC Referencable
 #define DEFAULT_HEIGHT_SEARCH     10.0f                     // default search distance to find height at nearby locations
 #define DEFAULT_WATER_SEARCH      50.0f                     // default search distance to case detection water level
 
+/// One position of TerrainInfo::GetHeightsStatic()
+struct TerrainHeightQuery
+{
+    float x, y, z;
+    float height;                                           // set by GetHeightsStatic()
+};
+
 // class for sharing and managin GridMap objects
 class MANGOS_DLL_SPEC TerrainInfo : public Referencable<std::atomic_long>
 {
@@ -224,6 +247,8 @@ class MANGOS_DLL_SPEC TerrainInfo : public Referencable<std::atomic_long>
         // TODO: move all terrain/vmaps data info query functions
         // from 'Map' class into this class
         float GetHeightStatic(float x, float y, float z, bool checkVMap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
+        /// GetHeightStatic() for many positions, positions on the same grid use one grid lookup and vmap tree traversal is shared by neighboured positions
+        void GetHeightsStatic(TerrainHeightQuery* queries, uint32 count, bool checkVMap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
         float GetWaterLevel(float x, float y, float z, float* pGround = nullptr) const;
         float GetWaterOrGroundLevel(float x, float y, float z, float* pGround = nullptr, bool swim = false) const;
         bool IsInWater(float x, float y, float z, GridMapLiquidData* data = 0) const;
@@ -259,6 +284,7 @@ class MANGOS_DLL_SPEC TerrainInfo : public Referencable<std::atomic_long>
         TerrainInfo& operator=(const TerrainInfo&);
 
         GridMap* GetGrid(const float x, const float y);
+        static float SelectStaticHeight(float z, float mapHeight, float vmapHeight);
         GridMap* LoadMapAndVMap(const uint32 x, const uint32 y);
 
         int RefGrid(const uint32& x, const uint32& y);
@@ -0,0 +1,223 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "GridPreloader.h"
+#include "GridMap.h"
+#include "World.h"
+#include "Timer.h"
+#include "Log.h"
+#include "VMapFactory.h"
+#include "MapTree.h"
+
+#include <chrono>
+
+INSTANTIATE_SINGLETON_1(GridPreloader);
+
+/// Requests are ignored while this many grids wait for the preload thread
+static const uint32 MAX_QUEUED_GRIDS = 64;
+/// Requests are ignored while this many preloaded grids are not taken by a map
+static const uint32 MAX_READY_GRIDS = 128;
+/// Preloaded grids not taken by a map within this time (in milliseconds) are dropped
+static const uint32 READY_GRID_EXPIRE_TIME = 2 * MINUTE * IN_MILLISECONDS;
+
+/// Reads a whole file and throws the data away, the following read by the map thread is served from the file cache
+static void ReadIntoFileCache(std::string const& fileName)
+{
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (!file)
+        return;
+
+    char buffer[64 * 1024];
+    while (fread(buffer, 1, sizeof(buffer), file) == sizeof(buffer)) {}
+
+    fclose(file);
+}
+
+GridPreloader::GridPreloader() : m_active(false), m_cancel(false)
+{
+}
+
+GridPreloader::~GridPreloader()
+{
+    Deactivate();
+}
+
+void GridPreloader::Activate()
+{
+    MANGOS_ASSERT(!m_active);
+
+    m_cancel = false;
+    m_active = true;
+    m_worker = std::thread(&GridPreloader::WorkerThread, this);
+}
+
+void GridPreloader::Deactivate()
+{
+    if (!m_active)
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_cancel = true;
+    }
+    m_requestCond.notify_all();
+
+    m_worker.join();
+    m_active = false;
+
+    for (ReadyGridMap::iterator itr = m_ready.begin(); itr != m_ready.end(); ++itr)
+        delete itr->second.map;
+
+    m_ready.clear();
+    m_queue.clear();
+    m_pending.clear();
+}
+
+void GridPreloader::Request(uint32 mapId, uint32 x, uint32 y)
+{
+    if (!m_active)
+        return;
+
+    uint32 key = MakeKey(mapId, x, y);
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        if (m_queue.size() >= MAX_QUEUED_GRIDS || m_ready.size() >= MAX_READY_GRIDS)
+            return;
+
+        if (m_ready.find(key) != m_ready.end() || !m_pending.insert(key).second)
+            return;
+
+        m_queue.push_back(key);
+        ++m_stats.requested;
+    }
+    m_requestCond.notify_one();
+}
+
+GridMap* GridPreloader::TakeGridMap(uint32 mapId, uint32 x, uint32 y)
+{
+    if (!m_active)
+        return nullptr;
+
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    ReadyGridMap::iterator itr = m_ready.find(MakeKey(mapId, x, y));
+    if (itr == m_ready.end())
+        return nullptr;
+
+    GridMap* map = itr->second.map;
+    m_ready.erase(itr);
+    ++m_stats.used;
+
+    return map;
+}
+
+void GridPreloader::GetStats(GridPreloadStats& stats)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    stats = m_stats;
+    stats.queued = uint32(m_queue.size());
+    stats.ready = uint32(m_ready.size());
+}
+
+void GridPreloader::WorkerThread()
+{
+    std::unique_lock<std::mutex> guard(m_lock);
+
+    for (;;)
+    {
+        m_requestCond.wait_for(guard, std::chrono::seconds(10), [this] { return m_cancel || !m_queue.empty(); });
+
+        if (m_cancel)
+            return;
+
+        RemoveExpired();
+
+        if (m_queue.empty())
+            continue;
+
+        uint32 key = m_queue.front();
+        m_queue.pop_front();
+
+        guard.unlock();
+        LoadGrid(key);
+        guard.lock();
+    }
+}
+
+void GridPreloader::LoadGrid(uint32 key)
+{
+    uint32 mapId = key >> 12;
+    uint32 x = (key >> 6) & 0x3F;
+    uint32 y = key & 0x3F;
+
+    // same file as TerrainInfo::LoadMapAndVMap would read
+    int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
+    char* tmp = new char[len];
+    snprintf(tmp, len, (sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), mapId, x, y);
+    DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Preloading map %s", tmp);
+
+    GridMap* map = new GridMap();
+    if (!map->loadData(tmp))
+    {
+        // the map thread loads it again and reports the error
+        delete map;
+        map = nullptr;
+    }
+
+    delete[] tmp;
+
+    if (VMAP::VMapFactory::createOrGetVMapManager()->isMapLoadingEnabled())
+        ReadIntoFileCache(sWorld.GetDataPath() + "vmaps/" + VMAP::StaticMapTree::getTileFileName(mapId, x, y));
+
+    if (sWorld.getConfig(CONFIG_BOOL_MMAP_ENABLED))
+    {
+        char fileName[32];
+        snprintf(fileName, sizeof(fileName), "mmaps/%03u%02u%02u.mmtile", mapId, x, y);
+        ReadIntoFileCache(sWorld.GetDataPath() + fileName);
+    }
+
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    m_pending.erase(key);
+
+    if (map)
+    {
+        m_ready[key] = ReadyGrid(map, WorldTimer::getMSTime());
+        ++m_stats.loaded;
+    }
+}
+
+void GridPreloader::RemoveExpired()
+{
+    uint32 now = WorldTimer::getMSTime();
+
+    for (ReadyGridMap::iterator itr = m_ready.begin(); itr != m_ready.end();)
+    {
+        if (WorldTimer::getMSTimeDiff(itr->second.loadTime, now) >= READY_GRID_EXPIRE_TIME)
+        {
+            delete itr->second.map;
+            m_ready.erase(itr++);
+            ++m_stats.expired;
+        }
+        else
+            ++itr;
+    }
+}
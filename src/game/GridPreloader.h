@@ -0,0 +1,106 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_GRIDPRELOADER_H
+#define MANGOS_GRIDPRELOADER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+class GridMap;
+
+/// Counters since start
+struct GridPreloadStats
+{
+    GridPreloadStats() : requested(0), loaded(0), used(0), expired(0), queued(0), ready(0) {}
+
+    uint64 requested;                                       // grids queued for loading
+    uint64 loaded;                                          // grids loaded by the preload thread
+    uint64 used;                                            // preloaded grids taken by a map
+    uint64 expired;                                         // preloaded grids dropped because no map took them in time
+    uint32 queued;                                          // grids waiting for the preload thread now
+    uint32 ready;                                           // preloaded grids not taken yet
+};
+
+/**
+ * Loads terrain grids in a background thread before players reach them.
+ *
+ * Maps request the grids lying ahead of moving players (MapUpdate.PreloadLookAhead). The thread
+ * reads the .map file into a new GridMap and reads the vmap and mmap tiles of the grid once, so
+ * they are in the file cache. When the grid is loaded later TerrainInfo takes the ready GridMap
+ * instead of reading the file itself. Vmap and mmap tiles are still added to the shared trees
+ * and navmeshes by the map thread, those have no locks for concurrent changes.
+ */
+class GridPreloader
+{
+    public:
+        GridPreloader();
+        ~GridPreloader();
+
+        void Activate();
+        void Deactivate();
+
+        /// Queue terrain grid [x,y] (TerrainInfo coordinates) of the map for loading, does nothing when it is queued or ready already
+        void Request(uint32 mapId, uint32 x, uint32 y);
+
+        /// Takes the GridMap loaded by the preload thread, nullptr when it isn't ready
+        GridMap* TakeGridMap(uint32 mapId, uint32 x, uint32 y);
+
+        void GetStats(GridPreloadStats& stats);
+
+    private:
+        struct ReadyGrid
+        {
+            ReadyGrid() : map(nullptr), loadTime(0) {}
+            ReadyGrid(GridMap* _map, uint32 _loadTime) : map(_map), loadTime(_loadTime) {}
+
+            GridMap* map;
+            uint32 loadTime;
+        };
+
+        typedef std::unordered_map<uint32, ReadyGrid> ReadyGridMap;
+
+        static uint32 MakeKey(uint32 mapId, uint32 x, uint32 y) { return (mapId << 12) | (x << 6) | y; }
+
+        void WorkerThread();
+        void LoadGrid(uint32 key);
+        void RemoveExpired();
+
+        std::mutex m_lock;
+        std::condition_variable m_requestCond;
+        std::thread m_worker;
+        bool m_active;
+        bool m_cancel;
+
+        std::deque<uint32> m_queue;
+        std::unordered_set<uint32> m_pending;               // queued or being loaded
+        ReadyGridMap m_ready;
+
+        GridPreloadStats m_stats;
+};
+
+#define sGridPreloader MaNGOS::Singleton<GridPreloader>::Instance()
+
+#endif
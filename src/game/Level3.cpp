@@ -58,6 +58,10 @@
 #include "AuctionHouseBot/AuctionHouseBot.h"
 #include "SQLStorages.h"
 #include "LootMgr.h"
+#include "WorldSocketMgr.h"
+#include "OpcodeStats.h"
+#include "GridPreloader.h"
+#include "PathfindingService.h"
 
 static uint32 ahbotQualityIds[MAX_AUCTION_QUALITY] =
 {
@@ -6579,6 +6583,206 @@ bool ChatHandler::HandleInstanceStatsCommand(char* /*args*/)
     return true;
 }
 
+bool ChatHandler::HandleServerMapStatsCommand(char* args)
+{
+    uint32 limit;
+    if (!ExtractOptUInt32(&args, limit, 10))
+        return false;
+
+    std::vector<Map*> maps;
+    MapManager::MapMapType const& mapMap = sMapMgr.Maps();
+    for (MapManager::MapMapType::const_iterator itr = mapMap.begin(); itr != mapMap.end(); ++itr)
+        maps.push_back(itr->second);
+
+    std::sort(maps.begin(), maps.end(), [](Map const* a, Map const* b) { return a->GetLastUpdateTime() > b->GetLastUpdateTime(); });
+
+    PSendSysMessage("maps loaded: %u, map update threads: %u", uint32(maps.size()), sMapMgr.GetNumMapUpdateThreads());
+
+    if (uint32 lookAhead = sWorld.getConfig(CONFIG_UINT32_MAPUPDATE_PRELOAD_LOOKAHEAD))
+    {
+        GridPreloadStats stats;
+        sGridPreloader.GetStats(stats);
+
+        PSendSysMessage("grid preload (%u s ahead): requested " UI64FMTD ", loaded " UI64FMTD ", used " UI64FMTD ", expired " UI64FMTD ", queued %u, ready %u",
+                        lookAhead, stats.requested, stats.loaded, stats.used, stats.expired, stats.queued, stats.ready);
+    }
+
+    if (uint32 cacheTime = sWorld.getConfig(CONFIG_UINT32_VMAP_LOS_CACHE_TIME))
+    {
+        LineOfSightCacheStats stats;
+        for (std::vector<Map*>::const_iterator itr = maps.begin(); itr != maps.end(); ++itr)
+            stats.Add((*itr)->GetLineOfSightCache().GetStats());
+
+        PSendSysMessage("line of sight cache (%u ms): hits " UI64FMTD ", misses " UI64FMTD " (%u%% hits), invalidated " UI64FMTD ", cached %u",
+                        cacheTime, stats.hits, stats.misses, stats.GetHitPercent(), stats.invalidated, stats.entries);
+    }
+
+    if (uint32 numThreads = sWorld.getConfig(CONFIG_UINT32_MMAP_PATHFINDING_THREADS))
+    {
+        PathfindingStats stats;
+        sPathfindingService.GetStats(stats);
+
+        PSendSysMessage("pathfinding (%u threads): requested " UI64FMTD ", shared " UI64FMTD ", calculated " UI64FMTD ", queued %u, wait avg %u ms max %u ms, calculation avg %u us max %u us",
+                        numThreads, stats.requested, stats.shared, stats.calculated, stats.queued,
+                        stats.GetAverageWaitTime(), stats.maxWaitTime, stats.GetAverageCalcTime(), stats.maxCalcTime);
+    }
+
+    for (uint32 i = 0; i < maps.size() && i < limit; ++i)
+    {
+        Map const* map = maps[i];
+        PSendSysMessage("map %u instance %u (%s): players %u, last update %u ms, max %u ms, line of sight cache hits %u%%",
+                        map->GetId(), map->GetInstanceId(), map->GetMapName(), map->GetPlayers().getSize(),
+                        map->GetLastUpdateTime(), map->GetMaxUpdateTime(), map->GetLineOfSightCache().GetStats().GetHitPercent());
+    }
+
+    return true;
+}
+
+bool ChatHandler::HandleServerRecvQueueCommand(char* args)
+{
+    uint32 limit;
+    if (!ExtractOptUInt32(&args, limit, 10))
+        return false;
+
+    std::vector<std::pair<size_t, WorldSession*> > sessions;
+    {
+        std::vector<WorldSession*> allSessions;
+        sWorld.GetSessions(allSessions);
+
+        // sizes change while network threads receive, sort by one snapshot
+        sessions.reserve(allSessions.size());
+        for (std::vector<WorldSession*>::const_iterator itr = allSessions.begin(); itr != allSessions.end(); ++itr)
+            sessions.push_back(std::make_pair((*itr)->GetRecvQueueSize() + (*itr)->GetDeferredQueueSize(), *itr));
+    }
+
+    std::sort(sessions.begin(), sessions.end(), [](std::pair<size_t, WorldSession*> const& a, std::pair<size_t, WorldSession*> const& b) { return a.first > b.first; });
+
+    PSendSysMessage("sessions: %u, packets handled per session update: %u, time budget per session update: %u us",
+                    uint32(sessions.size()), sWorld.getConfig(CONFIG_UINT32_SESSION_PACKETS_PER_UPDATE), sWorld.getConfig(CONFIG_UINT32_SESSION_TIME_BUDGET));
+
+    for (uint32 i = 0; i < sessions.size() && i < limit && sessions[i].first; ++i)
+    {
+        WorldSession* session = sessions[i].second;
+        SessionThrottleCounters const& throttled = session->GetThrottleCounters();
+        PSendSysMessage("account %u (%s, player %s): " SIZEFMTD " packets queued, " SIZEFMTD " deferred by rate limits; since login %u deferred, %u dropped, %u updates over time budget",
+                        session->GetAccountId(), session->GetRemoteAddress().c_str(), session->GetPlayerName(), sessions[i].first - session->GetDeferredQueueSize(),
+                        session->GetDeferredQueueSize(), throttled.deferred, throttled.dropped, throttled.overBudget);
+    }
+
+    return true;
+}
+
+bool ChatHandler::HandleServerNetworkCommand(char* /*args*/)
+{
+    std::vector<NetworkThreadStats> stats;
+    sWorldSocketMgr.GetNetworkStats(stats);
+
+    PSendSysMessage("network threads: %u, accepting with SO_REUSEPORT: %s", uint32(stats.size()), sWorldSocketMgr.IsUsingReusePort() ? "yes" : "no");
+
+    for (uint32 i = 0; i < stats.size(); ++i)
+    {
+        NetworkThreadStats const& thread = stats[i];
+        PSendSysMessage("thread %u%s: %u connections, " UI64FMTD " accepted, accept latency avg %u us, max %u us",
+                        i, thread.listening ? " (listening)" : "", thread.connections, thread.accepted, thread.avgAcceptLatency, thread.maxAcceptLatency);
+    }
+
+    return true;
+}
+
+bool ChatHandler::HandleServerOpcodeStatsCommand(char* args)
+{
+    uint32 limit;
+    if (!ExtractOptUInt32(&args, limit, 10))
+        return false;
+
+    // sort order: handler time (default), received or sent bytes
+    uint64 OpcodeCounters::* field = &OpcodeCounters::handlerTime;
+    if (char* sortStr = ExtractLiteralArg(&args))
+    {
+        if (strncmp(sortStr, "time", strlen(sortStr)) == 0)
+            field = &OpcodeCounters::handlerTime;
+        else if (strncmp(sortStr, "in", strlen(sortStr)) == 0)
+            field = &OpcodeCounters::bytesIn;
+        else if (strncmp(sortStr, "out", strlen(sortStr)) == 0)
+            field = &OpcodeCounters::bytesOut;
+        else
+            return false;
+    }
+
+    std::vector<OpcodeCounters> totals;
+    sOpcodeStats.GetTotals(totals);
+
+    std::vector<uint16> opcodes;
+    for (uint32 i = 0; i < totals.size(); ++i)
+        if (totals[i].*field)
+            opcodes.push_back(uint16(i));
+
+    std::sort(opcodes.begin(), opcodes.end(), [&totals, field](uint16 a, uint16 b) { return totals[a].*field > totals[b].*field; });
+
+    for (uint32 i = 0; i < opcodes.size() && i < limit; ++i)
+    {
+        OpcodeCounters const& counters = totals[opcodes[i]];
+        PSendSysMessage("%s: received " UI64FMTD " (" UI64FMTD " KB), sent " UI64FMTD " (" UI64FMTD " KB)", LookupOpcodeName(opcodes[i]),
+                        counters.received, counters.bytesIn / 1024, counters.sent, counters.bytesOut / 1024);
+
+        if (!counters.handled)
+            continue;
+
+        std::ostringstream histogram;
+        for (uint32 j = 0; j < OPCODE_TIME_BUCKETS; ++j)
+        {
+            if (j)
+                histogram << " ";
+            if (j < OPCODE_TIME_BUCKETS - 1)
+                histogram << "<" << OPCODE_TIME_BUCKET_LIMITS[j] << "us:" << counters.histogram[j];
+            else
+                histogram << ">=" << OPCODE_TIME_BUCKET_LIMITS[j - 1] << "us:" << counters.histogram[j];
+        }
+
+        PSendSysMessage("  handled " UI64FMTD ", total %u ms, avg " UI64FMTD " us, max %u us, %s", counters.handled,
+                        uint32(counters.handlerTime / 1000), counters.handlerTime / counters.handled, counters.maxHandlerTime, histogram.str().c_str());
+    }
+
+    return true;
+}
+
+bool ChatHandler::HandleServerCompressionCommand(char* /*args*/)
+{
+    UpdateCompressionStats stats;
+    UpdateData::GetCompressionStats(stats);
+
+    PSendSysMessage("update packets compressed: " UI64FMTD " (" UI64FMTD " at Z_BEST_SPEED), level %u, %s",
+                    stats.packets, stats.fastPackets, sWorld.getConfig(CONFIG_UINT32_COMPRESSION), stats.isBusy ? "busy, compressing fast" : "not busy");
+    PSendSysMessage("bytes: " UI64FMTD " KB before, " UI64FMTD " KB after, ratio %.2f",
+                    stats.bytesIn / 1024, stats.bytesOut / 1024, stats.bytesOut ? double(stats.bytesIn) / stats.bytesOut : 0.0);
+    PSendSysMessage("compression time: " UI64FMTD " ms total, %u us in the last world tick, %u us max per tick",
+                    stats.time / 1000, stats.lastTickTime, stats.maxTickTime);
+
+    return true;
+}
+
+void ChatHandler::ShowDatabaseAsyncStats(char const* name, Database& db)
+{
+    std::vector<SqlDelayThreadStats> stats;
+    db.GetAsyncStats(stats);
+
+    PSendSysMessage("%s database: %u async connections", name, uint32(stats.size()));
+    for (uint32 i = 0; i < stats.size(); ++i)
+    {
+        SqlDelayThreadStats const& s = stats[i];
+        PSendSysMessage("  #%u: queued %u, executed " UI64FMTD ", latency last %u ms, avg %u ms, max %u ms",
+                        i, s.queueSize, s.executed, s.lastLatency, s.avgLatency, s.maxLatency);
+    }
+}
+
+bool ChatHandler::HandleServerDbStatsCommand(char* /*args*/)
+{
+    ShowDatabaseAsyncStats("World", WorldDatabase);
+    ShowDatabaseAsyncStats("Character", CharacterDatabase);
+    ShowDatabaseAsyncStats("Login", LoginDatabase);
+    return true;
+}
+
 bool ChatHandler::HandleInstanceSaveDataCommand(char* /*args*/)
 {
     Player* pl = m_session->GetPlayer();
@@ -0,0 +1,206 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "LineOfSightCache.h"
+#include "World.h"
+#include "Timer.h"
+
+#include <G3D/AABox.h>
+
+#include <cmath>
+
+/// End points are rounded to this many yards
+static const float LOS_CACHE_QUANTUM = 0.5f;
+/// No more lines are stored while the cache holds this many
+static const uint32 LOS_CACHE_MAX_ENTRIES = 16384;
+/// Size of the cells results are kept in, longer lines are not cached
+static const float LOS_CACHE_CELL_SIZE = 64.0f;
+
+size_t LineOfSightCache::KeyHash::operator()(Key const& key) const
+{
+    size_t hash = key.phasemask;
+    int32 const coords[] = { key.x1, key.y1, key.z1, key.x2, key.y2, key.z2 };
+    for (uint32 i = 0; i < 6; ++i)
+        hash = hash * 31 + uint32(coords[i]);
+
+    return hash;
+}
+
+LineOfSightCache::LineOfSightCache() : m_size(0), m_expireTimer(0)
+{
+}
+
+LineOfSightCache::Key LineOfSightCache::MakeKey(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask)
+{
+    Key key;
+    key.x1 = int32(std::floor(x1 / LOS_CACHE_QUANTUM));
+    key.y1 = int32(std::floor(y1 / LOS_CACHE_QUANTUM));
+    key.z1 = int32(std::floor(z1 / LOS_CACHE_QUANTUM));
+    key.x2 = int32(std::floor(x2 / LOS_CACHE_QUANTUM));
+    key.y2 = int32(std::floor(y2 / LOS_CACHE_QUANTUM));
+    key.z2 = int32(std::floor(z2 / LOS_CACHE_QUANTUM));
+    key.phasemask = phasemask;
+    return key;
+}
+
+int32 LineOfSightCache::GetCellCoord(float coord)
+{
+    return int32(std::floor(coord / LOS_CACHE_CELL_SIZE));
+}
+
+bool LineOfSightCache::Find(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask, bool& result)
+{
+    uint32 cacheTime = sWorld.getConfig(CONFIG_UINT32_VMAP_LOS_CACHE_TIME);
+    if (!cacheTime)
+        return false;
+
+    CellMap::const_iterator cell = m_cells.find(MakeCellId(GetCellCoord(x1), GetCellCoord(y1)));
+    if (cell == m_cells.end())
+    {
+        ++m_stats.misses;
+        return false;
+    }
+
+    EntryMap::const_iterator itr = cell->second.find(MakeKey(x1, y1, z1, x2, y2, z2, phasemask));
+    if (itr == cell->second.end() || WorldTimer::getMSTimeDiff(itr->second.storeTime, WorldTimer::getMSTime()) >= cacheTime)
+    {
+        ++m_stats.misses;
+        return false;
+    }
+
+    ++m_stats.hits;
+    result = itr->second.result;
+    return true;
+}
+
+void LineOfSightCache::Store(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask, bool result)
+{
+    if (!sWorld.getConfig(CONFIG_UINT32_VMAP_LOS_CACHE_TIME))
+        return;
+
+    // Invalidate() searches the cells within this distance of a model only
+    if (std::fabs(x2 - x1) > LOS_CACHE_CELL_SIZE || std::fabs(y2 - y1) > LOS_CACHE_CELL_SIZE)
+        return;
+
+    Key key = MakeKey(x1, y1, z1, x2, y2, z2, phasemask);
+    EntryMap& entries = m_cells[MakeCellId(GetCellCoord(x1), GetCellCoord(y1))];
+    EntryMap::iterator itr = entries.find(key);
+    if (itr == entries.end())
+    {
+        if (m_size >= LOS_CACHE_MAX_ENTRIES)
+            return;
+
+        itr = entries.insert(EntryMap::value_type(key, Entry())).first;
+        ++m_size;
+    }
+
+    itr->second.storeTime = WorldTimer::getMSTime();
+    itr->second.result = result;
+}
+
+void LineOfSightCache::Invalidate(G3D::AABox const& bounds)
+{
+    if (!m_size)
+        return;
+
+    G3D::Vector3 const& lo = bounds.low();
+    G3D::Vector3 const& hi = bounds.high();
+
+    // lines passing the bounds start at most LOS_CACHE_CELL_SIZE away from them
+    int32 cellXMin = GetCellCoord(lo.x - LOS_CACHE_CELL_SIZE);
+    int32 cellXMax = GetCellCoord(hi.x + LOS_CACHE_CELL_SIZE);
+    int32 cellYMin = GetCellCoord(lo.y - LOS_CACHE_CELL_SIZE);
+    int32 cellYMax = GetCellCoord(hi.y + LOS_CACHE_CELL_SIZE);
+
+    for (int32 cellX = cellXMin; cellX <= cellXMax; ++cellX)
+    {
+        for (int32 cellY = cellYMin; cellY <= cellYMax; ++cellY)
+        {
+            CellMap::iterator cell = m_cells.find(MakeCellId(cellX, cellY));
+            if (cell == m_cells.end())
+                continue;
+
+            EntryMap& entries = cell->second;
+            for (EntryMap::iterator itr = entries.begin(); itr != entries.end();)
+            {
+                Key const& key = itr->first;
+
+                // box of the line, the cells of the end points included
+                bool touches = std::min(key.x1, key.x2) * LOS_CACHE_QUANTUM <= hi.x && (std::max(key.x1, key.x2) + 1) * LOS_CACHE_QUANTUM >= lo.x &&
+                               std::min(key.y1, key.y2) * LOS_CACHE_QUANTUM <= hi.y && (std::max(key.y1, key.y2) + 1) * LOS_CACHE_QUANTUM >= lo.y &&
+                               std::min(key.z1, key.z2) * LOS_CACHE_QUANTUM <= hi.z && (std::max(key.z1, key.z2) + 1) * LOS_CACHE_QUANTUM >= lo.z;
+
+                if (touches)
+                {
+                    entries.erase(itr++);
+                    --m_size;
+                    ++m_stats.invalidated;
+                }
+                else
+                    ++itr;
+            }
+
+            if (entries.empty())
+                m_cells.erase(cell);
+        }
+    }
+}
+
+void LineOfSightCache::Update(uint32 diff)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_statsLock);
+        m_publishedStats = m_stats;
+        m_publishedStats.entries = m_size;
+    }
+
+    uint32 cacheTime = sWorld.getConfig(CONFIG_UINT32_VMAP_LOS_CACHE_TIME);
+
+    m_expireTimer += diff;
+    if (m_expireTimer < cacheTime)
+        return;
+
+    m_expireTimer = 0;
+
+    uint32 now = WorldTimer::getMSTime();
+    for (CellMap::iterator cell = m_cells.begin(); cell != m_cells.end();)
+    {
+        EntryMap& entries = cell->second;
+        for (EntryMap::iterator itr = entries.begin(); itr != entries.end();)
+        {
+            if (WorldTimer::getMSTimeDiff(itr->second.storeTime, now) >= cacheTime)
+            {
+                entries.erase(itr++);
+                --m_size;
+            }
+            else
+                ++itr;
+        }
+
+        if (entries.empty())
+            m_cells.erase(cell++);
+        else
+            ++cell;
+    }
+}
+
+LineOfSightCacheStats LineOfSightCache::GetStats() const
+{
+    std::lock_guard<std::mutex> guard(m_statsLock);
+    return m_publishedStats;
+}
@@ -0,0 +1,125 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_LINEOFSIGHTCACHE_H
+#define MANGOS_LINEOFSIGHTCACHE_H
+
+#include "Common.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace G3D
+{
+    class AABox;
+}
+
+/// Counters since the map was created
+struct LineOfSightCacheStats
+{
+    LineOfSightCacheStats() : hits(0), misses(0), invalidated(0), entries(0) {}
+
+    void Add(LineOfSightCacheStats const& other)
+    {
+        hits += other.hits;
+        misses += other.misses;
+        invalidated += other.invalidated;
+        entries += other.entries;
+    }
+
+    uint32 GetHitPercent() const
+    {
+        uint64 lookups = hits + misses;
+        return lookups ? uint32(hits * 100 / lookups) : 0;
+    }
+
+    uint64 hits;                                            // results taken from the cache
+    uint64 misses;                                          // lines traced because no result was cached
+    uint64 invalidated;                                     // results dropped because a game object model on the line changed
+    uint32 entries;                                         // results cached now
+};
+
+/**
+ * Line of sight results of one map, kept for a short time (vmap.LOSCacheTime).
+ *
+ * The end points are rounded to LOS_CACHE_QUANTUM, so units standing still or moving only a bit
+ * reuse the lines traced before. When a game object model (doors, destructible buildings) is
+ * added, removed or changes its collision, the results of lines passing its bounds are dropped.
+ * Results are kept per cell of the first end point, so only the cells near the model are searched.
+ * Used by the map thread only, except GetStats().
+ */
+class LineOfSightCache
+{
+    public:
+        LineOfSightCache();
+
+        /// Sets result and returns true when the line was traced within the cache time
+        bool Find(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask, bool& result);
+        void Store(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask, bool result);
+
+        /// Drops the results of lines passing the bounds
+        void Invalidate(G3D::AABox const& bounds);
+
+        /// Drops expired results and publishes the counters for GetStats()
+        void Update(uint32 diff);
+
+        /// Counters as of the last Update(), safe to call from other threads
+        LineOfSightCacheStats GetStats() const;
+
+    private:
+        struct Key
+        {
+            int32 x1, y1, z1;
+            int32 x2, y2, z2;
+            uint32 phasemask;
+
+            bool operator==(Key const& other) const
+            {
+                return x1 == other.x1 && y1 == other.y1 && z1 == other.z1 &&
+                       x2 == other.x2 && y2 == other.y2 && z2 == other.z2 && phasemask == other.phasemask;
+            }
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(Key const& key) const;
+        };
+
+        struct Entry
+        {
+            uint32 storeTime;
+            bool result;
+        };
+
+        typedef std::unordered_map<Key, Entry, KeyHash> EntryMap;
+        typedef std::unordered_map<uint32, EntryMap> CellMap;
+
+        static Key MakeKey(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask);
+        static uint32 MakeCellId(int32 cellX, int32 cellY) { return (uint32(cellX & 0xFFFF) << 16) | uint32(cellY & 0xFFFF); }
+        static int32 GetCellCoord(float coord);
+
+        CellMap m_cells;                                    // results by cell of the first end point
+        uint32 m_size;
+        uint32 m_expireTimer;
+        LineOfSightCacheStats m_stats;
+
+        mutable std::mutex m_statsLock;
+        LineOfSightCacheStats m_publishedStats;
+};
+
+#endif
@@ -26,6 +26,7 @@
 #include "SpellMgr.h"
 #include "DBCStores.h"
 #include "SQLStorages.h"
+#include "MapManager.h"
 #include "BattleGround/BattleGroundAV.h"
 
 INSTANTIATE_SINGLETON_1(LootMgr);
@@ -41,6 +42,36 @@ static eConfigFloatValues const qualityToRate[MAX_ITEM_QUALITY] =
     CONFIG_FLOAT_RATE_DROP_ITEM_ARTIFACT,                   // ITEM_QUALITY_ARTIFACT
 };
 
+// skills needed to use weapon and armor subclasses, 0 if none can use them
+static uint32 const itemWeaponSkills[MAX_ITEM_SUBCLASS_WEAPON] =
+{
+    SKILL_AXES,     SKILL_2H_AXES,  SKILL_BOWS,          SKILL_GUNS,      SKILL_MACES,
+    SKILL_2H_MACES, SKILL_POLEARMS, SKILL_SWORDS,        SKILL_2H_SWORDS, 0,
+    SKILL_STAVES,   0,              0,                   SKILL_UNARMED,   0,
+    SKILL_DAGGERS,  SKILL_THROWN,   SKILL_ASSASSINATION, SKILL_CROSSBOWS, SKILL_WANDS,
+    SKILL_FISHING
+};
+
+static uint32 const itemArmorSkills[MAX_ITEM_SUBCLASS_ARMOR] =
+{
+    0, SKILL_CLOTH, SKILL_LEATHER, SKILL_MAIL, SKILL_PLATE_MAIL, 0, SKILL_SHIELD, 0, 0, 0, 0
+};
+
+// Based on Borderlands loot chance table
+static float const randomLootChanceQuality[MAX_ITEM_QUALITY] =
+{
+    0.0f,        // ITEM_QUALITY_POOR           0
+    89.92f,      // ITEM_QUALITY_NORMAL         9/10
+    8.99f,       // ITEM_QUALITY_UNCOMMON       1/10
+    0.89f,       // ITEM_QUALITY_RARE           1/100
+    0.09f,       // ITEM_QUALITY_EPIC           1/1000
+    0.09f,       // ITEM_QUALITY_LEGENDARY      1/1000
+    0.009f,      // ITEM_QUALITY_ARTIFACT       1/10000
+};
+
+/// Picks of Loot::BuildNewLootTable per item to add, a pick fails when nobody in the group can use the item
+static uint32 const RANDOM_LOOT_PICKS_PER_ITEM = 8;
+
 LootStore LootTemplates_Creature("creature_loot_template",     "creature entry",                 true);
 LootStore LootTemplates_Disenchant("disenchant_loot_template",   "item disenchant id",             true);
 LootStore LootTemplates_Fishing("fishing_loot_template",      "area id",                        true);
@@ -101,8 +132,11 @@ void LootStore::LoadLootTable()
     // Clearing store (for reloading case)
     Clear();
 
-    //                                                 0      1     2                    3        4              5         6
-    QueryResult* result = WorldDatabase.PQuery("SELECT entry, item, ChanceOrQuestChance, groupid, mincountOrRef, maxcount, condition_id FROM %s", GetName());
+    // prepared statement: numeric columns are read without text conversion
+    //                                     0      1     2                    3        4              5         6
+    std::string selectSql = std::string("SELECT entry, item, ChanceOrQuestChance, groupid, mincountOrRef, maxcount, condition_id FROM ") + GetName();
+    SqlStatementID selectStmt;
+    QueryResult* result = WorldDatabase.CreateStatement(selectStmt, selectSql.c_str()).Query();
 
     if (result)
     {
@@ -903,8 +937,6 @@ bool Loot::FillLoot(uint32 loot_id, LootStore const& store, Player* lootOwner, b
     return true;
 }
 
-typedef std::vector<const ItemPrototype*> ItemPrototypeList;
-
 void Loot::SanitizeLootRemovePoorAndWeaponOrArmorItems()
 {
     LootItemList m_newLootItems;
@@ -962,77 +994,94 @@ bool Loot::CanItemBeUsedByLootOwnerOrGroupMember(ItemPrototype const* pProto, Pl
 
 void Loot::BuildNewLootTable(Player* lootOwner)
 {
+    uint32 maxItemToAdd = urand(0, 4);
+    if (!maxItemToAdd)
+        return;
+
     uint32 currentMaxLevel = sMapMgr.GetMaxPlayerLevel();
     uint32 currentMinLevel = this->GetCurrentMinLevel(currentMaxLevel);
 
-    ItemPrototypeList m_items;
-
-    for (uint32 id = 0; id < sItemStorage.GetMaxEntry(); ++id)
+    // classes and skills of the owner and group members, buckets nobody can use are skipped
+    std::vector<uint32> const& skills = sLootMgr.GetRandomLootSkills();
+    uint32 classMask = 0;
+    uint32 skillMask = 0;
+    auto addUser = [&](Player const* plr)
     {
-        ItemPrototype const* pProto = sItemStorage.LookupEntry<ItemPrototype>(id);
-        if (!pProto)
-        {
-            continue;
-        }
+        classMask |= plr->getClassMask();
+        for (uint32 i = 0; i < skills.size(); ++i)
+            if (plr->HasSkill(skills[i]))
+                skillMask |= uint32(1) << i;
+    };
 
-        if (pProto->Quality == ITEM_QUALITY_POOR)
+    addUser(lootOwner);
+    if (Group* grp = lootOwner->GetGroup())
+    {
+        for (GroupReference* itr = grp->GetFirstMember(); itr != nullptr; itr = itr->next())
         {
-            continue;
+            Player* plr = itr->getSource();
+            if (plr && plr != lootOwner && plr->GetSession())
+                addUser(plr);
         }
+    }
 
-        if (!pProto->IsWeaponOrArmor())
-        {
-            continue;
-        }
+    struct Candidates
+    {
+        std::vector<ItemPrototype const*>::const_iterator begin;
+        uint32 count;
+        float weight;
+    };
 
-        if (pProto->RequiredLevel == 0 && pProto->Quality != ITEM_QUALITY_NORMAL)
-        {
+    // Going through all candidates in random order and keeping each with the chance of its quality
+    // until enough are kept picks an item of quality q with a probability proportional to
+    // count(q) * chance(q). So a bucket is picked with the weight count * chance, then an item of it
+    // with equal chance, and items nobody can use are picked again.
+    std::vector<Candidates> candidates;
+    float totalWeight = 0.0f;
+    RandomLootBucketList const& buckets = sLootMgr.GetRandomLootBuckets();
+    for (RandomLootBucketList::const_iterator itr = buckets.begin(); itr != buckets.end(); ++itr)
+    {
+        if (!(itr->allowableClass & classMask) || !(skillMask & (uint32(1) << itr->skillIndex)))
             continue;
-        }
 
-        if (pProto->RequiredLevel < currentMinLevel || pProto->RequiredLevel > currentMaxLevel)
-        {
+        std::vector<ItemPrototype const*>::const_iterator begin = std::lower_bound(itr->items.begin(), itr->items.end(), currentMinLevel,
+                [](ItemPrototype const* proto, uint32 level) { return proto->RequiredLevel < level; });
+        std::vector<ItemPrototype const*>::const_iterator end = std::upper_bound(begin, itr->items.end(), currentMaxLevel,
+                [](uint32 level, ItemPrototype const* proto) { return level < proto->RequiredLevel; });
+        if (begin == end)
             continue;
-        }
 
-        if (!CanItemBeUsedByLootOwnerOrGroupMember(pProto, lootOwner))
-        {
+        Candidates bucket;
+        bucket.begin = begin;
+        bucket.count = uint32(end - begin);
+        bucket.weight = bucket.count * std::min(100.0f, randomLootChanceQuality[itr->quality] * sWorld.getConfig(qualityToRate[itr->quality]));
+        if (bucket.weight <= 0.0f)
             continue;
-        }
 
-        m_items.push_back(pProto);
+        candidates.push_back(bucket);
+        totalWeight += bucket.weight;
     }
 
-    // Based on Borderlands loot chance table
-    static float const chanceQuality[MAX_ITEM_QUALITY] =
-    {
-        0.0f,        // ITEM_QUALITY_POOR           0
-        89.92f,      // ITEM_QUALITY_NORMAL         9/10
-        8.99f,       // ITEM_QUALITY_UNCOMMON       1/10
-        0.89f,       // ITEM_QUALITY_RARE           1/100
-        0.09f,       // ITEM_QUALITY_EPIC           1/1000
-        0.09f,       // ITEM_QUALITY_LEGENDARY      1/1000
-        0.009f,      // ITEM_QUALITY_ARTIFACT       1/10000
-    };
+    if (candidates.empty())
+        return;
 
-    std::random_shuffle(m_items.begin(), m_items.end());
-    uint32 maxItemToAdd = urand(0, 4);
-    uint32 iterationCount = 0;
-    for (ItemPrototypeList::const_iterator i = m_items.begin(); i != m_items.end() && iterationCount < maxItemToAdd; ++i)
+    std::vector<ItemPrototype const*> added;
+    for (uint32 pick = 0; pick < maxItemToAdd * RANDOM_LOOT_PICKS_PER_ITEM && added.size() < maxItemToAdd; ++pick)
     {
-        ItemPrototype const* pProto = (*i);
+        float roll = frand(0.0f, totalWeight);
+        std::vector<Candidates>::const_iterator bucket = candidates.begin();
+        for (; bucket + 1 != candidates.end() && roll >= bucket->weight; ++bucket)
+            roll -= bucket->weight;
 
-        float qualityModifier = sWorld.getConfig(qualityToRate[pProto->Quality]);
-        float chance = chanceQuality[pProto->Quality];
+        ItemPrototype const* pProto = *(bucket->begin + urand(0, bucket->count - 1));
+        if (std::find(added.begin(), added.end(), pProto) != added.end())
+            continue;
 
-        if (roll_chance_f(chance * qualityModifier))
-        {
-            this->AddItem((*i)->ItemId, 1, (*i)->RandomSuffix, (*i)->RandomProperty);
-            iterationCount++;
-        }
-    }
+        if (!CanItemBeUsedByLootOwnerOrGroupMember(pProto, lootOwner))
+            continue;
 
-    m_items.clear();
+        this->AddItem(pProto->ItemId, 1, pProto->RandomSuffix, pProto->RandomProperty);
+        added.push_back(pProto);
+    }
 }
 
 uint32 Loot::GetCurrentMinLevel(uint32 currentMaxLevel)
@@ -1048,30 +1097,16 @@ uint32 Loot::GetCurrentMinLevel(uint32 currentMaxLevel)
 
 bool Loot::CanItemBeUsedByPlayer(ItemPrototype const* pProto, Player* player)
 {
-    const static uint32 item_weapon_skills[MAX_ITEM_SUBCLASS_WEAPON] =
-    {
-        SKILL_AXES,     SKILL_2H_AXES,  SKILL_BOWS,          SKILL_GUNS,      SKILL_MACES,
-        SKILL_2H_MACES, SKILL_POLEARMS, SKILL_SWORDS,        SKILL_2H_SWORDS, 0,
-        SKILL_STAVES,   0,              0,                   SKILL_UNARMED,   0,
-        SKILL_DAGGERS,  SKILL_THROWN,   SKILL_ASSASSINATION, SKILL_CROSSBOWS, SKILL_WANDS,
-        SKILL_FISHING
-    };
-
-    const static uint32 item_armor_skills[MAX_ITEM_SUBCLASS_ARMOR] =
-    {
-        0, SKILL_CLOTH, SKILL_LEATHER, SKILL_MAIL, SKILL_PLATE_MAIL, 0, SKILL_SHIELD, 0, 0, 0, 0
-    };
-
     bool canUseItem = player->CanUseItem(pProto) == EQUIP_ERR_OK;
     if (canUseItem)
     {
         switch (pProto->Class)
         {
             case ITEM_CLASS_WEAPON:
-                canUseItem = player->HasSkill(item_weapon_skills[pProto->SubClass]) && player->IsBestWeaponSkill(item_weapon_skills[pProto->SubClass]);
+                canUseItem = player->HasSkill(itemWeaponSkills[pProto->SubClass]) && player->IsBestWeaponSkill(itemWeaponSkills[pProto->SubClass]);
                 break;
             case ITEM_CLASS_ARMOR:
-                canUseItem = player->HasSkill(item_armor_skills[pProto->SubClass]) && player->IsBestArmorSkill(item_armor_skills[pProto->SubClass]);
+                canUseItem = player->HasSkill(itemArmorSkills[pProto->SubClass]) && player->IsBestArmorSkill(itemArmorSkills[pProto->SubClass]);
                 break;
             default:
                 canUseItem = false;
@@ -3006,3 +3041,67 @@ bool LootMgr::IsAllowedToLoot(Player* player, Creature* creature)
 
     return canLoot;
 }
+
+void LootMgr::LoadRandomLootItems()
+{
+    m_randomLootBuckets.clear();
+    m_randomLootSkills.clear();
+
+    typedef std::map<std::pair<uint32, uint32>, uint32> BucketIndexMap;
+    BucketIndexMap bucketIndex;                             // (quality << 16 | class << 8 | subclass, allowable classes) -> bucket
+    uint32 count = 0;
+
+    for (uint32 id = 0; id < sItemStorage.GetMaxEntry(); ++id)
+    {
+        ItemPrototype const* pProto = sItemStorage.LookupEntry<ItemPrototype>(id);
+        if (!pProto)
+            continue;
+
+        if (pProto->Quality == ITEM_QUALITY_POOR || pProto->Quality >= MAX_ITEM_QUALITY)
+            continue;
+
+        if (!pProto->IsWeaponOrArmor())
+            continue;
+
+        if (pProto->RequiredLevel == 0 && pProto->Quality != ITEM_QUALITY_NORMAL)
+            continue;
+
+        // items no player can use never pass Loot::CanItemBeUsedByPlayer
+        uint32 skill = 0;
+        if (pProto->Class == ITEM_CLASS_WEAPON && pProto->SubClass < MAX_ITEM_SUBCLASS_WEAPON)
+            skill = itemWeaponSkills[pProto->SubClass];
+        else if (pProto->Class == ITEM_CLASS_ARMOR && pProto->SubClass < MAX_ITEM_SUBCLASS_ARMOR)
+            skill = itemArmorSkills[pProto->SubClass];
+
+        uint32 allowableClass = pProto->AllowableClass & CLASSMASK_ALL_PLAYABLE;
+        if (!skill || !allowableClass)
+            continue;
+
+        std::pair<uint32, uint32> key((pProto->Quality << 16) | (pProto->Class << 8) | pProto->SubClass, allowableClass);
+        BucketIndexMap::const_iterator itr = bucketIndex.find(key);
+        if (itr == bucketIndex.end())
+        {
+            itr = bucketIndex.insert(BucketIndexMap::value_type(key, uint32(m_randomLootBuckets.size()))).first;
+            m_randomLootBuckets.push_back(RandomLootBucket(pProto->Quality, pProto->Class, pProto->SubClass, skill, allowableClass));
+        }
+
+        m_randomLootBuckets[itr->second].items.push_back(pProto);
+        ++count;
+    }
+
+    for (RandomLootBucketList::iterator itr = m_randomLootBuckets.begin(); itr != m_randomLootBuckets.end(); ++itr)
+    {
+        std::vector<uint32>::const_iterator skillItr = std::find(m_randomLootSkills.begin(), m_randomLootSkills.end(), itr->skill);
+        if (skillItr == m_randomLootSkills.end())
+            skillItr = m_randomLootSkills.insert(m_randomLootSkills.end(), itr->skill);
+
+        itr->skillIndex = uint32(skillItr - m_randomLootSkills.begin());
+        MANGOS_ASSERT(itr->skillIndex < 32);
+
+        std::stable_sort(itr->items.begin(), itr->items.end(),
+                         [](ItemPrototype const* a, ItemPrototype const* b) { return a->RequiredLevel < b->RequiredLevel; });
+    }
+
+    sLog.outString(">> Loaded %u weapon and armor items in " SIZEFMTD " buckets for random loot", count, m_randomLootBuckets.size());
+    sLog.outString();
+}
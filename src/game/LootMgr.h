@@ -388,6 +388,24 @@ inline void LoadLootTables()
     LoadLootTemplates_Reference();
 }
 
+// weapon or armor prototypes of one quality, item class/subclass and AllowableClass mask,
+// candidates of Loot::BuildNewLootTable
+struct RandomLootBucket
+{
+    RandomLootBucket(uint32 _quality, uint32 _itemClass, uint32 _subClass, uint32 _skill, uint32 _allowableClass)
+        : quality(_quality), itemClass(_itemClass), subClass(_subClass), skill(_skill), allowableClass(_allowableClass), skillIndex(0) {}
+
+    uint32 quality;
+    uint32 itemClass;
+    uint32 subClass;
+    uint32 skill;                                           // needed to use the items
+    uint32 allowableClass;                                  // playable classes only
+    uint32 skillIndex;                                      // of skill in LootMgr::GetRandomLootSkills()
+    std::vector<ItemPrototype const*> items;                // sorted by RequiredLevel
+};
+
+typedef std::vector<RandomLootBucket> RandomLootBucketList;
+
 class LootMgr
 {
 public:
@@ -396,6 +414,16 @@ public:
     Loot* GetLoot(Player* player, ObjectGuid const& targetGuid = ObjectGuid());
 
     void update(uint32 diff);
+
+    // build the buckets of random loot candidates, must be called after item prototypes loading
+    void LoadRandomLootItems();
+    RandomLootBucketList const& GetRandomLootBuckets() const { return m_randomLootBuckets; }
+    // skills needed by the buckets, at most 32
+    std::vector<uint32> const& GetRandomLootSkills() const { return m_randomLootSkills; }
+
+private:
+    RandomLootBucketList m_randomLootBuckets;
+    std::vector<uint32> m_randomLootSkills;
 };
 
 #define sLootMgr MaNGOS::Singleton<LootMgr>::Instance()
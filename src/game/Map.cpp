@@ -36,6 +36,9 @@
 #include "MapPersistentStateMgr.h"
 #include "VMapFactory.h"
 #include "MoveMap.h"
+#include "vmap/GameObjectModel.h"
+#include "GridPreloader.h"
+#include "WaypointMovementGenerator.h"
 #include "BattleGround/BattleGroundMgr.h"
 #include "Calendar.h"
 #include "Chat.h"
@@ -78,6 +81,7 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
     : i_mapEntry(sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode),
       i_id(id), i_InstanceId(InstanceId), m_unloadTimer(0),
       m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE), m_persistentState(nullptr),
+      m_lastUpdateTime(0), m_maxUpdateTime(0), m_preloadTimer(0),
       m_activeNonPlayersIter(m_activeNonPlayers.end()),
       i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
       i_data(nullptr), i_script_id(0)
@@ -446,6 +450,7 @@ bool Map::loaded(const GridPair& p) const
 void Map::Update(const uint32& t_diff)
 {
     m_dyn_tree.update(t_diff);
+    m_losCache.Update(t_diff);
 
     /// update worldsessions for existing players
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
@@ -471,6 +476,14 @@ void Map::Update(const uint32& t_diff)
         }
     }
 
+    /// queue grids players will reach soon for loading in the background
+    m_preloadTimer += t_diff;
+    if (m_preloadTimer >= GRID_PRELOAD_INTERVAL)
+    {
+        m_preloadTimer = 0;
+        PreloadGridsAhead();
+    }
+
     /// update active cells around players and active objects
     resetMarkedCells();
 
@@ -578,6 +591,101 @@ void Map::Update(const uint32& t_diff)
     m_weatherSystem->UpdateWeathers(t_diff);
 }
 
+void Map::PreloadGridsAhead()
+{
+    float lookAhead = float(sWorld.getConfig(CONFIG_UINT32_MAPUPDATE_PRELOAD_LOOKAHEAD));
+    if (!lookAhead)
+        return;
+
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    {
+        Player* plr = itr->getSource();
+        if (!plr->IsInWorld() || !plr->IsPositionValid())
+            continue;
+
+        float x = plr->GetPositionX();
+        float y = plr->GetPositionY();
+
+        if (plr->IsTaxiFlying())
+        {
+            if (plr->GetMotionMaster()->GetCurrentMovementGeneratorType() != FLIGHT_MOTION_TYPE)
+                continue;
+
+            // follow the flight path nodes for the distance flown within the look ahead time
+            FlightPathMovementGenerator* flight = (FlightPathMovementGenerator*)plr->GetMotionMaster()->top();
+            TaxiPathNodeList const& path = flight->GetPath();
+
+            float distance = lookAhead * PLAYER_FLIGHT_SPEED;
+            for (uint32 i = flight->GetCurrentNode(); i < path.size() && distance > 0.0f; ++i)
+            {
+                TaxiPathNodeEntry const& node = path[i];
+                if (node.mapid != GetId())
+                    break;
+
+                PreloadGridsOnLine(x, y, node.x, node.y);
+
+                distance -= sqrt((node.x - x) * (node.x - x) + (node.y - y) * (node.y - y));
+                x = node.x;
+                y = node.y;
+            }
+        }
+        else
+        {
+            uint32 moveFlags = plr->m_movementInfo.GetMovementFlags();
+
+            float dx = 0.0f, dy = 0.0f;
+            if (moveFlags & MOVEFLAG_FORWARD)
+                dx += 1.0f;
+            if (moveFlags & MOVEFLAG_BACKWARD)
+                dx -= 1.0f;
+            if (moveFlags & MOVEFLAG_STRAFE_LEFT)
+                dy += 1.0f;
+            if (moveFlags & MOVEFLAG_STRAFE_RIGHT)
+                dy -= 1.0f;
+
+            if (!dx && !dy)
+                continue;
+
+            UnitMoveType moveType = MOVE_RUN;
+            if (moveFlags & MOVEFLAG_FLYING)
+                moveType = MOVE_FLIGHT;
+            else if (moveFlags & MOVEFLAG_SWIMMING)
+                moveType = MOVE_SWIM;
+            else if (moveFlags & MOVEFLAG_WALK_MODE)
+                moveType = MOVE_WALK;
+
+            float angle = plr->GetOrientation() + atan2(dy, dx);
+            float distance = lookAhead * plr->GetSpeed(moveType);
+
+            PreloadGridsOnLine(x, y, x + distance * cos(angle), y + distance * sin(angle));
+        }
+    }
+}
+
+void Map::PreloadGridsOnLine(float x1, float y1, float x2, float y2)
+{
+    float length = sqrt((x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1));
+
+    // a quarter grid step can't skip a grid the line crosses more than a corner of
+    uint32 steps = uint32(length / (SIZE_OF_GRIDS / 4)) + 1;
+    for (uint32 i = 1; i <= steps; ++i)
+    {
+        float x = x1 + (x2 - x1) * i / steps;
+        float y = y1 + (y2 - y1) * i / steps;
+        if (!MaNGOS::IsValidMapCoord(x, y))
+            return;
+
+        GridPair p = MaNGOS::ComputeGridPair(x, y);
+
+        // TerrainInfo coordinates, see EnsureGridCreated
+        uint32 gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+        uint32 gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+
+        if (!m_bLoadedGrids[gx][gy])
+            sGridPreloader.Request(GetId(), gx, gy);
+    }
+}
+
 void Map::Remove(Player* player, bool remove)
 {
     if (i_data)
@@ -1049,18 +1157,20 @@ uint32 Map::GetPlayersCountExceptGMs() const
 
 void Map::SendToPlayers(WorldPacket const* data) const
 {
+    SharedWorldPacket sharedData(*data);
     for (MapRefManager::const_iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
-        itr->getSource()->GetSession()->SendPacket(data);
+        itr->getSource()->GetSession()->SendPacket(sharedData);
 }
 
 bool Map::SendToPlayersInZone(WorldPacket const* data, uint32 zoneId) const
 {
+    SharedWorldPacket sharedData(*data);
     bool foundPlayer = false;
     for (MapRefManager::const_iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
     {
         if (itr->getSource()->GetZoneId() == zoneId)
         {
-            itr->getSource()->GetSession()->SendPacket(data);
+            itr->getSource()->GetSession()->SendPacket(sharedData);
             foundPlayer = true;
         }
     }
@@ -1992,8 +2102,46 @@ void Map::PlayDirectSoundToMap(uint32 soundId, uint32 zoneId /*=0*/) const
  */
 bool Map::IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, uint32 phasemask) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ)
-           && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, phasemask);
+    bool result;
+    if (m_losCache.Find(srcX, srcY, srcZ, destX, destY, destZ, phasemask, result))
+        return result;
+
+    result = VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ)
+             && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, phasemask);
+
+    m_losCache.Store(srcX, srcY, srcZ, destX, destY, destZ, phasemask, result);
+    return result;
+}
+
+void Map::IsInLineOfSight(VMAP::LineOfSightQuery* queries, uint32 count, uint32 phasemask) const
+{
+    // only the lines not in the cache are traced
+    std::vector<VMAP::LineOfSightQuery> traced;
+    std::vector<uint32> tracedIndex;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        VMAP::LineOfSightQuery& query = queries[i];
+        if (!m_losCache.Find(query.x1, query.y1, query.z1, query.x2, query.y2, query.z2, phasemask, query.result))
+        {
+            traced.push_back(query);
+            tracedIndex.push_back(i);
+        }
+    }
+
+    if (traced.empty())
+        return;
+
+    VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), &traced[0], traced.size());
+
+    for (size_t i = 0; i < traced.size(); ++i)
+    {
+        VMAP::LineOfSightQuery& query = traced[i];
+        if (query.result)
+            query.result = m_dyn_tree.isInLineOfSight(query.x1, query.y1, query.z1, query.x2, query.y2, query.z2, phasemask);
+
+        m_losCache.Store(query.x1, query.y1, query.z1, query.x2, query.y2, query.z2, phasemask, query.result);
+        queries[tracedIndex[i]].result = query.result;
+    }
 }
 
 /**
@@ -2091,11 +2239,18 @@ float Map::GetHeight(uint32 phasemask, float x, float y, float z) const
 void Map::InsertGameObjectModel(const GameObjectModel& mdl)
 {
     m_dyn_tree.insert(mdl);
+    m_losCache.Invalidate(mdl.getBounds());
 }
 
 void Map::RemoveGameObjectModel(const GameObjectModel& mdl)
 {
     m_dyn_tree.remove(mdl);
+    m_losCache.Invalidate(mdl.getBounds());
+}
+
+void Map::UpdateGameObjectModelCollision(const GameObjectModel& mdl)
+{
+    m_losCache.Invalidate(mdl.getBounds());
 }
 
 bool Map::ContainsGameObjectModel(const GameObjectModel& mdl) const
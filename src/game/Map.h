@@ -36,6 +36,8 @@
 #include "ScriptMgr.h"
 #include "CreatureLinkingMgr.h"
 #include "vmap/DynamicTree.h"
+#include "vmap/IVMapManager.h"
+#include "LineOfSightCache.h"
 
 #include <bitset>
 #include <list>
@@ -91,6 +93,7 @@ enum LevelRequirementVsMode
 #endif
 
 #define MIN_UNLOAD_DELAY      1                             // immediate unload
+#define GRID_PRELOAD_INTERVAL 1000                          // ms between predictions of the grids players will reach
 
 class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 {
@@ -122,6 +125,17 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 
         virtual void Update(const uint32&);
 
+        // duration of the last Update() call in ms and the worst one seen, see MapUpdater::UpdateMap
+        uint32 GetLastUpdateTime() const { return m_lastUpdateTime; }
+        uint32 GetMaxUpdateTime() const { return m_maxUpdateTime; }
+        LineOfSightCache const& GetLineOfSightCache() const { return m_losCache; }
+        void SetLastUpdateTime(uint32 t)
+        {
+            m_lastUpdateTime = t;
+            if (t > m_maxUpdateTime)
+                m_maxUpdateTime = t;
+        }
+
         void MessageBroadcast(Player const*, WorldPacket*, bool to_self);
         void MessageBroadcast(WorldObject const*, WorldPacket*);
         void MessageDistBroadcast(Player const*, WorldPacket*, float dist, bool to_self, bool own_team_only = false);
@@ -203,9 +217,19 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 
         void UpdateObjectVisibility(WorldObject* obj, Cell cell, CellPair cellpair);
 
-        void resetMarkedCells() { marked_cells.reset(); }
+        // only clear the bits set in last update, the bitset itself grows with MAX_NUMBER_OF_CELLS^2
+        void resetMarkedCells()
+        {
+            for (std::vector<uint32>::const_iterator itr = m_markedCellIds.begin(); itr != m_markedCellIds.end(); ++itr)
+                marked_cells.reset(*itr);
+            m_markedCellIds.clear();
+        }
         bool isCellMarked(uint32 pCellId) { return marked_cells.test(pCellId); }
-        void markCell(uint32 pCellId) { marked_cells.set(pCellId); }
+        void markCell(uint32 pCellId)
+        {
+            marked_cells.set(pCellId);
+            m_markedCellIds.push_back(pCellId);
+        }
 
         bool HavePlayers() const { return !m_mapRefManager.isEmpty(); }
         uint32 GetPlayersCountExceptGMs() const;
@@ -276,12 +300,16 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
         float GetHeight(uint32 phasemask, float x, float y, float z) const;
         bool GetHeightInRange(uint32 phasemask, float x, float y, float& z, float maxSearchDist = 4.0f) const;
         bool IsInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask) const;
+        /// IsInLineOfSight() for many position pairs at once, pairs with the same start or end should be next to each other
+        void IsInLineOfSight(VMAP::LineOfSightQuery* queries, uint32 count, uint32 phasemask) const;
         bool GetHitPosition(float srcX, float srcY, float srcZ, float& destX, float& destY, float& destZ, uint32 phasemask, float modifyDist) const;
 
         // Object Model insertion/remove/test for dynamic vmaps use
         void InsertGameObjectModel(const GameObjectModel& mdl);
         void RemoveGameObjectModel(const GameObjectModel& mdl);
         bool ContainsGameObjectModel(const GameObjectModel& mdl) const;
+        /// The collision of the model was enabled or disabled
+        void UpdateGameObjectModelCollision(const GameObjectModel& mdl);
 
         // Get Holder for Creature Linking
         CreatureLinkingHolder* GetCreatureLinkingHolder() { return &m_creatureLinkingHolder; }
@@ -322,6 +350,10 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
         bool EnsureGridLoaded(Cell const&);
         void EnsureGridLoadedAtEnter(Cell const&, Player* player = nullptr);
 
+        // queue terrain grids lying ahead of moving players for loading by GridPreloader
+        void PreloadGridsAhead();
+        void PreloadGridsOnLine(float x1, float y1, float x2, float y2);
+
         void buildNGridLinkage(NGridType* pNGridType) { pNGridType->link(this); }
 
         template<class T> void AddType(T* obj);
@@ -351,6 +383,9 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
         uint32 m_unloadTimer;
         float m_VisibleDistance;
         MapPersistentState* m_persistentState;
+        uint32 m_lastUpdateTime;
+        uint32 m_maxUpdateTime;
+        uint32 m_preloadTimer;
 
         MapRefManager m_mapRefManager;
         MapRefManager::iterator m_mapRefIter;
@@ -370,6 +405,7 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
         bool m_bLoadedGrids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
         std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP* TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
+        std::vector<uint32> m_markedCellIds;
 
         std::set<WorldObject*> i_objectsToRemove;
 
@@ -397,6 +433,8 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 
         // Dynamic Map tree object
         DynamicMapTree m_dyn_tree;
+        // recent IsInLineOfSight() results, dropped when models in m_dyn_tree change
+        mutable LineOfSightCache m_losCache;
 
         // WeatherSystem
         WeatherSystem* m_weatherSystem;
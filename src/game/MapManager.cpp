@@ -23,6 +23,8 @@
 #include "Log.h"
 #include "Transports.h"
 #include "GridDefines.h"
+#include "GridPreloader.h"
+#include "PathfindingService.h"
 #include "World.h"
 #include "CellImpl.h"
 #include "Corpse.h"
@@ -33,7 +35,8 @@ INSTANTIATE_SINGLETON_2(MapManager, CLASS_LOCK);
 INSTANTIATE_CLASS_MUTEX(MapManager, std::recursive_mutex);
 
 MapManager::MapManager()
-    : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN))
+    : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN)),
+      m_maxPlayerLevel(0), m_currentDifficulty(DIFFICULTY_NORMAL), m_scalingEpoch(1), m_maxPlayerLevelDirty(true)
 {
     i_timer.SetInterval(sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
 }
@@ -53,6 +56,21 @@ void
 MapManager::Initialize()
 {
     InitStateMachine();
+
+    if (uint32 numThreads = sWorld.getConfig(CONFIG_UINT32_MAPUPDATE_THREADS))
+    {
+        sLog.outString("Using %u threads for map updates", numThreads);
+        m_updater.Activate(numThreads);
+    }
+
+    if (sWorld.getConfig(CONFIG_UINT32_MAPUPDATE_PRELOAD_LOOKAHEAD))
+        sGridPreloader.Activate();
+
+    if (uint32 numThreads = sWorld.getConfig(CONFIG_UINT32_MMAP_PATHFINDING_THREADS))
+    {
+        sLog.outString("Using %u threads for pathfinding", numThreads);
+        sPathfindingService.Activate(numThreads);
+    }
 }
 
 void MapManager::InitStateMachine()
@@ -173,8 +191,29 @@ void MapManager::Update(uint32 diff)
     if (!i_timer.Passed())
         return;
 
-    for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
-        iter->second->Update((uint32)i_timer.GetCurrent());
+    {
+        // maps can be created from map threads (teleports), so don't iterate i_maps while updating
+        std::vector<Map*> maps;
+        {
+            Guard _guard(*this);
+            maps.reserve(i_maps.size());
+            for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+                maps.push_back(iter->second);
+        }
+
+        for (std::vector<Map*>::iterator iter = maps.begin(); iter != maps.end(); ++iter)
+            m_updater.ScheduleUpdate(**iter, (uint32)i_timer.GetCurrent());
+
+        m_updater.Wait();
+
+        if (uint32 slowThreshold = sWorld.getConfig(CONFIG_UINT32_MAPUPDATE_SLOW_LOG))
+        {
+            for (std::vector<Map*>::const_iterator iter = maps.begin(); iter != maps.end(); ++iter)
+                if ((*iter)->GetLastUpdateTime() >= slowThreshold)
+                    sLog.outString("MapManager::Update: map %u (instance %u, %s) update took %u ms",
+                                   (*iter)->GetId(), (*iter)->GetInstanceId(), (*iter)->GetMapName(), (*iter)->GetLastUpdateTime());
+        }
+    }
 
     for (TransportSet::iterator iter = m_Transports.begin(); iter != m_Transports.end(); ++iter)
     {
@@ -225,8 +264,30 @@ bool MapManager::IsValidMAP(uint32 mapid)
     // TODO: add check for battleground template
 }
 
+void MapManager::UpdateCreatureScaling()
+{
+    if (!m_maxPlayerLevelDirty.exchange(false))
+        return;
+
+    uint32 maxLevel = 0;
+    HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
+    for (HashMapHolder<Player>::MapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+    {
+        Player* pl = iter->second;
+        if (pl && pl->IsInWorld() && maxLevel < pl->getLevel())
+            maxLevel = pl->getLevel();
+    }
+
+    if (m_maxPlayerLevel.exchange(maxLevel) != maxLevel)
+        ++m_scalingEpoch;
+}
+
 void MapManager::UnloadAll()
 {
+    m_updater.Deactivate();
+    sGridPreloader.Deactivate();
+    sPathfindingService.Deactivate();
+
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->UnloadAll(true);
 
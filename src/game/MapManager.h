@@ -26,6 +26,9 @@
 #include "Map.h"
 #include "GridStates.h"
 #include "ObjectAccessor.h"
+#include "MapUpdater.h"
+
+#include <atomic>
 
 class Transport;
 class BattleGround;
@@ -91,30 +94,10 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
 
         void UnloadAll();
 
-        void SetBestPlayer()
-        {
-            uint32 maxLevel = 0;
-            Player* bestPlayer = nullptr;
-            HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
-            for (HashMapHolder<Player>::MapType::iterator iter = m.begin(); iter != m.end(); ++iter)
-            {
-                Player* pl = iter->second;
-                if (pl && pl->IsInWorld())
-                {
-                    uint32 currentPlayerLevel = pl->getLevel();
-                    if (maxLevel < currentPlayerLevel)
-                    {
-                        maxLevel = currentPlayerLevel;
-                        bestPlayer = pl;
-                    }
-                }
-            }
-
-            if (m_maxPlayerLevel != maxLevel)
-            {
-                m_maxPlayerLevel = maxLevel;
-            }
-        }
+        /// Ask for the max player level to be recomputed at next UpdateCreatureScaling(), safe to call from map threads
+        void RequestMaxPlayerLevelUpdate() { m_maxPlayerLevelDirty = true; }
+        /// Recompute the max player level if requested and bump the scaling epoch when it changed
+        void UpdateCreatureScaling();
 
         uint32 GetMaxPlayerLevel() const
         {
@@ -123,14 +106,18 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
 
         void SetCurrentDifficulty(GameDifficulty difficulty)
         {
-            m_currentDifficulty = difficulty;
+            if (GameDifficulty(m_currentDifficulty.exchange(difficulty)) != difficulty)
+                ++m_scalingEpoch;
         }
 
         GameDifficulty GetCurrentDifficulty() const
         {
-            return m_currentDifficulty;
+            return GameDifficulty(m_currentDifficulty.load());
         }
 
+        /// Changed each time max player level or difficulty changes, creatures compare it in their update to rescale
+        uint32 GetScalingEpoch() const { return m_scalingEpoch; }
+
         static bool ExistMapAndVMap(uint32 mapid, float x, float y);
         static bool IsValidMAP(uint32 mapid);
 
@@ -184,6 +171,7 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         /* statistics */
         uint32 GetNumInstances();
         uint32 GetNumPlayersInInstances();
+        uint32 GetNumMapUpdateThreads() const { return m_updater.GetThreadCount(); }
 
         // get list of all maps
         const MapMapType& Maps() const { return i_maps; }
@@ -215,9 +203,12 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         uint32 i_gridCleanUpDelay;
         MapMapType i_maps;
         IntervalTimer i_timer;
+        MapUpdater m_updater;
 
-        uint32 m_maxPlayerLevel = -1;
-        GameDifficulty m_currentDifficulty = DIFFICULTY_NORMAL;
+        std::atomic<uint32> m_maxPlayerLevel;
+        std::atomic<uint32> m_currentDifficulty;            // GameDifficulty
+        std::atomic<uint32> m_scalingEpoch;
+        std::atomic<bool> m_maxPlayerLevelDirty;
 };
 
 template<typename Do>
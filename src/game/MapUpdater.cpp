@@ -0,0 +1,134 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MapUpdater.h"
+#include "Map.h"
+#include "BroadcastBatch.h"
+#include "UpdateBlockCache.h"
+#include "OpcodeStats.h"
+#include "Timer.h"
+
+MapUpdater::MapUpdater() : m_pending(0), m_cancel(false)
+{
+}
+
+MapUpdater::~MapUpdater()
+{
+    Deactivate();
+}
+
+void MapUpdater::Activate(uint32 numThreads)
+{
+    MANGOS_ASSERT(m_workers.empty());
+
+    m_cancel = false;
+    for (uint32 i = 0; i < numThreads; ++i)
+        m_workers.push_back(std::thread(&MapUpdater::WorkerThread, this));
+}
+
+void MapUpdater::Deactivate()
+{
+    if (m_workers.empty())
+        return;
+
+    Wait();
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_cancel = true;
+    }
+    m_requestCond.notify_all();
+
+    for (std::vector<std::thread>::iterator itr = m_workers.begin(); itr != m_workers.end(); ++itr)
+        itr->join();
+
+    m_workers.clear();
+}
+
+void MapUpdater::ScheduleUpdate(Map& map, uint32 diff)
+{
+    if (m_workers.empty())
+    {
+        UpdateMap(map, diff);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_queue.push_back(UpdateRequest(&map, diff));
+        ++m_pending;
+    }
+    m_requestCond.notify_one();
+}
+
+void MapUpdater::Wait()
+{
+    std::unique_lock<std::mutex> guard(m_lock);
+    m_doneCond.wait(guard, [this] { return m_pending == 0; });
+}
+
+void MapUpdater::UpdateMap(Map& map, uint32 diff)
+{
+    uint32 startTime = WorldTimer::getMSTime();
+
+    {
+        // broadcasts of this tick reach every socket together when the map is done
+        BroadcastBatch batch;
+        BroadcastBatchGuard guard(batch);
+
+        // objects becoming visible to many players serialize their values once
+        UpdateBlockCache blockCache;
+        UpdateBlockCacheGuard blockCacheGuard(blockCache);
+
+        map.Update(diff);
+    }
+
+    sOpcodeStats.Flush();
+
+    map.SetLastUpdateTime(WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()));
+}
+
+void MapUpdater::WorkerThread()
+{
+    for (;;)
+    {
+        UpdateRequest request(nullptr, 0);
+
+        {
+            std::unique_lock<std::mutex> guard(m_lock);
+            m_requestCond.wait(guard, [this] { return m_cancel || !m_queue.empty(); });
+
+            if (m_queue.empty())
+                return;                                     // canceled and nothing left to do
+
+            request = m_queue.front();
+            m_queue.pop_front();
+        }
+
+        UpdateMap(*request.map, request.diff);
+
+        bool done;
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            done = --m_pending == 0;
+        }
+
+        if (done)
+            m_doneCond.notify_all();
+    }
+}
@@ -0,0 +1,85 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPUPDATER_H
+#define MANGOS_MAPUPDATER_H
+
+#include "Common.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Map;
+
+/**
+ * Worker pool used by MapManager to update independent Map instances concurrently.
+ *
+ * The world thread schedules one request per map and then blocks in Wait() until all
+ * of them are done, so everything after the barrier (remove lists, transports, map
+ * unloading) still runs single threaded.
+ */
+class MapUpdater
+{
+    public:
+        MapUpdater();
+        ~MapUpdater();
+
+        /// Start numThreads workers, 0 keeps updating maps in the calling thread
+        void Activate(uint32 numThreads);
+        /// Stop and join all workers, pending requests are finished first
+        void Deactivate();
+        bool IsActive() const { return !m_workers.empty(); }
+        uint32 GetThreadCount() const { return uint32(m_workers.size()); }
+
+        /// Queue map for update, executed at once when no workers are running
+        void ScheduleUpdate(Map& map, uint32 diff);
+        /// Block until all scheduled updates are finished
+        void Wait();
+
+        /// Update map and store its tick duration
+        static void UpdateMap(Map& map, uint32 diff);
+
+    private:
+        MapUpdater(MapUpdater const&);
+        MapUpdater& operator=(MapUpdater const&);
+
+        struct UpdateRequest
+        {
+            UpdateRequest(Map* _map, uint32 _diff) : map(_map), diff(_diff) {}
+
+            Map* map;
+            uint32 diff;
+        };
+
+        void WorkerThread();
+
+        std::mutex m_lock;
+        std::condition_variable m_requestCond;              // signaled when a request is queued or at cancel
+        std::condition_variable m_doneCond;                 // signaled when the last pending request is finished
+
+        std::deque<UpdateRequest> m_queue;
+        uint32 m_pending;                                   // queued + in progress requests
+        bool m_cancel;
+
+        std::vector<std::thread> m_workers;
+};
+
+#endif
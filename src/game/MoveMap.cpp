@@ -187,12 +187,17 @@ namespace MMAP
 
     bool MMapManager::loadMap(uint32 mapId, int32 x, int32 y)
     {
-        // make sure the mmap is loaded and ready to load tiles
-        if (!loadMapData(mapId))
-            return false;
+        MMapData* mmap;
+        {
+            NavMeshWriteGuard guard(navMeshLock);
 
-        // get this mmap data
-        MMapData* mmap = loadedMMaps[mapId];
+            // make sure the mmap is loaded and ready to load tiles
+            if (!loadMapData(mapId))
+                return false;
+
+            // get this mmap data
+            mmap = loadedMMaps[mapId];
+        }
         MANGOS_ASSERT(mmap->navMesh);
 
         // check if we already have this tile loaded
@@ -252,6 +257,8 @@ namespace MMAP
         dtMeshHeader* header = (dtMeshHeader*)data;
         dtTileRef tileRef = 0;
 
+        NavMeshWriteGuard guard(navMeshLock);
+
         // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
         dtStatus dtResult = mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef);
         if (dtStatusFailed(dtResult))
@@ -269,6 +276,8 @@ namespace MMAP
 
     bool MMapManager::unloadMap(uint32 mapId, int32 x, int32 y)
     {
+        NavMeshWriteGuard guard(navMeshLock);
+
         // check if we have this map loaded
         if (loadedMMaps.find(mapId) == loadedMMaps.end())
         {
@@ -313,6 +322,8 @@ namespace MMAP
 
     bool MMapManager::unloadMap(uint32 mapId)
     {
+        NavMeshWriteGuard guard(navMeshLock);
+
         if (loadedMMaps.find(mapId) == loadedMMaps.end())
         {
             // file may not exist, therefore not loaded
@@ -24,6 +24,9 @@
 #include "../../dep/recastnavigation/Detour/Include/DetourNavMesh.h"
 #include "../../dep/recastnavigation/Detour/Include/DetourNavMeshQuery.h"
 
+#include <ace/RW_Thread_Mutex.h>
+#include <ace/Guard_T.h>
+
 class Unit;
 
 //  memory management
@@ -64,6 +67,8 @@ namespace MMAP
     };
 
     typedef std::unordered_map<uint32, MMapData*> MMapDataSet;
+    typedef ACE_Read_Guard<ACE_RW_Thread_Mutex> NavMeshReadGuard;
+    typedef ACE_Write_Guard<ACE_RW_Thread_Mutex> NavMeshWriteGuard;
 
     // singelton class
     // holds all all access to mmap loading unloading and meshes
@@ -84,12 +89,17 @@ namespace MMAP
 
             uint32 getLoadedTilesCount() const { return loadedTiles; }
             uint32 getLoadedMapsCount() const { return loadedMMaps.size(); }
+
+            // held for reading by the pathfinding service threads while they use a navmesh
+            // tiles and navmeshes are added and removed holding it for writing
+            ACE_RW_Thread_Mutex& GetNavMeshLock() { return navMeshLock; }
         private:
             bool loadMapData(uint32 mapId);
             uint32 packTileID(int32 x, int32 y);
 
             MMapDataSet loadedMMaps;
             uint32 loadedTiles;
+            ACE_RW_Thread_Mutex navMeshLock;
     };
 
     // static class
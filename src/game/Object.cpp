@@ -56,6 +56,7 @@ Object::Object()
 
     m_inWorld           = false;
     m_objectUpdated     = false;
+    m_valuesVersion     = 0;
     loot              = nullptr;
 }
 
@@ -87,6 +88,7 @@ void Object::_InitValues()
     m_changedValues.resize(m_valuesCount, false);
 
     m_objectUpdated = false;
+    ++m_valuesVersion;
 }
 
 void Object::_Create(uint32 guidlow, uint32 entry, HighGuid guidhigh)
@@ -193,10 +195,35 @@ void Object::BuildCreateUpdateBlockForPlayer(UpdateData* data, Player* target) c
 
     BuildMovementUpdate(&buf, updateFlags);
 
-    UpdateMask updateMask;
-    updateMask.SetCount(m_valuesCount);
-    _SetCreateBits(&updateMask, target);
-    BuildValuesUpdate(updatetype, &buf, &updateMask, target);
+    // other players only see different viewer dependent fields, share the rest of the values while they are unchanged
+    UpdateBlockCache* cache = target != this ? UpdateBlockCache::Current() : nullptr;
+    if (!cache)
+    {
+        UpdateMask updateMask;
+        updateMask.SetCount(m_valuesCount);
+        _SetCreateBits(&updateMask, target);
+        BuildValuesUpdate(updatetype, &buf, &updateMask, target);
+        data->AddUpdateBlock(buf);
+        return;
+    }
+
+    UpdateBlockCache::Entry const* cached = cache->Find(this);
+    if (!cached)
+    {
+        UpdateBlockCache::Entry& entry = cache->Store(this);
+
+        UpdateMask updateMask;
+        updateMask.SetCount(m_valuesCount);
+        _SetCreateBits(&updateMask, target);
+        BuildValuesUpdate(updatetype, &entry.values, &updateMask, target, &entry.viewerFields);
+        cached = &entry;
+    }
+
+    size_t valuesPos = buf.wpos();
+    buf.append(cached->values);
+    for (UpdateBlockCache::ViewerFieldList::const_iterator itr = cached->viewerFields.begin(); itr != cached->viewerFields.end(); ++itr)
+        buf.put<uint32>(valuesPos + itr->second, GetViewerDependentFieldValue(itr->first, target));
+
     data->AddUpdateBlock(buf);
 }
 
@@ -410,49 +437,32 @@ void Object::BuildMovementUpdate(ByteBuffer* data, uint16 updateFlags) const
     }
 }
 
-void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target) const
+void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target, UpdateBlockCache::ViewerFieldList* viewerFields) const
 {
     if (!target)
         return;
 
-    bool IsActivateToQuest = false;
-    bool IsPerCasterAuraState = false;
-
     if (updatetype == UPDATETYPE_CREATE_OBJECT || updatetype == UPDATETYPE_CREATE_OBJECT2)
     {
         if (isType(TYPEMASK_GAMEOBJECT) && !((GameObject*)this)->IsTransport())
-        {
-            if (((GameObject*)this)->ActivateToQuest(target) || target->isGameMaster())
-                IsActivateToQuest = true;
-
             updateMask->SetBit(GAMEOBJECT_DYNAMIC);
-        }
         else if (isType(TYPEMASK_UNIT))
         {
             if (((Unit*)this)->HasAuraState(AURA_STATE_CONFLAGRATE))
-            {
-                IsPerCasterAuraState = true;
                 updateMask->SetBit(UNIT_FIELD_AURASTATE);
-            }
         }
     }
     else                                                    // case UPDATETYPE_VALUES
     {
         if (isType(TYPEMASK_GAMEOBJECT) && !((GameObject*)this)->IsTransport())
         {
-            if (((GameObject*)this)->ActivateToQuest(target) || target->isGameMaster())
-                IsActivateToQuest = true;
-
             updateMask->SetBit(GAMEOBJECT_DYNAMIC);
             updateMask->SetBit(GAMEOBJECT_BYTES_1);         // why do we need this here?
         }
         else if (isType(TYPEMASK_UNIT))
         {
             if (((Unit*)this)->HasAuraState(AURA_STATE_CONFLAGRATE))
-            {
-                IsPerCasterAuraState = true;
                 updateMask->SetBit(UNIT_FIELD_AURASTATE);
-            }
         }
     }
 
@@ -468,42 +478,12 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
         {
             if (updateMask->GetBit(index))
             {
-                if (index == UNIT_NPC_FLAGS)
+                if (IsViewerDependentField(index))
                 {
-                    uint32 appendValue = m_uint32Values[index];
-
-                    if (GetTypeId() == TYPEID_UNIT)
-                    {
-                        if (!target->canSeeSpellClickOn((Creature*)this))
-                            appendValue &= ~UNIT_NPC_FLAG_SPELLCLICK;
-
-                        if (appendValue & UNIT_NPC_FLAG_TRAINER)
-                        {
-                            if (!((Creature*)this)->IsTrainerOf(target, false))
-                                appendValue &= ~(UNIT_NPC_FLAG_TRAINER | UNIT_NPC_FLAG_TRAINER_CLASS | UNIT_NPC_FLAG_TRAINER_PROFESSION);
-                        }
-
-                        if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
-                        {
-                            if (target->getClass() != CLASS_HUNTER)
-                                appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
-                        }
-                    }
-
-                    *data << uint32(appendValue);
-                }
-                else if (index == UNIT_FIELD_AURASTATE)
-                {
-                    if (IsPerCasterAuraState)
-                    {
-                        // IsPerCasterAuraState set if related pet caster aura state set already
-                        if (((Unit*)this)->HasAuraStateForCaster(AURA_STATE_CONFLAGRATE, target->GetObjectGuid()))
-                            *data << m_uint32Values[index];
-                        else
-                            *data << (m_uint32Values[index] & ~(1 << (AURA_STATE_CONFLAGRATE - 1)));
-                    }
-                    else
-                        *data << m_uint32Values[index];
+                    if (viewerFields)
+                        viewerFields->push_back(std::make_pair(index, data->wpos()));
+
+                    *data << GetViewerDependentFieldValue(index, target);
                 }
                 // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
                 else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
@@ -520,93 +500,6 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
                 {
                     *data << uint32(m_floatValues[index]);
                 }
-
-                // Gamemasters should be always able to select units - remove not selectable flag
-                else if (index == UNIT_FIELD_FLAGS && target->isGameMaster())
-                {
-                    *data << (m_uint32Values[index] & ~UNIT_FLAG_NOT_SELECTABLE);
-                }
-                // Hide special-info for non empathy-casters,
-                // Hide lootable animation for unallowed players
-                // Handle tapped flag
-                else if (index == UNIT_DYNAMIC_FLAGS)
-                {
-                    Creature* creature = (Creature*)this;
-                    uint32 dynflagsValue = m_uint32Values[index];
-                    bool setTapFlags = false;
-
-                    if (creature->isAlive())
-                    {
-                        // Checking SPELL_AURA_EMPATHY and caster
-                        if (dynflagsValue & UNIT_DYNFLAG_SPECIALINFO)
-                        {
-                            bool bIsEmpathy = false;
-                            bool bIsCaster = false;
-                            Unit::AuraList const& mAuraEmpathy = creature->GetAurasByType(SPELL_AURA_EMPATHY);
-                            for (Unit::AuraList::const_iterator itr = mAuraEmpathy.begin(); !bIsCaster && itr != mAuraEmpathy.end(); ++itr)
-                            {
-                                bIsEmpathy = true;              // Empathy by aura set
-                                if ((*itr)->GetCasterGuid() == target->GetObjectGuid())
-                                    bIsCaster = true;           // target is the caster of an empathy aura
-                            }
-                            if (bIsEmpathy && !bIsCaster)       // Empathy by aura, but target is not the caster
-                                dynflagsValue &= ~UNIT_DYNFLAG_SPECIALINFO;
-                        }
-
-                        // creature is alive so, not lootable
-                        dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
-                        if (creature->isInCombat())
-                        {
-                            // as creature is in combat we have to manage tap flags
-                            setTapFlags = true;
-                        }
-                        else
-                        {
-                            // creature is not in combat so its not tapped
-                            dynflagsValue = dynflagsValue & ~(UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER);
-                            //sLog.outString(">> %s is not in combat so not tapped by %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
-                        }
-                    }
-                    else
-                    {
-                        // check loot flag
-                        if (creature->loot && creature->loot->CanLoot(target))
-                        {
-                            // creature is dead and this player can loot it
-                            dynflagsValue = dynflagsValue | UNIT_DYNFLAG_LOOTABLE;
-                            //sLog.outString(">> %s is lootable for %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
-                        }
-                        else
-                        {
-                            // creature is dead but this player cannot loot it
-                            dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
-                            //sLog.outString(">> %s is not lootable for %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
-                        }
-
-                        // as creature is died we have to manage tap flags
-                        setTapFlags = true;
-                    }
-
-                    // check tap flags
-                    if (setTapFlags)
-                    {
-                        dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED;
-                        if (creature->IsTappedBy(target))
-                        {
-                            // creature is in combat or died and tapped by this player
-                            dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED_BY_PLAYER;
-                            //sLog.outString(">> %s is tapped by %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
-                        }
-                        else
-                        {
-                            // creature is in combat or died but not tapped by this player
-                            dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_TAPPED_BY_PLAYER;
-                            //sLog.outString(">> %s is not tapped by %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
-                        }
-                    }
-
-                    *data << dynflagsValue;
-                }
                 else                                        // Unhandled index, just send
                 {
                     // send in current format (float as float, uint32 as uint32)
@@ -621,48 +514,12 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
         {
             if (updateMask->GetBit(index))
             {
-                // send in current format (float as float, uint32 as uint32)
-                if (index == GAMEOBJECT_DYNAMIC)
+                if (IsViewerDependentField(index))
                 {
-                    // GAMEOBJECT_TYPE_DUNGEON_DIFFICULTY can have lo flag = 2
-                    //      most likely related to "can enter map" and then should be 0 if can not enter
-
-                    if (IsActivateToQuest)
-                    {
-                        GameObject const* gameObject = static_cast<GameObject const*>(this);
-                        switch (((GameObject*)this)->GetGoType())
-                        {
-                            case GAMEOBJECT_TYPE_QUESTGIVER:
-                                // GO also seen with GO_DYNFLAG_LO_SPARKLE explicit, relation/reason unclear (192861)
-                                *data << uint16(GO_DYNFLAG_LO_ACTIVATE);
-                                *data << uint16(-1);
-                                break;
-                            case GAMEOBJECT_TYPE_CHEST:
-                                if (gameObject->getLootState() == GO_READY || gameObject->getLootState() == GO_ACTIVATED)
-                                    *data << uint16(GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE);
-                                else
-                                    *data << uint16(0);
-                                *data << uint16(-1);
-                                break;
-                            case GAMEOBJECT_TYPE_GENERIC:
-                            case GAMEOBJECT_TYPE_SPELL_FOCUS:
-                            case GAMEOBJECT_TYPE_GOOBER:
-                                *data << uint16(GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE);
-                                *data << uint16(-1);
-                                break;
-                            default:
-                                // unknown, not happen.
-                                *data << uint16(0);
-                                *data << uint16(-1);
-                                break;
-                        }
-                    }
-                    else
-                    {
-                        // disable quest object
-                        *data << uint16(0);
-                        *data << uint16(-1);
-                    }
+                    if (viewerFields)
+                        viewerFields->push_back(std::make_pair(index, data->wpos()));
+
+                    *data << GetViewerDependentFieldValue(index, target);
                 }
                 else
                     *data << m_uint32Values[index];         // other cases
@@ -682,6 +539,173 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
     }
 }
 
+/// Fields sent with a different value to each player, see GetViewerDependentFieldValue()
+bool Object::IsViewerDependentField(uint16 index) const
+{
+    if (isType(TYPEMASK_UNIT))
+        return index == UNIT_NPC_FLAGS || index == UNIT_FIELD_AURASTATE || index == UNIT_FIELD_FLAGS || index == UNIT_DYNAMIC_FLAGS;
+
+    if (isType(TYPEMASK_GAMEOBJECT))
+        return index == GAMEOBJECT_DYNAMIC;
+
+    return false;
+}
+
+uint32 Object::GetViewerDependentFieldValue(uint16 index, Player* target) const
+{
+    if (isType(TYPEMASK_GAMEOBJECT))
+    {
+        // GAMEOBJECT_DYNAMIC, low uint16 are the flags, high uint16 always -1
+        // GAMEOBJECT_TYPE_DUNGEON_DIFFICULTY can have lo flag = 2
+        //      most likely related to "can enter map" and then should be 0 if can not enter
+        GameObject const* gameObject = static_cast<GameObject const*>(this);
+        uint16 dynamicFlags = 0;                            // disable quest object
+
+        if (!gameObject->IsTransport() && (gameObject->ActivateToQuest(target) || target->isGameMaster()))
+        {
+            switch (gameObject->GetGoType())
+            {
+                case GAMEOBJECT_TYPE_QUESTGIVER:
+                    // GO also seen with GO_DYNFLAG_LO_SPARKLE explicit, relation/reason unclear (192861)
+                    dynamicFlags = GO_DYNFLAG_LO_ACTIVATE;
+                    break;
+                case GAMEOBJECT_TYPE_CHEST:
+                    if (gameObject->getLootState() == GO_READY || gameObject->getLootState() == GO_ACTIVATED)
+                        dynamicFlags = GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE;
+                    break;
+                case GAMEOBJECT_TYPE_GENERIC:
+                case GAMEOBJECT_TYPE_SPELL_FOCUS:
+                case GAMEOBJECT_TYPE_GOOBER:
+                    dynamicFlags = GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE;
+                    break;
+                default:
+                    // unknown, not happen.
+                    break;
+            }
+        }
+
+        return uint32(dynamicFlags) | (uint32(uint16(-1)) << 16);
+    }
+
+    if (index == UNIT_NPC_FLAGS)
+    {
+        uint32 appendValue = m_uint32Values[index];
+
+        if (GetTypeId() == TYPEID_UNIT)
+        {
+            if (!target->canSeeSpellClickOn((Creature*)this))
+                appendValue &= ~UNIT_NPC_FLAG_SPELLCLICK;
+
+            if (appendValue & UNIT_NPC_FLAG_TRAINER)
+            {
+                if (!((Creature*)this)->IsTrainerOf(target, false))
+                    appendValue &= ~(UNIT_NPC_FLAG_TRAINER | UNIT_NPC_FLAG_TRAINER_CLASS | UNIT_NPC_FLAG_TRAINER_PROFESSION);
+            }
+
+            if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
+            {
+                if (target->getClass() != CLASS_HUNTER)
+                    appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
+            }
+        }
+
+        return appendValue;
+    }
+
+    if (index == UNIT_FIELD_AURASTATE)
+    {
+        // the conflagrate aura state is only shown to the caster of the related aura
+        if (((Unit*)this)->HasAuraState(AURA_STATE_CONFLAGRATE) && !((Unit*)this)->HasAuraStateForCaster(AURA_STATE_CONFLAGRATE, target->GetObjectGuid()))
+            return m_uint32Values[index] & ~(1 << (AURA_STATE_CONFLAGRATE - 1));
+
+        return m_uint32Values[index];
+    }
+
+    // Gamemasters should be always able to select units - remove not selectable flag
+    if (index == UNIT_FIELD_FLAGS)
+        return target->isGameMaster() ? (m_uint32Values[index] & ~UNIT_FLAG_NOT_SELECTABLE) : m_uint32Values[index];
+
+    // UNIT_DYNAMIC_FLAGS
+    // Hide special-info for non empathy-casters,
+    // Hide lootable animation for unallowed players
+    // Handle tapped flag
+    Creature* creature = (Creature*)this;
+    uint32 dynflagsValue = m_uint32Values[index];
+    bool setTapFlags = false;
+
+    if (creature->isAlive())
+    {
+        // Checking SPELL_AURA_EMPATHY and caster
+        if (dynflagsValue & UNIT_DYNFLAG_SPECIALINFO)
+        {
+            bool bIsEmpathy = false;
+            bool bIsCaster = false;
+            Unit::AuraList const& mAuraEmpathy = creature->GetAurasByType(SPELL_AURA_EMPATHY);
+            for (Unit::AuraList::const_iterator itr = mAuraEmpathy.begin(); !bIsCaster && itr != mAuraEmpathy.end(); ++itr)
+            {
+                bIsEmpathy = true;                          // Empathy by aura set
+                if ((*itr)->GetCasterGuid() == target->GetObjectGuid())
+                    bIsCaster = true;                       // target is the caster of an empathy aura
+            }
+            if (bIsEmpathy && !bIsCaster)                   // Empathy by aura, but target is not the caster
+                dynflagsValue &= ~UNIT_DYNFLAG_SPECIALINFO;
+        }
+
+        // creature is alive so, not lootable
+        dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
+        if (creature->isInCombat())
+        {
+            // as creature is in combat we have to manage tap flags
+            setTapFlags = true;
+        }
+        else
+        {
+            // creature is not in combat so its not tapped
+            dynflagsValue = dynflagsValue & ~(UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER);
+            //sLog.outString(">> %s is not in combat so not tapped by %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
+        }
+    }
+    else
+    {
+        // check loot flag
+        if (creature->loot && creature->loot->CanLoot(target))
+        {
+            // creature is dead and this player can loot it
+            dynflagsValue = dynflagsValue | UNIT_DYNFLAG_LOOTABLE;
+            //sLog.outString(">> %s is lootable for %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
+        }
+        else
+        {
+            // creature is dead but this player cannot loot it
+            dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
+            //sLog.outString(">> %s is not lootable for %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
+        }
+
+        // as creature is died we have to manage tap flags
+        setTapFlags = true;
+    }
+
+    // check tap flags
+    if (setTapFlags)
+    {
+        dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED;
+        if (creature->IsTappedBy(target))
+        {
+            // creature is in combat or died and tapped by this player
+            dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED_BY_PLAYER;
+            //sLog.outString(">> %s is tapped by %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
+        }
+        else
+        {
+            // creature is in combat or died but not tapped by this player
+            dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_TAPPED_BY_PLAYER;
+            //sLog.outString(">> %s is not tapped by %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
+        }
+    }
+
+    return dynflagsValue;
+}
+
 void Object::ClearUpdateMask(bool remove)
 {
     if (m_uint32Values)
@@ -714,6 +738,7 @@ bool Object::LoadValues(const char* data)
         m_uint32Values[index] = std::stoul((*iter).c_str());
     }
 
+    ++m_valuesVersion;
     return true;
 }
 
@@ -1004,6 +1029,8 @@ void Object::BuildUpdateData(UpdateDataMapType& /*update_players */)
 
 void Object::MarkForClientUpdate()
 {
+    ++m_valuesVersion;
+
     if (m_inWorld)
     {
         if (!m_objectUpdated)
@@ -1017,6 +1044,7 @@ void Object::MarkForClientUpdate()
 void Object::ForceValuesUpdateAtIndex(uint32 index)
 {
     m_changedValues[index] = true;
+    ++m_valuesVersion;
     if (m_inWorld && !m_objectUpdated)
     {
         AddToClientUpdateList();
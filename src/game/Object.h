@@ -23,6 +23,7 @@
 #include "ByteBuffer.h"
 #include "UpdateFields.h"
 #include "UpdateData.h"
+#include "UpdateBlockCache.h"
 #include "ObjectGuid.h"
 #include "Camera.h"
 
@@ -34,7 +35,7 @@
 #define ATTACK_DISTANCE             5.0f
 #define INSPECT_DISTANCE            28.0f
 #define TRADE_DISTANCE              11.11f
-#define MAX_VISIBILITY_DISTANCE     SIZE_OF_GRID_CELL                // max distance for visible object show, limited by active zone for player based at cell size (active zone = 5x5 cells)
+#define MAX_VISIBILITY_DISTANCE     SIZE_OF_GRIDS                    // max distance for visible object show, independent from cell size (active zone is computed from it)
 #define DEFAULT_VISIBILITY_DISTANCE (MAX_VISIBILITY_DISTANCE)        // default visible distance
 #define DEFAULT_VISIBILITY_INSTANCE (MAX_VISIBILITY_DISTANCE)        // default visible distance
 #define DEFAULT_VISIBILITY_BGARENAS (MAX_VISIBILITY_DISTANCE)        // default visible distance
@@ -361,6 +362,9 @@ class MANGOS_DLL_SPEC Object
 
         uint16 GetValuesCount() const { return m_valuesCount; }
 
+        /// Changes whenever a field value changes, tells if serialized values are still valid
+        uint32 GetValuesVersion() const { return m_valuesVersion; }
+
         virtual bool HasQuest(uint32 /* quest_id */) const { return false; }
         virtual bool HasInvolvedQuest(uint32 /* quest_id */) const { return false; }
 
@@ -377,7 +381,9 @@ class MANGOS_DLL_SPEC Object
         virtual void _SetCreateBits(UpdateMask* updateMask, Player* target) const;
 
         void BuildMovementUpdate(ByteBuffer* data, uint16 updateFlags) const;
-        void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target) const;
+        void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target, UpdateBlockCache::ViewerFieldList* viewerFields = nullptr) const;
+        bool IsViewerDependentField(uint16 index) const;
+        uint32 GetViewerDependentFieldValue(uint16 index, Player* target) const;
         void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players);
 
         uint16 m_objectType;
@@ -397,6 +403,7 @@ class MANGOS_DLL_SPEC Object
         uint16 m_valuesCount;
 
         bool m_objectUpdated;
+        uint32 m_valuesVersion;
 
     private:
         bool m_inWorld;
@@ -157,6 +157,7 @@ ObjectMgr::ObjectMgr() :
     m_FirstTemporaryGameObjectGuid(1),
     DBCLocaleIndex(LOCALE_enUS)
 {
+    m_LocalForIndex.reserve(MAX_LOCALE);                    // never reallocated, readers do not lock
 }
 
 ObjectMgr::~ObjectMgr()
@@ -1302,8 +1303,10 @@ void ObjectMgr::LoadCreatureModelRace()
 void ObjectMgr::LoadCreatures()
 {
     uint32 count = 0;
-    //                                                0                       1   2    3
-    QueryResult* result = WorldDatabase.Query("SELECT creature.guid, creature.id, map, modelid,"
+    // prepared statement: numeric columns of the large spawn tables are read without text conversion
+    static SqlStatementID selectCreatures;
+    //                                                                                  0                       1   2    3
+    QueryResult* result = WorldDatabase.CreateStatement(selectCreatures, "SELECT creature.guid, creature.id, map, modelid,"
                           //   4             5           6           7           8            9              10         11
                           "equipment_id, position_x, position_y, position_z, orientation, spawntimesecs, spawndist, currentwaypoint,"
                           //   12         13       14          15            16         17         18
@@ -1313,7 +1316,7 @@ void ObjectMgr::LoadCreatures()
                           "FROM creature "
                           "LEFT OUTER JOIN game_event_creature ON creature.guid = game_event_creature.guid "
                           "LEFT OUTER JOIN pool_creature ON creature.guid = pool_creature.guid "
-                          "LEFT OUTER JOIN pool_creature_template ON creature.id = pool_creature_template.id");
+                          "LEFT OUTER JOIN pool_creature_template ON creature.id = pool_creature_template.id").Query();
 
     if (!result)
     {
@@ -1526,8 +1529,9 @@ void ObjectMgr::LoadGameObjects()
 {
     uint32 count = 0;
 
-    //                                                0                           1   2    3           4           5           6
-    QueryResult* result = WorldDatabase.Query("SELECT gameobject.guid, gameobject.id, map, position_x, position_y, position_z, orientation,"
+    static SqlStatementID selectGameObjects;
+    //                                                                                    0                           1   2    3           4           5           6
+    QueryResult* result = WorldDatabase.CreateStatement(selectGameObjects, "SELECT gameobject.guid, gameobject.id, map, position_x, position_y, position_z, orientation,"
                           //   7          8          9          10         11             12            13     14         15         16
                           "rotation0, rotation1, rotation2, rotation3, spawntimesecs, animprogress, state, spawnMask, phaseMask, event,"
                           //   17                          18
@@ -1535,7 +1539,7 @@ void ObjectMgr::LoadGameObjects()
                           "FROM gameobject "
                           "LEFT OUTER JOIN game_event_gameobject ON gameobject.guid = game_event_gameobject.guid "
                           "LEFT OUTER JOIN pool_gameobject ON gameobject.guid = pool_gameobject.guid "
-                          "LEFT OUTER JOIN pool_gameobject_template ON gameobject.id = pool_gameobject_template.id");
+                          "LEFT OUTER JOIN pool_gameobject_template ON gameobject.id = pool_gameobject_template.id").Query();
 
     if (!result)
     {
@@ -7053,7 +7057,9 @@ void ObjectMgr::LoadQuestRelationsHelper(QuestRelationsMap& map, char const* tab
 
     uint32 count = 0;
 
-    QueryResult* result = WorldDatabase.PQuery("SELECT id,quest FROM %s", table);
+    std::string selectSql = std::string("SELECT id,quest FROM ") + table;
+    SqlStatementID selectStmt;
+    QueryResult* result = WorldDatabase.CreateStatement(selectStmt, selectSql.c_str()).Query();
 
     if (!result)
     {
@@ -7363,6 +7369,8 @@ int ObjectMgr::GetOrNewIndexForLocale(LocaleConstant loc)
     if (loc == LOCALE_enUS)
         return -1;
 
+    std::lock_guard<std::mutex> guard(m_LocalForIndexLock);
+
     for (size_t i = 0; i < m_LocalForIndex.size(); ++i)
         if (m_LocalForIndex[i] == loc)
             return i;
@@ -8794,7 +8802,9 @@ void ObjectMgr::LoadTrainers(char const* tableName, bool isTemplates)
 
     std::set<uint32> skip_trainers;
 
-    QueryResult* result = WorldDatabase.PQuery("SELECT entry, spell,spellcost,reqskill,reqskillvalue,reqlevel FROM %s", tableName);
+    std::string selectSql = std::string("SELECT entry, spell,spellcost,reqskill,reqskillvalue,reqlevel FROM ") + tableName;
+    SqlStatementID selectStmt;
+    QueryResult* result = WorldDatabase.CreateStatement(selectStmt, selectSql.c_str()).Query();
 
     if (!result)
     {
@@ -8988,7 +8998,9 @@ void ObjectMgr::LoadVendors(char const* tableName, bool isTemplates)
 
     std::set<uint32> skip_vendors;
 
-    QueryResult* result = WorldDatabase.PQuery("SELECT entry, item, maxcount, incrtime, ExtendedCost, condition_id FROM %s", tableName);
+    std::string selectSql = std::string("SELECT entry, item, maxcount, incrtime, ExtendedCost, condition_id FROM ") + tableName;
+    SqlStatementID selectStmt;
+    QueryResult* result = WorldDatabase.CreateStatement(selectStmt, selectSql.c_str()).Query();
     if (!result)
     {
         BarGoLink bar(1);
@@ -40,6 +40,7 @@
 #include <string>
 #include <map>
 #include <limits>
+#include <mutex>
 
 class Group;
 class ArenaTeam;
@@ -1190,6 +1191,7 @@ class ObjectMgr
 
         typedef             std::vector<LocaleConstant> LocalForIndex;
         LocalForIndex        m_LocalForIndex;
+        std::mutex           m_LocalForIndexLock;           // locale loaders may run in parallel at startup
 
         ExclusiveQuestGroupsMap m_ExclusiveQuestGroups;
 
@@ -0,0 +1,243 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "OpcodeStats.h"
+#include "Opcodes.h"
+#include "World.h"
+#include "Log.h"
+#include "Policies/Singleton.h"
+
+#include <ace/TSS_T.h>
+
+#include <algorithm>
+#include <atomic>
+
+INSTANTIATE_SINGLETON_1(OpcodeStats);
+
+/// Threads without own Flush() calls merge after this many counted events
+static const uint32 ACCUMULATOR_AUTO_FLUSH = 4096;
+/// Opcodes shown per ranking in the periodic log line
+static const uint32 LOGGED_OPCODES = 5;
+
+/// Set while sOpcodeStats exists, the accumulator of the main thread is destroyed after it at exit
+static std::atomic<bool> s_totalsAlive(false);
+
+void OpcodeCounters::Add(OpcodeCounters const& other)
+{
+    received += other.received;
+    bytesIn += other.bytesIn;
+    handled += other.handled;
+    handlerTime += other.handlerTime;
+    maxHandlerTime = std::max(maxHandlerTime, other.maxHandlerTime);
+    for (uint32 i = 0; i < OPCODE_TIME_BUCKETS; ++i)
+        histogram[i] += other.histogram[i];
+    sent += other.sent;
+    bytesOut += other.bytesOut;
+}
+
+/// Counters of one thread not merged into the totals yet
+class OpcodeAccumulator
+{
+    public:
+        OpcodeAccumulator() : m_counters(NUM_MSG_TYPES), m_isTouched(NUM_MSG_TYPES, false), m_events(0) {}
+
+        // merge what is left when the thread exits
+        ~OpcodeAccumulator()
+        {
+            if (s_totalsAlive)
+                Flush();
+        }
+
+        OpcodeCounters& Touch(uint16 opcode)
+        {
+            if (!m_isTouched[opcode])
+            {
+                m_isTouched[opcode] = true;
+                m_touched.push_back(opcode);
+            }
+
+            return m_counters[opcode];
+        }
+
+        void Counted()
+        {
+            if (++m_events >= ACCUMULATOR_AUTO_FLUSH)
+                Flush();
+        }
+
+        void Flush()
+        {
+            if (m_touched.empty())
+                return;
+
+            for (std::vector<uint16>::const_iterator itr = m_touched.begin(); itr != m_touched.end(); ++itr)
+                m_isTouched[*itr] = false;
+
+            sOpcodeStats.Merge(m_counters, m_touched);
+            m_events = 0;
+        }
+
+    private:
+        std::vector<OpcodeCounters> m_counters;
+        std::vector<bool> m_isTouched;
+        std::vector<uint16> m_touched;                      // opcodes with counters, merged and reset by Flush()
+        uint32 m_events;
+};
+
+typedef ACE_TSS<OpcodeAccumulator> OpcodeAccumulatorTSS;
+static OpcodeAccumulatorTSS s_accumulator;
+
+OpcodeStats::OpcodeStats() : m_totals(NUM_MSG_TYPES), m_lastLogged(NUM_MSG_TYPES), m_logTimer(0)
+{
+    s_totalsAlive = true;
+}
+
+OpcodeStats::~OpcodeStats()
+{
+    s_totalsAlive = false;
+}
+
+void OpcodeStats::CountReceived(uint16 opcode, size_t bytes)
+{
+    if (opcode >= NUM_MSG_TYPES)
+        return;
+
+    OpcodeCounters& counters = s_accumulator->Touch(opcode);
+    ++counters.received;
+    counters.bytesIn += bytes;
+
+    s_accumulator->Counted();
+}
+
+void OpcodeStats::CountHandled(uint16 opcode, uint32 microseconds)
+{
+    if (opcode >= NUM_MSG_TYPES)
+        return;
+
+    OpcodeCounters& counters = s_accumulator->Touch(opcode);
+    ++counters.handled;
+    counters.handlerTime += microseconds;
+    counters.maxHandlerTime = std::max(counters.maxHandlerTime, microseconds);
+
+    uint32 bucket = 0;
+    while (bucket < OPCODE_TIME_BUCKETS - 1 && microseconds >= OPCODE_TIME_BUCKET_LIMITS[bucket])
+        ++bucket;
+    ++counters.histogram[bucket];
+
+    s_accumulator->Counted();
+}
+
+void OpcodeStats::CountSent(uint16 opcode, size_t bytes)
+{
+    if (opcode >= NUM_MSG_TYPES)
+        return;
+
+    OpcodeCounters& counters = s_accumulator->Touch(opcode);
+    ++counters.sent;
+    counters.bytesOut += bytes;
+
+    s_accumulator->Counted();
+}
+
+void OpcodeStats::Flush()
+{
+    s_accumulator->Flush();
+}
+
+void OpcodeStats::Merge(std::vector<OpcodeCounters>& counters, std::vector<uint16>& touched)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        for (std::vector<uint16>::const_iterator itr = touched.begin(); itr != touched.end(); ++itr)
+            m_totals[*itr].Add(counters[*itr]);
+    }
+
+    for (std::vector<uint16>::const_iterator itr = touched.begin(); itr != touched.end(); ++itr)
+        counters[*itr] = OpcodeCounters();
+
+    touched.clear();
+}
+
+void OpcodeStats::GetTotals(std::vector<OpcodeCounters>& totals)
+{
+    Flush();
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    totals = m_totals;
+}
+
+void OpcodeStats::Update(uint32 diff)
+{
+    uint32 interval = sWorld.getConfig(CONFIG_UINT32_OPCODE_STATS_LOG_INTERVAL) * IN_MILLISECONDS;
+    if (!interval)
+        return;
+
+    m_logTimer += diff;
+    if (m_logTimer < interval)
+        return;
+
+    std::vector<OpcodeCounters> totals;
+    GetTotals(totals);
+
+    // counters of the interval only
+    std::vector<OpcodeCounters> current(totals);
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        current[i].received -= m_lastLogged[i].received;
+        current[i].bytesIn -= m_lastLogged[i].bytesIn;
+        current[i].handled -= m_lastLogged[i].handled;
+        current[i].handlerTime -= m_lastLogged[i].handlerTime;
+        current[i].sent -= m_lastLogged[i].sent;
+        current[i].bytesOut -= m_lastLogged[i].bytesOut;
+    }
+
+    std::vector<uint16> byTime, byBytesOut;
+    for (uint32 i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        if (current[i].handlerTime)
+            byTime.push_back(uint16(i));
+        if (current[i].bytesOut)
+            byBytesOut.push_back(uint16(i));
+    }
+
+    std::sort(byTime.begin(), byTime.end(), [&current](uint16 a, uint16 b) { return current[a].handlerTime > current[b].handlerTime; });
+    std::sort(byBytesOut.begin(), byBytesOut.end(), [&current](uint16 a, uint16 b) { return current[a].bytesOut > current[b].bytesOut; });
+
+    std::string timeList, bytesList;
+    char buf[128];
+    for (uint32 i = 0; i < byTime.size() && i < LOGGED_OPCODES; ++i)
+    {
+        OpcodeCounters const& counters = current[byTime[i]];
+        snprintf(buf, sizeof(buf), "%s%s %u ms/" UI64FMTD, i ? ", " : "", LookupOpcodeName(byTime[i]), uint32(counters.handlerTime / 1000), counters.handled);
+        timeList += buf;
+    }
+
+    for (uint32 i = 0; i < byBytesOut.size() && i < LOGGED_OPCODES; ++i)
+    {
+        OpcodeCounters const& counters = current[byBytesOut[i]];
+        snprintf(buf, sizeof(buf), "%s%s " UI64FMTD " KB", i ? ", " : "", LookupOpcodeName(byBytesOut[i]), counters.bytesOut / 1024);
+        bytesList += buf;
+    }
+
+    sLog.outString("Opcode stats of last %u s, handler time: %s; sent: %s", m_logTimer / IN_MILLISECONDS,
+                   timeList.empty() ? "none" : timeList.c_str(), bytesList.empty() ? "none" : bytesList.c_str());
+
+    m_lastLogged.swap(totals);
+    m_logTimer = 0;
+}
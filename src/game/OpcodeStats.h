@@ -0,0 +1,89 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_OPCODESTATS_H
+#define MANGOS_OPCODESTATS_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <mutex>
+#include <vector>
+
+/// Upper bounds (microseconds) of the handler time histogram buckets, the last bucket takes everything above
+static const uint32 OPCODE_TIME_BUCKET_LIMITS[] = { 16, 64, 256, 1000, 4000, 16000 };
+static const uint32 OPCODE_TIME_BUCKETS = sizeof(OPCODE_TIME_BUCKET_LIMITS) / sizeof(OPCODE_TIME_BUCKET_LIMITS[0]) + 1;
+
+/// Counters of one opcode
+struct OpcodeCounters
+{
+    OpcodeCounters() { memset(this, 0, sizeof(*this)); }
+
+    uint64 received;                                        // packets received from clients
+    uint64 bytesIn;                                         // including headers
+    uint64 handled;                                         // packets passed to their handler
+    uint64 handlerTime;                                     // microseconds spent in the handler
+    uint32 maxHandlerTime;
+    uint64 histogram[OPCODE_TIME_BUCKETS];                  // handled packets per handler time bucket
+    uint64 sent;                                            // packets written to sockets, broadcasts count once per receiver
+    uint64 bytesOut;                                        // including headers
+
+    void Add(OpcodeCounters const& other);
+};
+
+/**
+ * Always-on CPU and bandwidth accounting per opcode.
+ *
+ * Counting only touches an accumulator of the calling thread. Threads with a tick (world, map
+ * updaters, network threads) merge their accumulator into the totals once per tick with Flush(),
+ * other threads merge when enough was counted or when they exit.
+ */
+class OpcodeStats
+{
+    public:
+        OpcodeStats();
+        ~OpcodeStats();
+
+        void CountReceived(uint16 opcode, size_t bytes);
+        void CountHandled(uint16 opcode, uint32 microseconds);
+        void CountSent(uint16 opcode, size_t bytes);
+
+        /// Merge the counters of the calling thread into the totals
+        void Flush();
+
+        /// Copy of the totals since start, indexed by opcode
+        void GetTotals(std::vector<OpcodeCounters>& totals);
+
+        /// Logs the busiest opcodes of the last interval (OpcodeStats.LogInterval), called by the world thread
+        void Update(uint32 diff);
+
+    private:
+        friend class OpcodeAccumulator;
+
+        void Merge(std::vector<OpcodeCounters>& counters, std::vector<uint16>& touched);
+
+        std::mutex m_lock;
+        std::vector<OpcodeCounters> m_totals;
+
+        std::vector<OpcodeCounters> m_lastLogged;           // totals at the previous log line
+        uint32 m_logTimer;
+};
+
+#define sOpcodeStats MaNGOS::Singleton<OpcodeStats>::Instance()
+
+#endif
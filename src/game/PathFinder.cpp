@@ -28,9 +28,10 @@
 PathFinder::PathFinder(const Unit* owner) :
     m_polyLength(0), m_type(PATHFIND_BLANK),
     m_useStraightPath(false), m_forceDestination(false), m_pointPathLimit(MAX_POINT_PATH_LENGTH),
-    m_sourceUnit(owner), m_navMesh(nullptr), m_navMeshQuery(nullptr)
+    m_sourceUnit(owner), m_sourceGuidLow(owner->GetGUIDLow()), m_navMesh(nullptr), m_navMeshQuery(nullptr),
+    m_sourceIsCreature(false), m_canSwim(false), m_canFly(false), m_startUnderWater(false), m_endUnderWater(false)
 {
-    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceUnit->GetGUIDLow());
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceGuidLow);
 
     uint32 mapId = m_sourceUnit->GetMapId();
     if (MMAP::MMapFactory::IsPathfindingEnabled(mapId, owner))
@@ -45,10 +46,18 @@ PathFinder::PathFinder(const Unit* owner) :
 
 PathFinder::~PathFinder()
 {
-    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::~PathInfo() for %u \n", m_sourceUnit->GetGUIDLow());
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::~PathInfo() for %u \n", m_sourceGuidLow);
 }
 
 bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest)
+{
+    if (prepareCalculation(destX, destY, destZ, forceDest))
+        BuildPolyPath(getStartPosition(), getEndPosition());
+
+    return true;
+}
+
+bool PathFinder::prepareCalculation(float destX, float destY, float destZ, bool forceDest)
 {
     // Vector3 oldDest = getEndPosition();
     Vector3 dest(destX, destY, destZ);
@@ -61,7 +70,7 @@ bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest
 
     m_forceDestination = forceDest;
 
-    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::calculate() for %u \n", m_sourceUnit->GetGUIDLow());
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::calculate() for %u \n", m_sourceGuidLow);
 
     // make sure navMesh works - we can run on map w/o mmap
     // check if the start and end point have a .mmtile loaded (can we pass via not loaded tile on the way?)
@@ -70,15 +79,58 @@ bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest
     {
         BuildShortcut();
         m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
-        return true;
+        return false;
     }
 
     updateFilter();
 
-    BuildPolyPath(start, dest);
+    m_sourceIsCreature = m_sourceUnit->GetTypeId() == TYPEID_UNIT;
+    if (m_sourceIsCreature)
+    {
+        Creature const* creature = (Creature const*)m_sourceUnit;
+        m_canSwim = creature->CanSwim();
+        m_canFly = creature->CanFly();
+        m_startUnderWater = m_sourceUnit->GetTerrain()->IsUnderWater(start.x, start.y, start.z);
+        m_endUnderWater = m_sourceUnit->GetTerrain()->IsUnderWater(dest.x, dest.y, dest.z);
+    }
+
     return true;
 }
 
+void PathFinder::calculatePrepared(const dtNavMeshQuery* navMeshQuery)
+{
+    // the navmesh of the map was unloaded meanwhile
+    if (!navMeshQuery)
+    {
+        BuildShortcut();
+        m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
+        return;
+    }
+
+    // the navmesh taken on the map thread may have been replaced meanwhile
+    m_navMesh = navMeshQuery->getAttachedNavMesh();
+    m_navMeshQuery = navMeshQuery;
+    BuildPolyPath(getStartPosition(), getEndPosition());
+}
+
+void PathFinder::copyPath(const PathFinder& other)
+{
+    memcpy(m_pathPolyRefs, other.m_pathPolyRefs, other.m_polyLength * sizeof(dtPolyRef));
+    m_polyLength = other.m_polyLength;
+    m_pathPoints = other.m_pathPoints;
+    m_type = other.m_type;
+    m_startPosition = other.m_startPosition;
+    m_endPosition = other.m_endPosition;
+    m_actualEndPosition = other.m_actualEndPosition;
+}
+
+uint64 PathFinder::getRequestFlags() const
+{
+    return uint64(m_filter.getIncludeFlags()) | (uint64(m_filter.getExcludeFlags()) << 16) | (uint64(m_pointPathLimit) << 32) |
+           (uint64(m_useStraightPath) << 40) | (uint64(m_forceDestination) << 41) | (uint64(m_sourceIsCreature) << 42) |
+           (uint64(m_canSwim) << 43) | (uint64(m_canFly) << 44) | (uint64(m_startUnderWater) << 45) | (uint64(m_endUnderWater) << 46);
+}
+
 dtPolyRef PathFinder::getPathPolyByPosition(const dtPolyRef* polyPath, uint32 polyPathSize, const float* point, float* distance) const
 {
     if (!polyPath || !polyPathSize)
@@ -168,14 +220,14 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: (startPoly == 0 || endPoly == 0)\n");
         BuildShortcut();
 
-        if (m_sourceUnit->GetTypeId() == TYPEID_UNIT)
+        if (m_sourceIsCreature)
         {
             // Check for swimming or flying shortcut
-            if ((startPoly == INVALID_POLYREF && m_sourceUnit->GetTerrain()->IsUnderWater(startPos.x, startPos.y, startPos.z)) ||
-                    (endPoly == INVALID_POLYREF && m_sourceUnit->GetTerrain()->IsUnderWater(endPos.x, endPos.y, endPos.z)))
-                m_type = ((Creature*)m_sourceUnit)->CanSwim() ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
+            if ((startPoly == INVALID_POLYREF && m_startUnderWater) ||
+                    (endPoly == INVALID_POLYREF && m_endUnderWater))
+                m_type = m_canSwim ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
             else
-                m_type = ((Creature*)m_sourceUnit)->CanFly() ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
+                m_type = m_canFly ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
         }
         else
             m_type = PATHFIND_NOPATH;
@@ -190,21 +242,19 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: farFromPoly distToStartPoly=%.3f distToEndPoly=%.3f\n", distToStartPoly, distToEndPoly);
 
         bool buildShotrcut = false;
-        if (m_sourceUnit->GetTypeId() == TYPEID_UNIT)
+        if (m_sourceIsCreature)
         {
-            Creature* owner = (Creature*)m_sourceUnit;
-
-            Vector3 p = (distToStartPoly > 7.0f) ? startPos : endPos;
-            if (m_sourceUnit->GetTerrain()->IsUnderWater(p.x, p.y, p.z))
+            bool underWater = (distToStartPoly > 7.0f) ? m_startUnderWater : m_endUnderWater;
+            if (underWater)
             {
                 DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: underWater case\n");
-                if (owner->CanSwim())
+                if (m_canSwim)
                     buildShotrcut = true;
             }
             else
             {
                 DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: flying case\n");
-                if (owner->CanFly())
+                if (m_canFly)
                     buildShotrcut = true;
             }
         }
@@ -258,8 +308,10 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
     {
         for (pathStartIndex = 0; pathStartIndex < m_polyLength; ++pathStartIndex)
         {
-            // here to catch few bugs
-            MANGOS_ASSERT(m_pathPolyRefs[pathStartIndex] != INVALID_POLYREF || m_sourceUnit->PrintEntryError("PathFinder::BuildPolyPath"));
+            // here to catch few bugs, the owner may be gone when the pathfinding service calculates
+            if (m_pathPolyRefs[pathStartIndex] == INVALID_POLYREF)
+                sLog.outError("PathFinder::BuildPolyPath: invalid poly ref in the path of unit %u", m_sourceGuidLow);
+            MANGOS_ASSERT(m_pathPolyRefs[pathStartIndex] != INVALID_POLYREF);
 
             if (m_pathPolyRefs[pathStartIndex] == startPoly)
             {
@@ -344,7 +396,7 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
             // this is probably an error state, but we'll leave it
             // and hopefully recover on the next Update
             // we still need to copy our preffix
-            sLog.outError("%u's Path Build failed: 0 length path", m_sourceUnit->GetGUIDLow());
+            sLog.outError("%u's Path Build failed: 0 length path", m_sourceGuidLow);
         }
 
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++  m_polyLength=%u prefixPolyLength=%u suffixPolyLength=%u \n", m_polyLength, prefixPolyLength, suffixPolyLength);
@@ -376,7 +428,7 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         if (!m_polyLength || dtStatusFailed(dtResult))
         {
             // only happens if we passed bad data to findPath(), or navmesh is messed up
-            sLog.outError("%u's Path Build failed: 0 length path", m_sourceUnit->GetGUIDLow());
+            sLog.outError("%u's Path Build failed: 0 length path", m_sourceGuidLow);
             BuildShortcut();
             m_type = PATHFIND_NOPATH;
             return;
@@ -62,6 +62,18 @@ class PathFinder
         // return: true if new path was calculated, false otherwise (no change needed)
         bool calculate(float destX, float destY, float destZ, bool forceDest = false);
 
+        // Split calculate() for the pathfinding service: prepareCalculation() reads the owner and terrain
+        // and must run in the owner's map thread, calculatePrepared() only uses the given navmesh query
+        // return: true if calculatePrepared() is needed, false if the path is done already (shortcut)
+        bool prepareCalculation(float destX, float destY, float destZ, bool forceDest = false);
+        void calculatePrepared(const dtNavMeshQuery* navMeshQuery);
+
+        // take the path calculated by another PathFinder of the same kind of unit
+        void copyPath(const PathFinder& other);
+
+        // options and owner state the path depends on, together with start and destination
+        uint64 getRequestFlags() const;
+
         // option setters - use optional
         void setUseStrightPath(bool useStraightPath) { m_useStraightPath = useStraightPath; };
         void setPathLengthLimit(float distance) { m_pointPathLimit = std::min<uint32>(uint32(distance / SMOOTH_PATH_STEP_SIZE), MAX_POINT_PATH_LENGTH); };
@@ -90,12 +102,20 @@ class PathFinder
         Vector3        m_endPosition;      // {x, y, z} of the destination
         Vector3        m_actualEndPosition;// {x, y, z} of the closest possible point to given destination
 
-        const Unit* const       m_sourceUnit;       // the unit that is moving
+        const Unit* const       m_sourceUnit;       // the unit that is moving, not used by calculatePrepared()
+        uint32                  m_sourceGuidLow;    // for logs, the unit may be gone while the service calculates
         const dtNavMesh*        m_navMesh;          // the nav mesh
         const dtNavMeshQuery*   m_navMeshQuery;     // the nav mesh query used to find the path
 
         dtQueryFilter m_filter;                     // use single filter for all movements, update it when needed
 
+        // owner state used by BuildPolyPath(), taken in prepareCalculation()
+        bool m_sourceIsCreature;
+        bool m_canSwim;
+        bool m_canFly;
+        bool m_startUnderWater;
+        bool m_endUnderWater;
+
         void setStartPosition(const Vector3& point) { m_startPosition = point; }
         void setEndPosition(const Vector3& point) { m_actualEndPosition = point; m_endPosition = point; }
         void setActualEndPosition(const Vector3& point) { m_actualEndPosition = point; }
@@ -0,0 +1,213 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "PathfindingService.h"
+#include "PathFinder.h"
+#include "MoveMap.h"
+#include "Timer.h"
+
+#include <chrono>
+
+INSTANTIATE_SINGLETON_1(PathfindingService);
+
+/// Requests are refused (and calculated by the map thread) while this many wait for a service thread
+static const uint32 MAX_QUEUED_REQUESTS = 1024;
+/// Start and destination of requests sharing a path lie in the same cell of this size
+static const float REQUEST_POSITION_QUANTUM = 2.0f;
+
+PathRequest::~PathRequest()
+{
+    delete m_path;
+}
+
+bool PathfindingService::RequestKey::operator==(RequestKey const& other) const
+{
+    return mapId == other.mapId && instanceId == other.instanceId && flags == other.flags &&
+           start[0] == other.start[0] && start[1] == other.start[1] && start[2] == other.start[2] &&
+           end[0] == other.end[0] && end[1] == other.end[1] && end[2] == other.end[2];
+}
+
+size_t PathfindingService::RequestKeyHash::operator()(RequestKey const& key) const
+{
+    size_t hash = std::hash<uint64>()(key.flags);
+    uint32 const values[] = { key.mapId, key.instanceId, uint32(key.start[0]), uint32(key.start[1]), uint32(key.start[2]),
+                              uint32(key.end[0]), uint32(key.end[1]), uint32(key.end[2]) };
+    for (uint32 i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+        hash = hash * 31 + values[i];
+
+    return hash;
+}
+
+PathfindingService::PathfindingService() : m_cancel(false)
+{
+}
+
+PathfindingService::~PathfindingService()
+{
+    Deactivate();
+}
+
+void PathfindingService::Activate(uint32 numThreads)
+{
+    MANGOS_ASSERT(m_workers.empty());
+
+    m_cancel = false;
+    for (uint32 i = 0; i < numThreads; ++i)
+        m_workers.push_back(std::thread(&PathfindingService::WorkerThread, this));
+}
+
+void PathfindingService::Deactivate()
+{
+    if (m_workers.empty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_cancel = true;
+    }
+    m_requestCond.notify_all();
+
+    for (std::vector<std::thread>::iterator itr = m_workers.begin(); itr != m_workers.end(); ++itr)
+        itr->join();
+
+    m_workers.clear();
+
+    // requests left are never done, their movement generators are unloaded with the maps
+    m_queue.clear();
+    m_pending.clear();
+}
+
+void PathfindingService::MakeKey(RequestKey& key, uint32 mapId, uint32 instanceId, PathFinder const& path)
+{
+    Vector3 start = path.getStartPosition();
+    Vector3 end = path.getEndPosition();
+
+    key.mapId = mapId;
+    key.instanceId = instanceId;
+    key.start[0] = int32(floor(start.x / REQUEST_POSITION_QUANTUM));
+    key.start[1] = int32(floor(start.y / REQUEST_POSITION_QUANTUM));
+    key.start[2] = int32(floor(start.z / REQUEST_POSITION_QUANTUM));
+    key.end[0] = int32(floor(end.x / REQUEST_POSITION_QUANTUM));
+    key.end[1] = int32(floor(end.y / REQUEST_POSITION_QUANTUM));
+    key.end[2] = int32(floor(end.z / REQUEST_POSITION_QUANTUM));
+    key.flags = path.getRequestFlags();
+}
+
+PathRequestPtr PathfindingService::Request(uint32 mapId, uint32 instanceId, PathFinder* path)
+{
+    RequestKey key;
+    MakeKey(key, mapId, instanceId, *path);
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        PendingRequestMap::const_iterator itr = m_pending.find(key);
+        if (itr != m_pending.end())
+        {
+            ++m_stats.requested;
+            ++m_stats.shared;
+            delete path;
+            return itr->second;
+        }
+
+        if (m_queue.size() >= MAX_QUEUED_REQUESTS)
+            return PathRequestPtr();
+
+        PathRequestPtr request(new PathRequest(mapId, path, WorldTimer::getMSTime()));
+        m_pending[key] = request;
+        m_queue.push_back(std::make_pair(key, request));
+        ++m_stats.requested;
+
+        m_requestCond.notify_one();
+        return request;
+    }
+}
+
+void PathfindingService::GetStats(PathfindingStats& stats)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    stats = m_stats;
+    stats.queued = uint32(m_queue.size());
+}
+
+void PathfindingService::WorkerThread()
+{
+    // dtNavMeshQuery is not thread safe, every thread has its own per map
+    typedef std::unordered_map<uint32, std::pair<dtNavMesh const*, dtNavMeshQuery*> > NavMeshQueryMap;
+    NavMeshQueryMap queries;
+
+    for (;;)
+    {
+        std::pair<RequestKey, PathRequestPtr> request;
+
+        {
+            std::unique_lock<std::mutex> guard(m_lock);
+            m_requestCond.wait(guard, [this] { return m_cancel || !m_queue.empty(); });
+
+            if (m_cancel)
+                break;
+
+            request = m_queue.front();
+            m_queue.pop_front();
+        }
+
+        PathRequest& pathRequest = *request.second;
+        uint32 waitTime = WorldTimer::getMSTimeDiff(pathRequest.m_requestTime, WorldTimer::getMSTime());
+        std::chrono::steady_clock::time_point calcStart = std::chrono::steady_clock::now();
+
+        {
+            MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+            MMAP::NavMeshReadGuard navMeshGuard(mmap->GetNavMeshLock());
+
+            // the navmesh is gone when the map was unloaded meanwhile, it is a new one when the map was loaded again
+            dtNavMeshQuery* query = nullptr;
+            if (dtNavMesh const* navMesh = mmap->GetNavMesh(pathRequest.m_mapId))
+            {
+                std::pair<dtNavMesh const*, dtNavMeshQuery*>& entry = queries[pathRequest.m_mapId];
+                if (entry.first != navMesh)
+                {
+                    if (!entry.second)
+                        entry.second = dtAllocNavMeshQuery();
+
+                    entry.first = dtStatusSucceed(entry.second->init(navMesh, 1024)) ? navMesh : nullptr;
+                }
+
+                if (entry.first)
+                    query = entry.second;
+            }
+
+            pathRequest.m_path->calculatePrepared(query);
+        }
+
+        uint32 calcTime = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - calcStart).count());
+        pathRequest.m_done = true;
+
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        m_pending.erase(request.first);
+        ++m_stats.calculated;
+        m_stats.waitTime += waitTime;
+        m_stats.maxWaitTime = std::max(m_stats.maxWaitTime, waitTime);
+        m_stats.calcTime += calcTime;
+        m_stats.maxCalcTime = std::max(m_stats.maxCalcTime, calcTime);
+    }
+
+    for (NavMeshQueryMap::iterator itr = queries.begin(); itr != queries.end(); ++itr)
+        dtFreeNavMeshQuery(itr->second.second);
+}
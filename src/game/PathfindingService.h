@@ -0,0 +1,139 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PATHFINDINGSERVICE_H
+#define MANGOS_PATHFINDINGSERVICE_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class PathFinder;
+
+/// Counters since start
+struct PathfindingStats
+{
+    PathfindingStats() : requested(0), shared(0), calculated(0), waitTime(0), maxWaitTime(0), calcTime(0), maxCalcTime(0), queued(0) {}
+
+    uint64 requested;                                       // paths requested by movement generators
+    uint64 shared;                                          // requests answered by an equal request queued before
+    uint64 calculated;                                      // paths calculated by the service threads
+    uint64 waitTime;                                        // milliseconds requests waited in the queue
+    uint32 maxWaitTime;
+    uint64 calcTime;                                        // microseconds spent calculating paths
+    uint32 maxCalcTime;
+    uint32 queued;                                          // requests waiting for a service thread now
+
+    uint32 GetAverageWaitTime() const { return calculated ? uint32(waitTime / calculated) : 0; }
+    uint32 GetAverageCalcTime() const { return calculated ? uint32(calcTime / calculated) : 0; }
+};
+
+/// A path calculated by the pathfinding service, shared by the movement generators which requested it
+class PathRequest
+{
+    public:
+        PathRequest(uint32 mapId, PathFinder* path, uint32 requestTime) :
+            m_mapId(mapId), m_path(path), m_requestTime(requestTime), m_done(false) {}
+        ~PathRequest();
+
+        /// The path can be used by the map thread once this returns true
+        bool IsDone() const { return m_done; }
+        PathFinder const& GetPath() const { return *m_path; }
+
+    private:
+        friend class PathfindingService;
+
+        uint32 m_mapId;
+        PathFinder* m_path;
+        uint32 m_requestTime;
+        std::atomic<bool> m_done;
+};
+
+typedef std::shared_ptr<PathRequest> PathRequestPtr;
+
+/**
+ * Calculates the navmesh part of paths for movement generators in a pool of threads.
+ *
+ * The map thread prepares the PathFinder (owner position, filter, terrain checks) and queues it,
+ * the service threads run the detour queries with a dtNavMeshQuery of their own and the movement
+ * generator picks the path up in its next update. Requests with the same start and destination
+ * (rounded) and the same options as a request still waiting or being calculated share its result,
+ * so a pack of mobs chasing the same target costs one calculation.
+ */
+class PathfindingService
+{
+    public:
+        PathfindingService();
+        ~PathfindingService();
+
+        void Activate(uint32 numThreads);
+        void Deactivate();
+
+        bool IsActive() const { return !m_workers.empty(); }
+
+        /// Queue a path prepared by PathFinder::prepareCalculation(), the service owns the PathFinder from now on.
+        /// Returns nullptr when the queue is full, the caller keeps the PathFinder and calculates the path itself.
+        PathRequestPtr Request(uint32 mapId, uint32 instanceId, PathFinder* path);
+
+        void GetStats(PathfindingStats& stats);
+
+    private:
+        struct RequestKey
+        {
+            uint32 mapId;
+            uint32 instanceId;
+            int32 start[3];
+            int32 end[3];
+            uint64 flags;
+
+            bool operator==(RequestKey const& other) const;
+        };
+
+        struct RequestKeyHash
+        {
+            size_t operator()(RequestKey const& key) const;
+        };
+
+        typedef std::unordered_map<RequestKey, PathRequestPtr, RequestKeyHash> PendingRequestMap;
+
+        static void MakeKey(RequestKey& key, uint32 mapId, uint32 instanceId, PathFinder const& path);
+
+        void WorkerThread();
+
+        std::mutex m_lock;
+        std::condition_variable m_requestCond;
+        std::vector<std::thread> m_workers;
+        bool m_cancel;
+
+        std::deque<std::pair<RequestKey, PathRequestPtr> > m_queue;
+        PendingRequestMap m_pending;                        // queued or being calculated
+
+        PathfindingStats m_stats;
+};
+
+#define sPathfindingService MaNGOS::Singleton<PathfindingService>::Instance()
+
+#endif
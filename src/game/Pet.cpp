@@ -252,7 +252,7 @@ bool Pet::LoadPetFromDB(Player* owner, uint32 petentry, uint32 petnumber, bool c
     // PET_SAVE_NOT_IN_SLOT(100) = not stable slot (summoning))
     if (fields[7].GetUInt32() != 0)
     {
-        CharacterDatabase.BeginTransaction();
+        CharacterDatabase.BeginTransaction(owner->GetGUIDLow());
 
         static SqlStatementID id_1;
         static SqlStatementID id_2;
@@ -395,8 +395,8 @@ void Pet::SavePetToDB(PetSaveMode mode)
         if (mode != PET_SAVE_AS_CURRENT)
             RemoveAllAuras();
 
-        // save pet's data as one single transaction
-        CharacterDatabase.BeginTransaction();
+        // save pet's data as one single transaction, ordered with owner saves
+        CharacterDatabase.BeginTransaction(pOwner->GetGUIDLow());
         _SaveSpells();
         _SaveSpellCooldowns();
         _SaveAuras();
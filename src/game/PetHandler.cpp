@@ -525,7 +525,7 @@ void WorldSession::HandlePetRename(WorldPacket& recv_data)
         }
     }
 
-    CharacterDatabase.BeginTransaction();
+    CharacterDatabase.BeginTransaction(_player->GetGUIDLow());
     if (isdeclined)
     {
         for (int i = 0; i < MAX_DECLINED_NAME_CASES; ++i)
@@ -472,6 +472,8 @@ Player::Player(WorldSession* session): Unit(), m_mover(this), m_camera(this), m_
 
     m_DailyQuestChanged = false;
     m_WeeklyQuestChanged = false;
+    m_spellCooldownsChanged = false;
+    m_characterRowExists = false;
 
     m_lastLiquid = nullptr;
 
@@ -2022,6 +2024,8 @@ void Player::AddToWorld()
     ///- The player should only be added when logging in
     Unit::AddToWorld();
 
+    sMapMgr.RequestMaxPlayerLevelUpdate();
+
     for (int i = PLAYER_SLOT_START; i < PLAYER_SLOT_END; ++i)
     {
         if (m_items[i])
@@ -2041,7 +2045,10 @@ void Player::RemoveFromWorld()
     ///- It will crash when updating the ObjectAccessor
     ///- The player should only be removed when logging out
     if (IsInWorld())
+    {
         GetCamera().ResetView();
+        sMapMgr.RequestMaxPlayerLevelUpdate();
+    }
 
     Unit::RemoveFromWorld();
 }
@@ -3615,7 +3622,8 @@ void Player::removeSpell(uint32 spell_id, bool disabled, bool learn_low_rank, bo
 
 void Player::RemoveSpellCooldown(uint32 spell_id, bool update /* = false */)
 {
-    m_spellCooldowns.erase(spell_id);
+    if (m_spellCooldowns.erase(spell_id))
+        m_spellCooldownsChanged = true;
 
     if (update)
         SendClearCooldown(spell_id, this);
@@ -3666,6 +3674,7 @@ void Player::RemoveAllSpellCooldown()
             SendClearCooldown(itr->first, this);
 
         m_spellCooldowns.clear();
+        m_spellCooldownsChanged = true;
     }
 }
 
@@ -3709,6 +3718,10 @@ void Player::_LoadSpellCooldowns(QueryResult* result)
 
 void Player::_SaveSpellCooldowns()
 {
+    // outdated cooldowns left in the table are skipped at load
+    if (!m_spellCooldownsChanged)
+        return;
+
     static SqlStatementID deleteSpellCooldown ;
     static SqlStatementID insertSpellCooldown ;
 
@@ -3732,6 +3745,8 @@ void Player::_SaveSpellCooldowns()
         else
             ++itr;
     }
+
+    m_spellCooldownsChanged = false;
 }
 
 uint32 Player::resetTalentsCost() const
@@ -4305,6 +4320,7 @@ void Player::DeleteFromDB(ObjectGuid playerguid, uint32 accountId, bool updateRe
             QueryResult* resultFriend = CharacterDatabase.PQuery("SELECT DISTINCT guid FROM character_social WHERE friend = '%u'", lowguid);
 
             // NOW we can finally clear other DB data related to character
+            // no shard key: friend lists of other characters are changed too
             CharacterDatabase.BeginTransaction();
             if (resultPets)
             {
@@ -15171,6 +15187,8 @@ bool Player::LoadFromDB(ObjectGuid guid, SqlQueryHolder* holder)
         return false;
     }
 
+    m_characterRowExists = true;
+
     Field* fields = result->Fetch();
 
     uint32 dbAccountId = fields[1].GetUInt32();
@@ -16958,15 +16976,30 @@ void Player::SaveToDB()
     DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_STATS, "The value of player %s at save: ", m_name.c_str());
     outDebugStatsValues();
 
-    CharacterDatabase.BeginTransaction();
+    // same shard as login queries and other saves of this character, keeps them ordered
+    CharacterDatabase.BeginTransaction(GetGUIDLow());
 
     static SqlStatementID delChar ;
     static SqlStatementID insChar ;
+    static SqlStatementID updChar ;
 
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delChar, "DELETE FROM characters WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
+    // the row is recreated only for a new character, later saves update it in place
+    if (!m_characterRowExists)
+    {
+        SqlStatement stmt = CharacterDatabase.CreateStatement(delChar, "DELETE FROM characters WHERE guid = ?");
+        stmt.PExecute(GetGUIDLow());
+    }
 
-    SqlStatement uberInsert = CharacterDatabase.CreateStatement(insChar, "INSERT INTO characters (guid,account,name,race,class,gender,level,xp,money,playerBytes,playerBytes2,playerFlags,"
+    SqlStatement uberSave = m_characterRowExists ?
+                            CharacterDatabase.CreateStatement(updChar, "UPDATE characters SET account = ?, name = ?, race = ?, class = ?, gender = ?, level = ?, xp = ?, money = ?, "
+                              "playerBytes = ?, playerBytes2 = ?, playerFlags = ?, map = ?, dungeon_difficulty = ?, position_x = ?, position_y = ?, position_z = ?, "
+                              "orientation = ?, taximask = ?, online = ?, cinematic = ?, totaltime = ?, leveltime = ?, rest_bonus = ?, logout_time = ?, "
+                              "is_logout_resting = ?, resettalents_cost = ?, resettalents_time = ?, trans_x = ?, trans_y = ?, trans_z = ?, trans_o = ?, transguid = ?, "
+                              "extra_flags = ?, stable_slots = ?, at_login = ?, zone = ?, death_expire_time = ?, taxi_path = ?, arenaPoints = ?, totalHonorPoints = ?, "
+                              "todayHonorPoints = ?, yesterdayHonorPoints = ?, totalKills = ?, todayKills = ?, yesterdayKills = ?, chosenTitle = ?, knownCurrencies = ?, watchedFaction = ?, "
+                              "drunk = ?, health = ?, power1 = ?, power2 = ?, power3 = ?, power4 = ?, power5 = ?, power6 = ?, "
+                              "power7 = ?, specCount = ?, activeSpec = ?, exploredZones = ?, equipmentCache = ?, ammoId = ?, knownTitles = ?, actionBars = ? WHERE guid = ?")
+                            : CharacterDatabase.CreateStatement(insChar, "INSERT INTO characters (guid,account,name,race,class,gender,level,xp,money,playerBytes,playerBytes2,playerFlags,"
                               "map, dungeon_difficulty, position_x, position_y, position_z, orientation, "
                               "taximask, online, cinematic, "
                               "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost, resettalents_time, "
@@ -16983,159 +17016,184 @@ void Player::SaveToDB()
                               "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
                               "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?) ");
 
-    uberInsert.addUInt32(GetGUIDLow());
-    uberInsert.addUInt32(GetSession()->GetAccountId());
-    uberInsert.addString(m_name);
-    uberInsert.addUInt8(getRace());
-    uberInsert.addUInt8(getClass());
-    uberInsert.addUInt8(getGender());
-    uberInsert.addUInt32(getLevel());
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_XP));
-    uberInsert.addUInt32(GetMoney());
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_BYTES));
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_BYTES_2));
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FLAGS));
+    if (!m_characterRowExists)
+        uberSave.addUInt32(GetGUIDLow());
+    uberSave.addUInt32(GetSession()->GetAccountId());
+    uberSave.addString(m_name);
+    uberSave.addUInt8(getRace());
+    uberSave.addUInt8(getClass());
+    uberSave.addUInt8(getGender());
+    uberSave.addUInt32(getLevel());
+    uberSave.addUInt32(GetUInt32Value(PLAYER_XP));
+    uberSave.addUInt32(GetMoney());
+    uberSave.addUInt32(GetUInt32Value(PLAYER_BYTES));
+    uberSave.addUInt32(GetUInt32Value(PLAYER_BYTES_2));
+    uberSave.addUInt32(GetUInt32Value(PLAYER_FLAGS));
 
     if (!IsBeingTeleported())
     {
-        uberInsert.addUInt32(GetMapId());
-        uberInsert.addUInt32(uint32(GetDungeonDifficulty()));
-        uberInsert.addFloat(finiteAlways(GetPositionX()));
-        uberInsert.addFloat(finiteAlways(GetPositionY()));
-        uberInsert.addFloat(finiteAlways(GetPositionZ()));
-        uberInsert.addFloat(finiteAlways(GetOrientation()));
+        uberSave.addUInt32(GetMapId());
+        uberSave.addUInt32(uint32(GetDungeonDifficulty()));
+        uberSave.addFloat(finiteAlways(GetPositionX()));
+        uberSave.addFloat(finiteAlways(GetPositionY()));
+        uberSave.addFloat(finiteAlways(GetPositionZ()));
+        uberSave.addFloat(finiteAlways(GetOrientation()));
     }
     else
     {
-        uberInsert.addUInt32(GetTeleportDest().mapid);
-        uberInsert.addUInt32(uint32(GetDungeonDifficulty()));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_x));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_y));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_z));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().orientation));
+        uberSave.addUInt32(GetTeleportDest().mapid);
+        uberSave.addUInt32(uint32(GetDungeonDifficulty()));
+        uberSave.addFloat(finiteAlways(GetTeleportDest().coord_x));
+        uberSave.addFloat(finiteAlways(GetTeleportDest().coord_y));
+        uberSave.addFloat(finiteAlways(GetTeleportDest().coord_z));
+        uberSave.addFloat(finiteAlways(GetTeleportDest().orientation));
     }
 
     std::ostringstream ss;
     ss << m_taxi;                                   // string with TaxiMaskSize numbers
-    uberInsert.addString(ss);
+    uberSave.addString(ss);
 
-    uberInsert.addUInt32(IsInWorld() ? 1 : 0);
+    uberSave.addUInt32(IsInWorld() ? 1 : 0);
 
-    uberInsert.addUInt32(m_cinematic);
+    uberSave.addUInt32(m_cinematic);
 
-    uberInsert.addUInt32(m_Played_time[PLAYED_TIME_TOTAL]);
-    uberInsert.addUInt32(m_Played_time[PLAYED_TIME_LEVEL]);
+    uberSave.addUInt32(m_Played_time[PLAYED_TIME_TOTAL]);
+    uberSave.addUInt32(m_Played_time[PLAYED_TIME_LEVEL]);
 
-    uberInsert.addFloat(finiteAlways(m_rest_bonus));
-    uberInsert.addUInt64(uint64(time(nullptr)));
-    uberInsert.addUInt32(HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_RESTING) ? 1 : 0);
+    uberSave.addFloat(finiteAlways(m_rest_bonus));
+    uberSave.addUInt64(uint64(time(nullptr)));
+    uberSave.addUInt32(HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_RESTING) ? 1 : 0);
     // save, far from tavern/city
     // save, but in tavern/city
-    uberInsert.addUInt32(m_resetTalentsCost);
-    uberInsert.addUInt64(uint64(m_resetTalentsTime));
+    uberSave.addUInt32(m_resetTalentsCost);
+    uberSave.addUInt64(uint64(m_resetTalentsTime));
 
     Position const* transportPosition = m_movementInfo.GetTransportPos();
-    uberInsert.addFloat(finiteAlways(transportPosition->x));
-    uberInsert.addFloat(finiteAlways(transportPosition->y));
-    uberInsert.addFloat(finiteAlways(transportPosition->z));
-    uberInsert.addFloat(finiteAlways(transportPosition->o));
+    uberSave.addFloat(finiteAlways(transportPosition->x));
+    uberSave.addFloat(finiteAlways(transportPosition->y));
+    uberSave.addFloat(finiteAlways(transportPosition->z));
+    uberSave.addFloat(finiteAlways(transportPosition->o));
 
     if (m_transport)
-        uberInsert.addUInt32(m_transport->GetGUIDLow());
+        uberSave.addUInt32(m_transport->GetGUIDLow());
     else
-        uberInsert.addUInt32(0);
+        uberSave.addUInt32(0);
 
-    uberInsert.addUInt32(m_ExtraFlags);
+    uberSave.addUInt32(m_ExtraFlags);
 
-    uberInsert.addUInt32(uint32(m_stableSlots));            // to prevent save uint8 as char
+    uberSave.addUInt32(uint32(m_stableSlots));            // to prevent save uint8 as char
 
-    uberInsert.addUInt32(uint32(m_atLoginFlags));
+    uberSave.addUInt32(uint32(m_atLoginFlags));
 
-    uberInsert.addUInt32(IsInWorld() ? GetZoneId() : GetCachedZoneId());
+    uberSave.addUInt32(IsInWorld() ? GetZoneId() : GetCachedZoneId());
 
-    uberInsert.addUInt64(uint64(m_deathExpireTime));
+    uberSave.addUInt64(uint64(m_deathExpireTime));
 
     ss << m_taxi.SaveTaxiDestinationsToString();       // string
-    uberInsert.addString(ss);
+    uberSave.addString(ss);
 
-    uberInsert.addUInt32(GetArenaPoints());
+    uberSave.addUInt32(GetArenaPoints());
 
-    uberInsert.addUInt32(GetHonorPoints());
+    uberSave.addUInt32(GetHonorPoints());
 
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FIELD_TODAY_CONTRIBUTION));
+    uberSave.addUInt32(GetUInt32Value(PLAYER_FIELD_TODAY_CONTRIBUTION));
 
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FIELD_YESTERDAY_CONTRIBUTION));
+    uberSave.addUInt32(GetUInt32Value(PLAYER_FIELD_YESTERDAY_CONTRIBUTION));
 
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FIELD_LIFETIME_HONORBALE_KILLS));
+    uberSave.addUInt32(GetUInt32Value(PLAYER_FIELD_LIFETIME_HONORBALE_KILLS));
 
-    uberInsert.addUInt16(GetUInt16Value(PLAYER_FIELD_KILLS, 0));
+    uberSave.addUInt16(GetUInt16Value(PLAYER_FIELD_KILLS, 0));
 
-    uberInsert.addUInt16(GetUInt16Value(PLAYER_FIELD_KILLS, 1));
+    uberSave.addUInt16(GetUInt16Value(PLAYER_FIELD_KILLS, 1));
 
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_CHOSEN_TITLE));
+    uberSave.addUInt32(GetUInt32Value(PLAYER_CHOSEN_TITLE));
 
-    uberInsert.addUInt64(GetUInt64Value(PLAYER_FIELD_KNOWN_CURRENCIES));
+    uberSave.addUInt64(GetUInt64Value(PLAYER_FIELD_KNOWN_CURRENCIES));
 
     // FIXME: at this moment send to DB as unsigned, including unit32(-1)
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FIELD_WATCHED_FACTION_INDEX));
+    uberSave.addUInt32(GetUInt32Value(PLAYER_FIELD_WATCHED_FACTION_INDEX));
 
-    uberInsert.addUInt8(GetDrunkValue());
+    uberSave.addUInt8(GetDrunkValue());
 
-    uberInsert.addUInt32(GetHealth());
+    uberSave.addUInt32(GetHealth());
 
     for (uint32 i = 0; i < MAX_POWERS; ++i)
-        uberInsert.addUInt32(GetPower(Powers(i)));
+        uberSave.addUInt32(GetPower(Powers(i)));
 
-    uberInsert.addUInt32(uint32(m_specsCount));
-    uberInsert.addUInt32(uint32(m_activeSpec));
+    uberSave.addUInt32(uint32(m_specsCount));
+    uberSave.addUInt32(uint32(m_activeSpec));
 
     for (uint32 i = 0; i < PLAYER_EXPLORED_ZONES_SIZE; ++i) // string
     {
         ss << GetUInt32Value(PLAYER_EXPLORED_ZONES_1 + i) << " ";
     }
-    uberInsert.addString(ss);
+    uberSave.addString(ss);
 
     for (uint32 i = 0; i < EQUIPMENT_SLOT_END * 2; ++i)     // string
     {
         ss << GetUInt32Value(PLAYER_VISIBLE_ITEM_1_ENTRYID + i) << " ";
     }
-    uberInsert.addString(ss);
+    uberSave.addString(ss);
 
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_AMMO_ID));
+    uberSave.addUInt32(GetUInt32Value(PLAYER_AMMO_ID));
 
     for (uint32 i = 0; i < KNOWN_TITLES_SIZE * 2; ++i)      // string
     {
         ss << GetUInt32Value(PLAYER__FIELD_KNOWN_TITLES + i) << " ";
     }
-    uberInsert.addString(ss);
+    uberSave.addString(ss);
+
+    uberSave.addUInt32(uint32(GetByteValue(PLAYER_FIELD_BYTES, 2)));
 
-    uberInsert.addUInt32(uint32(GetByteValue(PLAYER_FIELD_BYTES, 2)));
+    if (m_characterRowExists)
+        uberSave.addUInt32(GetGUIDLow());
 
-    uberInsert.Execute();
+    uberSave.Execute();
+    m_characterRowExists = true;
+
+    // statements written by each part, the _Save* functions skip unchanged data
+    uint32 savedTotal = 0;
+    auto savedSince = [&savedTotal]()
+    {
+        uint32 total = CharacterDatabase.GetTransactionSize();
+        uint32 count = total - savedTotal;
+        savedTotal = total;
+        return count;
+    };
+    uint32 savedCharacter = savedSince();
 
     if (m_mailsUpdated)                                     // save mails only when needed
         _SaveMail();
 
     _SaveBGData();
     _SaveInventory();
+    uint32 savedInventory = savedSince();
     _SaveQuestStatus();
     _SaveDailyQuestStatus();
     _SaveWeeklyQuestStatus();
     _SaveMonthlyQuestStatus();
+    uint32 savedQuests = savedSince();
     _SaveSpells();
     _SaveSpellCooldowns();
     _SaveActions();
     _SaveAuras();
     _SaveSkills();
+    uint32 savedSpells = savedSince();
     m_achievementMgr.SaveToDB();
+    uint32 savedAchievements = savedSince();
     m_reputationMgr.SaveToDB();
+    uint32 savedReputation = savedSince();
     _SaveEquipmentSets();
     GetSession()->SaveTutorialsData();                      // changed only while character in game
     _SaveGlyphs();
     _SaveTalents();
+    uint32 savedOther = savedSince();
 
     CharacterDatabase.CommitTransaction();
 
+    DETAIL_FILTER_LOG(LOG_FILTER_PLAYER_STATS, "Player %s saved with %u statements: character %u, inventory %u, quests %u, spells %u, achievements %u, reputation %u, other %u",
+                      m_name.c_str(), savedTotal, savedCharacter, savedInventory, savedQuests, savedSpells, savedAchievements, savedReputation, savedOther);
+
     // check if stats should only be saved on logout
     // save stats can be out of transaction
     if (m_session->isLogingOut() || !sWorld.getConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT))
@@ -19276,6 +19334,7 @@ void Player::AddSpellCooldown(uint32 spellid, uint32 itemid, time_t end_time)
     sc.end = end_time;
     sc.itemid = itemid;
     m_spellCooldowns[spellid] = sc;
+    m_spellCooldownsChanged = true;
 }
 
 void Player::SendCooldownEvent(SpellEntry const* spellInfo, uint32 itemId, Spell* spell)
@@ -20549,7 +20608,7 @@ void Player::AutoUnequipOffhandIfNeed()
     else
     {
         MoveItemFromInventory(INVENTORY_SLOT_BAG_0, EQUIPMENT_SLOT_OFFHAND, true);
-        CharacterDatabase.BeginTransaction();
+        CharacterDatabase.BeginTransaction(GetGUIDLow());
         offItem->DeleteFromInventoryDB();                   // deletes item from character's inventory
         offItem->SaveToDB();                                // recursive and not have transaction guard into self, item not in inventory and can be save standalone
         CharacterDatabase.CommitTransaction();
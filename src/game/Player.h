@@ -2507,6 +2507,8 @@ class MANGOS_DLL_SPEC Player : public Unit
         bool   m_DailyQuestChanged;
         bool   m_WeeklyQuestChanged;
         bool   m_MonthlyQuestChanged;
+        bool   m_spellCooldownsChanged;                     // m_spellCooldowns differs from character_spell_cooldown
+        bool   m_characterRowExists;                        // `characters` row can be updated in place at save
 
         uint32 m_drunkTimer;
         uint32 m_weaponChangeTimer;
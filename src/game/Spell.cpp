@@ -445,6 +445,8 @@ void Spell::FillTargetMap()
 {
     // TODO: ADD the correct target FILLS!!!!!!
 
+    m_targetLOS.clear();
+
     UnitList tmpUnitLists[MAX_EFFECT_INDEX];                // Stores the temporary Target Lists for each effect
     uint8 effToIndex[MAX_EFFECT_INDEX] = {0, 1, 2};         // Helper array, to link to another tmpUnitList, if the targets for both effects match
     for (int i = 0; i < MAX_EFFECT_INDEX; ++i)
@@ -711,6 +713,8 @@ void Spell::FillTargetMap()
         for (UnitList::const_iterator iunit = tmpUnitLists[effToIndex[i]].begin(); iunit != tmpUnitLists[effToIndex[i]].end(); ++iunit)
             AddUnitTarget((*iunit), SpellEffectIndex(i));
     }
+
+    m_targetLOS.clear();
 }
 
 void Spell::prepareDataForTriggerSystem()
@@ -7207,7 +7211,7 @@ bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff)
             // Get GO cast coordinates if original caster -> GO
             if (target != m_caster)
                 if (WorldObject* caster = GetCastingObject())
-                    if (!m_spellInfo->HasAttribute(SPELL_ATTR_EX2_IGNORE_LOS) && !target->IsWithinLOSInMap(caster))
+                    if (!m_spellInfo->HasAttribute(SPELL_ATTR_EX2_IGNORE_LOS) && !IsTargetWithinLOS(target, caster))
                         return false;
             break;
     }
@@ -7234,6 +7238,15 @@ bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff)
     return true;
 }
 
+bool Spell::IsTargetWithinLOS(Unit* target, WorldObject* caster) const
+{
+    TargetLOSMap::const_iterator itr = m_targetLOS.find(target->GetObjectGuid());
+    if (itr != m_targetLOS.end())
+        return itr->second;
+
+    return target->IsWithinLOSInMap(caster);
+}
+
 bool Spell::IsNeedSendToClient() const
 {
     return m_spellInfo->SpellVisual[0] || m_spellInfo->SpellVisual[1] || IsChanneledSpell(m_spellInfo) ||
@@ -7458,6 +7471,53 @@ void Spell::FillAreaTargets(UnitList& targetUnitMap, float radius, SpellNotifyPu
 {
     MaNGOS::SpellNotifierCreatureAndPlayer notifier(*this, targetUnitMap, radius, pushType, spellTargets, originalCaster);
     Cell::VisitAllObjects(notifier.GetCenterX(), notifier.GetCenterY(), m_caster->GetMap(), notifier, radius);
+
+    if (!m_spellInfo->HasAttribute(SPELL_ATTR_EX2_IGNORE_LOS))
+        FillTargetsLOS(targetUnitMap);
+}
+
+/// Checks the line of sight of all area targets to the casting object together, the results are used by CheckTarget()
+void Spell::FillTargetsLOS(UnitList const& targetUnitMap)
+{
+    WorldObject* caster = GetCastingObject();
+    if (!caster || !caster->IsInWorld())
+        return;
+
+    std::vector<VMAP::LineOfSightQuery> queries;
+    std::vector<ObjectGuid> targets;
+    queries.reserve(targetUnitMap.size());
+    targets.reserve(targetUnitMap.size());
+
+    float x, y, z;
+    caster->GetPosition(x, y, z);
+    for (UnitList::const_iterator itr = targetUnitMap.begin(); itr != targetUnitMap.end(); ++itr)
+    {
+        Unit* target = *itr;
+        // same test as target->IsWithinLOSInMap(caster), other phases are checked one by one
+        if (target == m_caster || !target->IsInMap(caster) || target->GetPhaseMask() != caster->GetPhaseMask())
+            continue;
+
+        if (m_targetLOS.find(target->GetObjectGuid()) != m_targetLOS.end())
+            continue;
+
+        VMAP::LineOfSightQuery query;
+        target->GetPosition(query.x1, query.y1, query.z1);
+        query.z1 += 2.0f;
+        query.x2 = x;
+        query.y2 = y;
+        query.z2 = z + 2.0f;
+        queries.push_back(query);
+        targets.push_back(target->GetObjectGuid());
+    }
+
+    // a single target is checked by CheckTarget() as usual
+    if (queries.size() < 2)
+        return;
+
+    caster->GetMap()->IsInLineOfSight(&queries[0], queries.size(), caster->GetPhaseMask());
+
+    for (size_t i = 0; i < queries.size(); ++i)
+        m_targetLOS[targets[i]] = queries[i].result;
 }
 
 void Spell::FillRaidOrPartyTargets(UnitList& targetUnitMap, Unit* member, Unit* center, float radius, bool raid, bool withPets, bool withcaster)
@@ -20,6 +20,7 @@
 #include "ByteBuffer.h"
 #include "Errors.h"
 #include "PathFinder.h"
+#include "PathfindingService.h"
 #include "Unit.h"
 #include "Creature.h"
 #include "Player.h"
@@ -77,7 +78,37 @@ void TargetedMovementGeneratorMedium<T, D>::_setTargetLocation(T& owner, bool up
     // allow pets following their master to cheat while generating paths
     bool forceDest = (owner.GetTypeId() == TYPEID_UNIT && ((Creature*)&owner)->IsPet()
                       && owner.hasUnitState(UNIT_STAT_FOLLOW));
+
+    // the pathfinding service calculates the path in one of its threads, Update() moves along it once it is done
+    if (sPathfindingService.IsActive())
+    {
+        PathFinder* path = new PathFinder(*i_path);
+        if (!path->prepareCalculation(x, y, z, forceDest))
+        {
+            // shortcut, no navmesh needed
+            i_path->copyPath(*path);
+            delete path;
+            _moveAlongPath(owner);
+            return;
+        }
+
+        if (PathRequestPtr request = sPathfindingService.Request(owner.GetMapId(), owner.GetInstanceId(), path))
+        {
+            i_pathRequest = request;
+            return;
+        }
+
+        // the service is busy, calculate it here
+        delete path;
+    }
+
     i_path->calculate(x, y, z, forceDest);
+    _moveAlongPath(owner);
+}
+
+template<class T, typename D>
+void TargetedMovementGeneratorMedium<T, D>::_moveAlongPath(T& owner)
+{
     if (i_path->getPathType() & PATHFIND_NOPATH)
         return;
 
@@ -127,6 +158,14 @@ bool TargetedMovementGeneratorMedium<T, D>::Update(T& owner, const uint32& time_
         return true;
     }
 
+    // path requested in an earlier update, no new path is requested before it is done
+    if (i_pathRequest && i_pathRequest->IsDone())
+    {
+        i_path->copyPath(i_pathRequest->GetPath());
+        i_pathRequest.reset();
+        _moveAlongPath(owner);
+    }
+
     bool targetMoved = false;
     i_recheckDistance.Update(time_diff);
     if (i_recheckDistance.Passed())
@@ -136,7 +175,7 @@ bool TargetedMovementGeneratorMedium<T, D>::Update(T& owner, const uint32& time_
         targetMoved = RequiresNewPosition(owner, dest.x, dest.y, dest.z);
     }
 
-    if (m_speedChanged || targetMoved)
+    if ((m_speedChanged || targetMoved) && !i_pathRequest)
         _setTargetLocation(owner, targetMoved);
 
     if (owner.movespline->Finalized())
@@ -22,7 +22,10 @@
 #include "MovementGenerator.h"
 #include "FollowerReference.h"
 
+#include <memory>
+
 class PathFinder;
+class PathRequest;
 
 class MANGOS_DLL_SPEC TargetedMovementGeneratorBase
 {
@@ -59,6 +62,7 @@ class MANGOS_DLL_SPEC TargetedMovementGeneratorMedium
 
     protected:
         void _setTargetLocation(T&, bool updateDestination);
+        void _moveAlongPath(T&);
         bool RequiresNewPosition(T& owner, float x, float y, float z) const;
         virtual float GetDynamicTargetDistance(T& /*owner*/, bool /*forRangeCheck*/) const { return i_offset; }
 
@@ -69,6 +73,7 @@ class MANGOS_DLL_SPEC TargetedMovementGeneratorMedium
         bool i_targetReached : 1;
 
         PathFinder* i_path;
+        std::shared_ptr<PathRequest> i_pathRequest;         // path calculated by the pathfinding service, moved along once done
 };
 
 template<class T>
@@ -0,0 +1,68 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "UpdateBlockCache.h"
+#include "Object.h"
+
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#  define UPDATEBLOCK_THREAD_LOCAL __declspec(thread)
+#else
+#  define UPDATEBLOCK_THREAD_LOCAL thread_local
+#endif
+
+static UPDATEBLOCK_THREAD_LOCAL UpdateBlockCache* s_currentCache = nullptr;
+
+void UpdateBlockCache::Begin()
+{
+    MANGOS_ASSERT(!s_currentCache && "UpdateBlockCache nested on one thread");
+    s_currentCache = this;
+}
+
+void UpdateBlockCache::End()
+{
+    s_currentCache = nullptr;
+    m_entries.clear();
+}
+
+UpdateBlockCache::Entry const* UpdateBlockCache::Find(Object const* object) const
+{
+    std::unordered_map<ObjectGuid, Entry>::const_iterator itr = m_entries.find(object->GetObjectGuid());
+    if (itr == m_entries.end())
+        return nullptr;
+
+    // a new object with the same guid, or values changed after the entry was built
+    if (itr->second.object != object || itr->second.valuesVersion != object->GetValuesVersion())
+        return nullptr;
+
+    return &itr->second;
+}
+
+UpdateBlockCache::Entry& UpdateBlockCache::Store(Object const* object)
+{
+    Entry& entry = m_entries[object->GetObjectGuid()];
+    entry.object = object;
+    entry.valuesVersion = object->GetValuesVersion();
+    entry.values.clear();
+    entry.viewerFields.clear();
+    return entry;
+}
+
+UpdateBlockCache* UpdateBlockCache::Current()
+{
+    return s_currentCache;
+}
@@ -0,0 +1,91 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_UPDATEBLOCKCACHE_H
+#define MANGOS_UPDATEBLOCKCACHE_H
+
+#include "Common.h"
+#include "ByteBuffer.h"
+#include "ObjectGuid.h"
+
+#include <unordered_map>
+#include <vector>
+
+class Object;
+
+/**
+ * Serialized update field values of create blocks, shared by all viewers of an object.
+ *
+ * Create blocks of an object for other players only differ in a few viewer dependent fields
+ * (npc flags, dynamic flags, ...). Its values are serialized once for the first viewer, every
+ * further viewer copies them and writes its own value of those fields. Blocks for the object
+ * itself are never shared, there is only one such viewer.
+ *
+ * A cache is bound to the thread updating a map or the world sessions, like BroadcastBatch, and
+ * entries are used only while the values of their object did not change.
+ */
+class UpdateBlockCache
+{
+    public:
+        /// Viewer dependent fields of the cached values as field index and offset in the values
+        typedef std::vector<std::pair<uint16, size_t> > ViewerFieldList;
+
+        struct Entry
+        {
+            Entry() : object(nullptr), valuesVersion(0) {}
+
+            Object const* object;
+            uint32 valuesVersion;
+            ByteBuffer values;                              // update mask and field values as in a create block
+            ViewerFieldList viewerFields;
+        };
+
+        UpdateBlockCache() {}
+
+        /// Share create blocks built by the calling thread until End()
+        void Begin();
+        void End();
+
+        /// Cached values of the object, nullptr if there are none or they changed since
+        Entry const* Find(Object const* object) const;
+
+        /// Empty entry for the object, to be filled by the caller
+        Entry& Store(Object const* object);
+
+        /// Cache bound to the calling thread, nullptr outside of map and session updates
+        static UpdateBlockCache* Current();
+
+    private:
+        std::unordered_map<ObjectGuid, Entry> m_entries;
+};
+
+/// Binds a cache to the calling thread for the lifetime of the guard
+class UpdateBlockCacheGuard
+{
+    public:
+        explicit UpdateBlockCacheGuard(UpdateBlockCache& cache) : m_cache(cache) { m_cache.Begin(); }
+        ~UpdateBlockCacheGuard() { m_cache.End(); }
+
+    private:
+        UpdateBlockCacheGuard(UpdateBlockCacheGuard const&);
+        UpdateBlockCacheGuard& operator=(UpdateBlockCacheGuard const&);
+
+        UpdateBlockCache& m_cache;
+};
+
+#endif
@@ -26,6 +26,11 @@
 #include "ObjectGuid.h"
 #include <zlib/zlib.h>
 
+#include <ace/TSS_T.h>
+
+#include <atomic>
+#include <chrono>
+
 UpdateData::UpdateData() : m_blockCount(0)
 {
 }
@@ -46,105 +51,200 @@ void UpdateData::AddUpdateBlock(const ByteBuffer& block)
     ++m_blockCount;
 }
 
-void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
+/// Packets up to this size are sent without compression
+static const size_t COMPRESS_MIN_SIZE = 100;
+/// Packets below this size gain too little from higher levels and use Z_BEST_SPEED
+static const size_t COMPRESS_FAST_BELOW_SIZE = 1024;
+
+static std::atomic<uint64> s_compressedPackets(0);
+static std::atomic<uint64> s_fastPackets(0);
+static std::atomic<uint64> s_compressedBytesIn(0);
+static std::atomic<uint64> s_compressedBytesOut(0);
+static std::atomic<uint64> s_compressTime(0);
+static std::atomic<bool> s_isBusy(false);
+
+// world thread only
+static uint64 s_lastTickTotalTime = 0;
+static uint32 s_lastTickTime = 0;
+static uint32 s_maxTickTime = 0;
+
+/// Deflate stream of one thread, reset instead of allocated again for every packet
+class UpdateCompressor
 {
-    z_stream c_stream;
-
-    c_stream.zalloc = (alloc_func)0;
-    c_stream.zfree = (free_func)0;
-    c_stream.opaque = (voidpf)0;
-
-    // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
-
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
-    if (c_stream.avail_in != 0)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflate not greedy)");
-        *dst_size = 0;
-        return;
-    }
-
-    z_res = deflate(&c_stream, Z_FINISH);
-    if (z_res != Z_STREAM_END)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
-    *dst_size = c_stream.total_out;
-}
+    public:
+        UpdateCompressor() : m_isInitialized(false), m_level(0)
+        {
+            memset(&m_stream, 0, sizeof(m_stream));
+        }
+
+        ~UpdateCompressor()
+        {
+            if (m_isInitialized)
+                deflateEnd(&m_stream);
+        }
+
+        /// Compress header and data as one stream into dst, returns the compressed size or 0 on error
+        uint32 Compress(uint8* dst, uint32 dstSize, ByteBuffer const& header, ByteBuffer const& data, int level)
+        {
+            if (!Prepare(level))
+                return 0;
+
+            m_stream.next_out = (Bytef*)dst;
+            m_stream.avail_out = dstSize;
+
+            m_stream.next_in = (Bytef*)header.contents();
+            m_stream.avail_in = (uInt)header.wpos();
+
+            int z_res = deflate(&m_stream, Z_NO_FLUSH);
+            if (z_res != Z_OK || m_stream.avail_in != 0)
+                return Fail("deflate", z_res);
+
+            m_stream.next_in = (Bytef*)(data.wpos() ? data.contents() : nullptr);
+            m_stream.avail_in = (uInt)data.wpos();
+
+            z_res = deflate(&m_stream, Z_FINISH);
+            if (z_res != Z_STREAM_END)
+                return Fail("deflate should report Z_STREAM_END", z_res);
+
+            return uint32(m_stream.total_out);
+        }
+
+    private:
+        bool Prepare(int level)
+        {
+            int z_res;
+            if (!m_isInitialized)
+            {
+                z_res = deflateInit(&m_stream, level);
+                if (z_res != Z_OK)
+                {
+                    sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+                    return false;
+                }
+
+                m_isInitialized = true;
+                m_level = level;
+                return true;
+            }
+
+            z_res = deflateReset(&m_stream);
+            if (z_res != Z_OK)
+                return Fail("deflateReset", z_res) != 0;
+
+            // no input since the reset, so the level changes without flushing anything
+            if (level != m_level)
+            {
+                z_res = deflateParams(&m_stream, level, Z_DEFAULT_STRATEGY);
+                if (z_res != Z_OK)
+                    return Fail("deflateParams", z_res) != 0;
+
+                m_level = level;
+            }
+
+            return true;
+        }
+
+        uint32 Fail(char const* step, int z_res)
+        {
+            sLog.outError("Can't compress update packet (zlib: %s) Error code: %i (%s)", step, z_res, zError(z_res));
+
+            // the stream state is unknown, start with a new one next time
+            deflateEnd(&m_stream);
+            memset(&m_stream, 0, sizeof(m_stream));
+            m_isInitialized = false;
+            return 0;
+        }
+
+        z_stream m_stream;
+        bool m_isInitialized;
+        int m_level;
+};
+
+typedef ACE_TSS<UpdateCompressor> UpdateCompressorTSS;
+static UpdateCompressorTSS s_compressor;
 
 bool UpdateData::BuildPacket(WorldPacket* packet)
 {
     MANGOS_ASSERT(packet->empty());                         // shouldn't happen
 
-    ByteBuffer buf(4 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()) + m_data.wpos());
+    // only the block count and out of range guids are written here, the blocks go into the packet directly
+    ByteBuffer header(4 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()));
 
-    buf << (uint32)(!m_outOfRangeGUIDs.empty() ? m_blockCount + 1 : m_blockCount);
+    header << (uint32)(!m_outOfRangeGUIDs.empty() ? m_blockCount + 1 : m_blockCount);
 
     if (!m_outOfRangeGUIDs.empty())
     {
-        buf << (uint8) UPDATETYPE_OUT_OF_RANGE_OBJECTS;
-        buf << (uint32) m_outOfRangeGUIDs.size();
+        header << (uint8) UPDATETYPE_OUT_OF_RANGE_OBJECTS;
+        header << (uint32) m_outOfRangeGUIDs.size();
 
         for (GuidSet::const_iterator i = m_outOfRangeGUIDs.begin(); i != m_outOfRangeGUIDs.end(); ++i)
-            buf << i->WriteAsPacked();
+            header << i->WriteAsPacked();
     }
 
-    buf.append(m_data);
-
-    size_t pSize = buf.wpos();                              // use real used data size
+    size_t pSize = header.wpos() + m_data.wpos();           // use real used data size
 
-    if (pSize > 100)                                        // compress large packets
+    if (pSize > COMPRESS_MIN_SIZE)                          // compress large packets
     {
+        // higher levels cost a lot of map thread time, only spend it on large packets when the server is not busy
+        int level = sWorld.getConfig(CONFIG_UINT32_COMPRESSION);
+        bool isFast = level > Z_BEST_SPEED && (pSize < COMPRESS_FAST_BELOW_SIZE || s_isBusy.load(std::memory_order_relaxed));
+        if (isFast)
+            level = Z_BEST_SPEED;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
         uint32 destsize = compressBound(pSize);
         packet->resize(destsize + sizeof(uint32));
 
         packet->put<uint32>(0, pSize);
-        Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32), &destsize, (void*)buf.contents(), pSize);
+        destsize = s_compressor->Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32), destsize, header, m_data, level);
         if (destsize == 0)
             return false;
 
         packet->resize(destsize + sizeof(uint32));
         packet->SetOpcode(SMSG_COMPRESSED_UPDATE_OBJECT);
+
+        s_compressTime.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+        s_compressedPackets.fetch_add(1, std::memory_order_relaxed);
+        s_compressedBytesIn.fetch_add(pSize, std::memory_order_relaxed);
+        s_compressedBytesOut.fetch_add(destsize + sizeof(uint32), std::memory_order_relaxed);
+        if (isFast)
+            s_fastPackets.fetch_add(1, std::memory_order_relaxed);
     }
     else                                                    // send small packets without compression
     {
-        packet->append(buf);
+        packet->reserve(pSize);
+        packet->append(header);
+        packet->append(m_data);
         packet->SetOpcode(SMSG_UPDATE_OBJECT);
     }
 
     return true;
 }
 
+void UpdateData::UpdateCompressionLoad(uint32 tickTime)
+{
+    // a tick using half of the map update interval leaves little room for expensive compression
+    s_isBusy.store(tickTime * 2 >= sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE), std::memory_order_relaxed);
+
+    uint64 totalTime = s_compressTime.load(std::memory_order_relaxed);
+    s_lastTickTime = uint32(totalTime - s_lastTickTotalTime);
+    s_maxTickTime = std::max(s_maxTickTime, s_lastTickTime);
+    s_lastTickTotalTime = totalTime;
+}
+
+void UpdateData::GetCompressionStats(UpdateCompressionStats& stats)
+{
+    stats.packets = s_compressedPackets.load(std::memory_order_relaxed);
+    stats.fastPackets = s_fastPackets.load(std::memory_order_relaxed);
+    stats.bytesIn = s_compressedBytesIn.load(std::memory_order_relaxed);
+    stats.bytesOut = s_compressedBytesOut.load(std::memory_order_relaxed);
+    stats.time = s_compressTime.load(std::memory_order_relaxed);
+    stats.lastTickTime = s_lastTickTime;
+    stats.maxTickTime = s_maxTickTime;
+    stats.isBusy = s_isBusy.load(std::memory_order_relaxed);
+}
+
 void UpdateData::Clear()
 {
     m_data.clear();
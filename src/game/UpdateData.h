@@ -49,6 +49,21 @@ enum ObjectUpdateFlags
     UPDATEFLAG_ROTATION             = 0x0200
 };
 
+/// Compression of update packets since server start
+struct UpdateCompressionStats
+{
+    UpdateCompressionStats() : packets(0), fastPackets(0), bytesIn(0), bytesOut(0), time(0), lastTickTime(0), maxTickTime(0), isBusy(false) {}
+
+    uint64 packets;
+    uint64 fastPackets;                                     // compressed with Z_BEST_SPEED instead of the Compression level
+    uint64 bytesIn;                                         // before compression
+    uint64 bytesOut;
+    uint64 time;                                            // microseconds spent compressing
+    uint32 lastTickTime;                                    // microseconds spent compressing in the previous world tick
+    uint32 maxTickTime;
+    bool isBusy;                                            // previous world tick was long, compressing everything fast
+};
+
 class UpdateData
 {
     public:
@@ -63,11 +78,13 @@ class UpdateData
 
         GuidSet const& GetOutOfRangeGUIDs() const { return m_outOfRangeGUIDs; }
 
+        /// Called by the world thread after every tick with its duration in milliseconds
+        static void UpdateCompressionLoad(uint32 tickTime);
+        static void GetCompressionStats(UpdateCompressionStats& stats);
+
     protected:
         uint32 m_blockCount;
         GuidSet m_outOfRangeGUIDs;
         ByteBuffer m_data;
-
-        void Compress(void* dst, uint32* dst_size, void* src, int src_size);
 };
 #endif
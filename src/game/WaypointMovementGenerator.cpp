@@ -405,8 +405,6 @@ void FlightPathMovementGenerator::Interrupt(Player& player)
     player.clearUnitState(UNIT_STAT_TAXI_FLIGHT);
 }
 
-#define PLAYER_FLIGHT_SPEED        32.0f
-
 void FlightPathMovementGenerator::Reset(Player& player)
 {
     player.getHostileRefManager().setOnlineOfflineState(false);
@@ -102,6 +102,8 @@ class MANGOS_DLL_SPEC WaypointMovementGenerator<Creature>
         WaypointPathOrigin m_PathOrigin;
 };
 
+#define PLAYER_FLIGHT_SPEED        32.0f
+
 /** FlightPathMovementGenerator generates movement of the player for the paths
  * and hence generates ground and activities for the player.
  */
@@ -67,6 +67,8 @@
 #include "CreatureLinkingMgr.h"
 #include "Calendar.h"
 #include "Weather.h"
+#include "WorldLoader.h"
+#include "OpcodeStats.h"
 
 #include <algorithm>
 #include <mutex>
@@ -162,6 +164,15 @@ WorldSession* World::FindSession(uint32 id) const
         return nullptr;
 }
 
+/// Fill list with all sessions, including kicked and queued ones
+void World::GetSessions(std::vector<WorldSession*>& sessions) const
+{
+    sessions.reserve(sessions.size() + m_sessions.size());
+    for (SessionMap::const_iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
+        if (itr->second)
+            sessions.push_back(itr->second);
+}
+
 /// Remove a given session
 bool World::RemoveSession(uint32 id)
 {
@@ -505,6 +516,12 @@ void World::LoadConfigSettings(bool reload)
     if (reload)
         sMapMgr.SetMapUpdateInterval(getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
 
+    if (configNoReload(reload, CONFIG_UINT32_MAPUPDATE_THREADS, "MapUpdate.Threads", 0))
+        setConfigMinMax(CONFIG_UINT32_MAPUPDATE_THREADS, "MapUpdate.Threads", 0, 0, 64);
+    setConfig(CONFIG_UINT32_MAPUPDATE_SLOW_LOG, "MapUpdate.SlowLogThreshold", 0);
+    setConfigMinMax(CONFIG_UINT32_MAPUPDATE_PRELOAD_LOOKAHEAD, "MapUpdate.PreloadLookAhead", 10, 0, 120);
+    setConfigMinMax(CONFIG_UINT32_STARTUP_LOADER_THREADS, "Startup.LoaderThreads", 0, 0, 64);
+
     setConfig(CONFIG_UINT32_INTERVAL_CHANGEWEATHER, "ChangeWeatherInterval", 10 * MINUTE * IN_MILLISECONDS);
 
     if (configNoReload(reload, CONFIG_UINT32_PORT_WORLD, "WorldServerPort", DEFAULT_WORLDSERVER_PORT))
@@ -732,6 +749,11 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_OFFHAND_CHECK_AT_TALENTS_RESET, "OffhandCheckAtTalentsReset", false);
 
     setConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET, "Network.KickOnBadPacket", false);
+    setConfig(CONFIG_UINT32_SESSION_PACKETS_PER_UPDATE, "Network.PacketsPerUpdate", 100);
+    setConfig(CONFIG_UINT32_OPCODE_STATS_LOG_INTERVAL, "Network.OpcodeStatsLogInterval", 600);
+    setConfig(CONFIG_UINT32_SESSION_TIME_BUDGET, "Network.SessionTimeBudget", 20000);
+    setConfig(CONFIG_UINT32_SESSION_MAX_DEFERRED, "Network.RateLimitMaxDeferred", 50);
+    LoadOpcodeRateLimits();
 
     setConfig(CONFIG_BOOL_PLAYER_COMMANDS, "PlayerCommands", true);
 
@@ -798,6 +820,7 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_BOOL_VMAP_INDOOR_CHECK, "vmap.enableIndoorCheck", true);
+    setConfigMinMax(CONFIG_UINT32_VMAP_LOS_CACHE_TIME, "vmap.LOSCacheTime", 500, 0, 10000);
     bool enableLOS = sConfig.GetBoolDefault("vmap.enableLOS", false);
     bool enableHeight = sConfig.GetBoolDefault("vmap.enableHeight", false);
     std::string ignoreSpellIds = sConfig.GetStringDefault("vmap.ignoreSpellIds", "");
@@ -813,6 +836,8 @@ void World::LoadConfigSettings(bool reload)
     sLog.outString("WORLD: VMap data directory is: %svmaps", m_dataPath.c_str());
 
     setConfig(CONFIG_BOOL_MMAP_ENABLED, "mmap.enabled", true);
+    if (configNoReload(reload, CONFIG_UINT32_MMAP_PATHFINDING_THREADS, "mmap.pathfindingThreads", 0))
+        setConfigMinMax(CONFIG_UINT32_MMAP_PATHFINDING_THREADS, "mmap.pathfindingThreads", 0, 0, 16);
     std::string ignoreMapIds = sConfig.GetStringDefault("mmap.ignoreMapIds", "");
     MMAP::MMapFactory::preventPathfindingOnMaps(ignoreMapIds.c_str());
     sLog.outString("WORLD: MMap pathfinding %sabled", getConfig(CONFIG_BOOL_MMAP_ENABLED) ? "en" : "dis");
@@ -1113,29 +1138,38 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading Player level dependent mail rewards...");
     sObjectMgr.LoadMailLevelRewards();
 
-    sLog.outString("Loading Loot Tables...");
-    LoadLootTables();
-    sLog.outString(">>> Loot Tables loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Skill Discovery Table...");
-    LoadSkillDiscoveryTable();
-
-    sLog.outString("Loading Skill Extra Item Table...");
-    LoadSkillExtraItemTable();
-
-    sLog.outString("Loading Skill Fishing base level requirements...");
-    sObjectMgr.LoadFishingBaseSkillLevel();
-
-    sLog.outString("Loading Achievements...");
-    sAchievementMgr.LoadAchievementReferenceList();
-    sAchievementMgr.LoadAchievementCriteriaList();
-    sAchievementMgr.LoadAchievementCriteriaRequirements();
-    sAchievementMgr.LoadRewards();
-    sAchievementMgr.LoadRewardLocales();
-    sAchievementMgr.LoadCompletedAchievements();
-    sLog.outString(">>> Achievements loaded");
-    sLog.outString();
+    ///- Loot, skill and achievement tables only read data loaded above, run them together
+    WorldLoader loader;
+    loader.AddTask("Creature Loot Tables", &LoadLootTemplates_Creature);
+    loader.AddTask("Fishing Loot Tables", &LoadLootTemplates_Fishing);
+    loader.AddTask("Gameobject Loot Tables", &LoadLootTemplates_Gameobject);
+    loader.AddTask("Item Loot Tables", &LoadLootTemplates_Item);
+    loader.AddTask("Mail Loot Tables", &LoadLootTemplates_Mail);
+    loader.AddTask("Milling Loot Tables", &LoadLootTemplates_Milling);
+    loader.AddTask("Pickpocketing Loot Tables", &LoadLootTemplates_Pickpocketing);
+    loader.AddTask("Skinning Loot Tables", &LoadLootTemplates_Skinning);
+    loader.AddTask("Disenchant Loot Tables", &LoadLootTemplates_Disenchant);
+    loader.AddTask("Prospecting Loot Tables", &LoadLootTemplates_Prospecting);
+    loader.AddTask("Spell Loot Tables", &LoadLootTemplates_Spell);
+    loader.AddTask("Reference Loot Tables", &LoadLootTemplates_Reference,
+    {
+        "Creature Loot Tables", "Fishing Loot Tables", "Gameobject Loot Tables", "Item Loot Tables", "Mail Loot Tables", "Milling Loot Tables",
+        "Pickpocketing Loot Tables", "Skinning Loot Tables", "Disenchant Loot Tables", "Prospecting Loot Tables", "Spell Loot Tables"
+    });                                                     // checks references from all other loot tables
+    loader.AddTask("random loot items", []() { sLootMgr.LoadRandomLootItems(); });
+    loader.AddTask("Skill Discovery Table", &LoadSkillDiscoveryTable);
+    loader.AddTask("Skill Extra Item Table", &LoadSkillExtraItemTable);
+    loader.AddTask("Skill Fishing base level requirements", []() { sObjectMgr.LoadFishingBaseSkillLevel(); });
+    loader.AddTask("Achievements", []()
+    {
+        sAchievementMgr.LoadAchievementReferenceList();
+        sAchievementMgr.LoadAchievementCriteriaList();
+        sAchievementMgr.LoadAchievementCriteriaRequirements();
+        sAchievementMgr.LoadRewards();
+        sAchievementMgr.LoadRewardLocales();
+        sAchievementMgr.LoadCompletedAchievements();
+    });
+    loader.Run(getConfig(CONFIG_UINT32_STARTUP_LOADER_THREADS));
 
     sLog.outString("Loading Instance encounters data...");  // must be after Creature loading
     sObjectMgr.LoadInstanceEncounters();
@@ -1177,18 +1211,16 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading GameTeleports...");
     sObjectMgr.LoadGameTele();
 
-    ///- Loading localization data
-    sLog.outString("Loading Localization strings...");
-    sObjectMgr.LoadCreatureLocales();                       // must be after CreatureInfo loading
-    sObjectMgr.LoadGameObjectLocales();                     // must be after GameobjectInfo loading
-    sObjectMgr.LoadItemLocales();                           // must be after ItemPrototypes loading
-    sObjectMgr.LoadQuestLocales();                          // must be after QuestTemplates loading
-    sObjectMgr.LoadGossipTextLocales();                     // must be after LoadGossipText
-    sObjectMgr.LoadPageTextLocales();                       // must be after PageText loading
-    sObjectMgr.LoadGossipMenuItemsLocales();                // must be after gossip menu items loading
-    sObjectMgr.LoadPointOfInterestLocales();                // must be after POI loading
-    sLog.outString(">>> Localization strings loaded");
-    sLog.outString();
+    ///- Loading localization data, each loader fills its own locale map
+    loader.AddTask("Creature locales", []() { sObjectMgr.LoadCreatureLocales(); });                  // must be after CreatureInfo loading
+    loader.AddTask("GameObject locales", []() { sObjectMgr.LoadGameObjectLocales(); });              // must be after GameobjectInfo loading
+    loader.AddTask("Item locales", []() { sObjectMgr.LoadItemLocales(); });                          // must be after ItemPrototypes loading
+    loader.AddTask("Quest locales", []() { sObjectMgr.LoadQuestLocales(); });                        // must be after QuestTemplates loading
+    loader.AddTask("NPC Text locales", []() { sObjectMgr.LoadGossipTextLocales(); });                // must be after LoadGossipText
+    loader.AddTask("Page Text locales", []() { sObjectMgr.LoadPageTextLocales(); });                 // must be after PageText loading
+    loader.AddTask("Gossip Menu Option locales", []() { sObjectMgr.LoadGossipMenuItemsLocales(); }); // must be after gossip menu items loading
+    loader.AddTask("Points Of Interest locales", []() { sObjectMgr.LoadPointOfInterestLocales(); }); // must be after POI loading
+    loader.Run(getConfig(CONFIG_UINT32_STARTUP_LOADER_THREADS));
 
     ///- Load dynamic data tables from the database
     sLog.outString("Loading Auctions...");
@@ -1404,6 +1436,8 @@ void World::DetectDBCLang()
 /// Update the World !
 void World::Update(uint32 diff)
 {
+    uint32 tickStart = WorldTimer::getMSTime();
+
     ///- Update the different timers
     for (int i = 0; i < WUPDATE_COUNT; ++i)
     {
@@ -1468,7 +1502,7 @@ void World::Update(uint32 diff)
         LoginDatabase.PExecute("UPDATE uptime SET uptime = %u, maxplayers = %u WHERE realmid = %u AND starttime = " UI64FMTD, tmpDiff, maxClientsNum, realmID, uint64(m_startTime));
     }
 
-    sMapMgr.SetBestPlayer();
+    sMapMgr.UpdateCreatureScaling();
 
     /// <li> Handle all other objects
     ///- Update objects (maps, transport, creatures,...)
@@ -1515,6 +1549,12 @@ void World::Update(uint32 diff)
 
     // cleanup unused GridMap objects as well as VMaps
     sTerrainMgr.Update(diff);
+
+    // opcodes counted by this thread during the tick
+    sOpcodeStats.Flush();
+    sOpcodeStats.Update(diff);
+
+    UpdateData::UpdateCompressionLoad(WorldTimer::getMSTimeDiff(tickStart, WorldTimer::getMSTime()));
 }
 
 namespace MaNGOS
@@ -1586,13 +1626,14 @@ void World::SendWorldText(int32 string_id, ...)
 /// Sends a packet to all players with optional team and instance restrictions
 void World::SendGlobalMessage(WorldPacket* packet)
 {
+    SharedWorldPacket sharedPacket(*packet);
     for (SessionMap::const_iterator itr = m_sessions.begin(); itr != m_sessions.end(); ++itr)
     {
         if (WorldSession* session = itr->second)
         {
             Player* player = session->GetPlayer();
             if (player && player->IsInWorld())
-                session->SendPacket(packet);
+                session->SendPacket(sharedPacket);
         }
     }
 }
@@ -1863,6 +1904,10 @@ void World::UpdateSessions(uint32 /*diff*/)
         m_sessionAddQueue.clear();
     }
 
+    // players arriving after a teleport become visible to everyone around them with one serialization
+    UpdateBlockCache blockCache;
+    UpdateBlockCacheGuard blockCacheGuard(blockCache);
+
     ///- Then send an update signal to remaining ones
     for (SessionMap::iterator itr = m_sessions.begin(), next; itr != m_sessions.end(); itr = next)
     {
@@ -2285,6 +2330,43 @@ bool World::configNoReload(bool reload, eConfigBoolValues index, char const* fie
     return false;
 }
 
+/// Parse Network.OpcodeRateLimits, a list of OPCODE_NAME:rate:burst entries
+void World::LoadOpcodeRateLimits()
+{
+    std::vector<OpcodeRateLimit> limits;
+
+    Tokens entries = StrSplit(sConfig.GetStringDefault("Network.OpcodeRateLimits", ""), " ,");
+    for (Tokens::const_iterator itr = entries.begin(); itr != entries.end(); ++itr)
+    {
+        Tokens fields = StrSplit(*itr, ":");
+        float rate = fields.size() > 1 ? float(atof(fields[1].c_str())) : 0.0f;
+        float burst = fields.size() > 2 ? float(atof(fields[2].c_str())) : 1.0f;
+        if (fields.size() < 2 || fields.size() > 3 || rate <= 0.0f || burst < 1.0f)
+        {
+            sLog.outError("Network.OpcodeRateLimits: entry '%s' is not OPCODE_NAME:rate:burst with a positive rate and a burst of at least 1, skipped.", itr->c_str());
+            continue;
+        }
+
+        uint32 opcode = 0;
+        while (opcode < NUM_MSG_TYPES && fields[0] != opcodeTable[opcode].name)
+            ++opcode;
+
+        if (opcode == NUM_MSG_TYPES)
+        {
+            sLog.outError("Network.OpcodeRateLimits: unknown opcode %s, skipped.", fields[0].c_str());
+            continue;
+        }
+
+        if (limits.empty())
+            limits.resize(NUM_MSG_TYPES);
+
+        limits[opcode].rate = rate;
+        limits[opcode].burst = burst;
+    }
+
+    m_opcodeRateLimits.swap(limits);
+}
+
 void World::InvalidatePlayerDataToAllClient(ObjectGuid guid)
 {
     WorldPacket data(SMSG_INVALIDATE_PLAYER, 8);
@@ -31,6 +31,7 @@
 #include <map>
 #include <set>
 #include <list>
+#include <vector>
 #include <deque>
 #include <mutex>
 
@@ -88,6 +89,16 @@ enum eConfigUInt32Values
     CONFIG_UINT32_INTERVAL_SAVE,
     CONFIG_UINT32_INTERVAL_GRIDCLEAN,
     CONFIG_UINT32_INTERVAL_MAPUPDATE,
+    CONFIG_UINT32_MAPUPDATE_THREADS,
+    CONFIG_UINT32_MAPUPDATE_SLOW_LOG,
+    CONFIG_UINT32_MAPUPDATE_PRELOAD_LOOKAHEAD,
+    CONFIG_UINT32_VMAP_LOS_CACHE_TIME,
+    CONFIG_UINT32_MMAP_PATHFINDING_THREADS,
+    CONFIG_UINT32_STARTUP_LOADER_THREADS,
+    CONFIG_UINT32_SESSION_PACKETS_PER_UPDATE,
+    CONFIG_UINT32_OPCODE_STATS_LOG_INTERVAL,
+    CONFIG_UINT32_SESSION_TIME_BUDGET,
+    CONFIG_UINT32_SESSION_MAX_DEFERRED,
     CONFIG_UINT32_INTERVAL_CHANGEWEATHER,
     CONFIG_UINT32_PORT_WORLD,
     CONFIG_UINT32_GAME_TYPE,
@@ -446,6 +457,15 @@ struct CliCommandHolder
     ~CliCommandHolder() { delete[] m_command; }
 };
 
+/// Token bucket parameters of one opcode (Network.OpcodeRateLimits), a rate of 0 means no limit
+struct OpcodeRateLimit
+{
+    OpcodeRateLimit() : rate(0.0f), burst(0.0f) {}
+
+    float rate;                                             // tokens added per second
+    float burst;                                            // bucket size, packets allowed at once after idling
+};
+
 /// The World
 class World
 {
@@ -458,6 +478,7 @@ class World
         void CleanupsBeforeStop();
 
         WorldSession* FindSession(uint32 id) const;
+        void GetSessions(std::vector<WorldSession*>& sessions) const;
         void AddSession(WorldSession* s);
         bool RemoveSession(uint32 id);
         /// Get the number of current active sessions
@@ -560,6 +581,12 @@ class World
         /// Get configuration about force-loaded maps
         std::set<uint32>* getConfigForceLoadMapIds() const { return m_configForceLoadMapIds; }
 
+        /// Get the rate limit of an opcode, nullptr if it is not limited
+        OpcodeRateLimit const* GetOpcodeRateLimit(uint16 opcode) const
+        {
+            return opcode < m_opcodeRateLimits.size() && m_opcodeRateLimits[opcode].rate > 0.0f ? &m_opcodeRateLimits[opcode] : nullptr;
+        }
+
         /// Are we on a "Player versus Player" server?
         bool IsPvPRealm() { return (getConfig(CONFIG_UINT32_GAME_TYPE) == REALM_TYPE_PVP || getConfig(CONFIG_UINT32_GAME_TYPE) == REALM_TYPE_RPPVP || getConfig(CONFIG_UINT32_GAME_TYPE) == REALM_TYPE_FFA_PVP); }
         bool IsFFAPvPRealm() { return getConfig(CONFIG_UINT32_GAME_TYPE) == REALM_TYPE_FFA_PVP; }
@@ -636,6 +663,7 @@ class World
         bool configNoReload(bool reload, eConfigInt32Values index, char const* fieldname, int32 defvalue);
         bool configNoReload(bool reload, eConfigFloatValues index, char const* fieldname, float defvalue);
         bool configNoReload(bool reload, eConfigBoolValues index, char const* fieldname, bool defvalue);
+        void LoadOpcodeRateLimits();
 
         static volatile bool m_stopEvent;
         static uint8 m_ExitCode;
@@ -702,6 +730,8 @@ class World
 
         // List of Maps that should be force-loaded on startup
         std::set<uint32>* m_configForceLoadMapIds;
+
+        std::vector<OpcodeRateLimit> m_opcodeRateLimits;    // indexed by opcode, empty if nothing is limited
 };
 
 extern uint32 realmID;
@@ -0,0 +1,137 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "WorldLoader.h"
+#include "Database/DatabaseEnv.h"
+#include "ProgressBar.h"
+#include "Timer.h"
+#include "Log.h"
+
+#include <thread>
+
+void WorldLoader::AddTask(char const* name, LoadFunction const& function, DependencyList const& dependencies)
+{
+    size_t index = m_tasks.size();
+    m_tasks.push_back(Task(name, function));
+
+    for (DependencyList::const_iterator itr = dependencies.begin(); itr != dependencies.end(); ++itr)
+    {
+        bool found = false;
+        for (size_t i = 0; i < index; ++i)
+        {
+            if (m_tasks[i].name == *itr)
+            {
+                m_tasks[i].dependents.push_back(index);
+                ++m_tasks[index].waitingFor;
+                found = true;
+                break;
+            }
+        }
+
+        MANGOS_ASSERT(found && "WorldLoader dependency must be registered first");
+    }
+}
+
+void WorldLoader::Run(uint32 numThreads)
+{
+    uint32 startTime = WorldTimer::getMSTime();
+
+    if (numThreads > m_tasks.size())
+        numThreads = uint32(m_tasks.size());
+
+    if (numThreads <= 1)
+    {
+        for (std::vector<Task>::const_iterator itr = m_tasks.begin(); itr != m_tasks.end(); ++itr)
+            RunTask(*itr);
+    }
+    else
+    {
+        // bars of loaders running together would overwrite each other
+        bool showBars = BarGoLink::GetOutputState();
+        BarGoLink::SetOutputState(false);
+
+        m_finished = 0;
+        for (size_t i = 0; i < m_tasks.size(); ++i)
+            if (!m_tasks[i].waitingFor)
+                m_ready.push_back(i);
+
+        // calling thread is a worker too, every worker queries through its own connection
+        // as long as the pool has enough of them (the binding wraps around otherwise)
+        std::vector<std::thread> workers;
+        for (uint32 i = 1; i < numThreads; ++i)
+        {
+            workers.push_back(std::thread([this, i]()
+            {
+                WorldDatabase.ThreadStart();
+                WorldDatabase.BindQueryConnection(i);
+                WorkerThread();
+                WorldDatabase.UnbindQueryConnection();
+                WorldDatabase.ThreadEnd();
+            }));
+        }
+
+        WorldDatabase.BindQueryConnection(0);
+        WorkerThread();
+        WorldDatabase.UnbindQueryConnection();
+
+        for (std::vector<std::thread>::iterator itr = workers.begin(); itr != workers.end(); ++itr)
+            itr->join();
+
+        BarGoLink::SetOutputState(showBars);
+    }
+
+    sLog.outString(">> " SIZEFMTD " loaders finished in %u ms using %u thread(s)", m_tasks.size(), WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime()), numThreads > 1 ? numThreads : 1);
+    sLog.outString();
+
+    m_tasks.clear();
+}
+
+void WorldLoader::WorkerThread()
+{
+    std::unique_lock<std::mutex> guard(m_lock);
+
+    for (;;)
+    {
+        m_cond.wait(guard, [this] { return !m_ready.empty() || m_finished == m_tasks.size(); });
+
+        if (m_ready.empty())
+            return;                                         // everything is finished
+
+        size_t index = m_ready.front();
+        m_ready.pop_front();
+
+        guard.unlock();
+        RunTask(m_tasks[index]);
+        guard.lock();
+
+        ++m_finished;
+
+        std::vector<size_t> const& dependents = m_tasks[index].dependents;
+        for (std::vector<size_t>::const_iterator itr = dependents.begin(); itr != dependents.end(); ++itr)
+            if (--m_tasks[*itr].waitingFor == 0)
+                m_ready.push_back(*itr);
+
+        m_cond.notify_all();
+    }
+}
+
+void WorldLoader::RunTask(Task const& task)
+{
+    sLog.outString("Loading %s...", task.name.c_str());
+    task.function();
+}
@@ -0,0 +1,78 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_WORLDLOADER_H
+#define MANGOS_WORLDLOADER_H
+
+#include "Common.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Dependency graph of startup loaders.
+ *
+ * Every loader is registered with the names of the loaders it needs, Run() then executes
+ * loaders whose dependencies are finished on a few threads at the same time. Dependencies
+ * must be registered before their dependents, so registration order is always a valid
+ * serial order and is what a single threaded Run() uses.
+ *
+ * Loaders running together must not write the same data; they only read what their
+ * dependencies (or anything loaded before Run()) produced.
+ */
+class WorldLoader
+{
+    public:
+        typedef std::function<void()> LoadFunction;
+        typedef std::vector<char const*> DependencyList;
+
+        WorldLoader() : m_finished(0) {}
+
+        /// Register loader, name is used for the "Loading ..." log line and as dependency key
+        void AddTask(char const* name, LoadFunction const& function, DependencyList const& dependencies = DependencyList());
+
+        /// Execute all registered loaders and forget them, 0 or 1 thread runs them in registration order
+        void Run(uint32 numThreads);
+
+    private:
+        struct Task
+        {
+            Task(char const* _name, LoadFunction const& _function) : name(_name), function(_function), waitingFor(0) {}
+
+            std::string name;
+            LoadFunction function;
+            std::vector<size_t> dependents;
+            uint32 waitingFor;                              // not finished dependencies
+        };
+
+        void WorkerThread();
+        void RunTask(Task const& task);
+
+        std::vector<Task> m_tasks;
+
+        std::mutex m_lock;
+        std::condition_variable m_cond;                     // signaled when a task becomes ready or all are finished
+        std::deque<size_t> m_ready;
+        size_t m_finished;
+};
+
+#endif
@@ -40,10 +40,13 @@
 #include "Auth/HMACSHA1.h"
 #include "zlib/zlib.h"
 #include "LootMgr.h"
+#include "BroadcastBatch.h"
+#include "OpcodeStats.h"
 
 #include <mutex>
 #include <deque>
 #include <algorithm>
+#include <chrono>
 
 // select opcodes appropriate for processing in Map::Update context for current session state
 static bool MapSessionFilterHelper(WorldSession* session, OpcodeHandler const& opHandle)
@@ -89,7 +92,7 @@ WorldSession::WorldSession(uint32 id, WorldSocket* sock, AccountTypes sec, uint8
     m_muteTime(mute_time), _player(nullptr), m_Socket(sock), _security(sec), _accountId(id), m_expansion(expansion), _logoutTime(0),
     m_inQueue(false), m_playerLoading(false), m_playerLogout(false), m_playerRecentlyLogout(false), m_playerSave(false),
     m_sessionDbcLocale(sWorld.GetAvailableDbcLocale(locale)), m_sessionDbLocaleIndex(sObjectMgr.GetIndexForLocale(locale)),
-    m_latency(0), m_clientTimeDelay(0), m_tutorialState(TUTORIALDATA_UNCHANGED)
+    m_latency(0), m_clientTimeDelay(0), m_tutorialState(TUTORIALDATA_UNCHANGED), m_throttleLogTime(WorldTimer::getMSTime())
 {
     if (sock)
     {
@@ -114,7 +117,12 @@ WorldSession::~WorldSession()
     }
 
     ///- empty incoming packet queue
-    std::for_each(m_recvQueue.begin(), m_recvQueue.end(), [](const WorldPacket *packet) { delete packet; });
+    WorldPacket* packet;
+    while (m_recvQueue.next(packet))
+        delete packet;
+
+    for (std::deque<WorldPacket*>::const_iterator itr = m_deferredPackets.begin(); itr != m_deferredPackets.end(); ++itr)
+        delete *itr;
 }
 
 void WorldSession::SizeError(WorldPacket const& packet, uint32 size) const
@@ -135,6 +143,10 @@ void WorldSession::SendPacket(WorldPacket const* packet)
     if (!m_Socket)
         return;
 
+    // broadcasts batched on this thread were sent before this packet
+    if (BroadcastBatch* batch = BroadcastBatch::Current())
+        batch->Flush(this);
+
 #ifdef MANGOS_DEBUG
 
     // Code for network use statistic
@@ -175,11 +187,37 @@ void WorldSession::SendPacket(WorldPacket const* packet)
         m_Socket->CloseSocket();
 }
 
+/// Send a packet whose data is shared with other sessions to the client
+void WorldSession::SendPacket(SharedWorldPacket const& packet)
+{
+    if (!m_Socket)
+        return;
+
+    // inside of a map update, written together with the other broadcasts at its end
+    if (BroadcastBatch* batch = BroadcastBatch::Current())
+    {
+        batch->Add(this, packet);
+        return;
+    }
+
+    if (m_Socket->SendPacket(packet) == -1)
+        m_Socket->CloseSocket();
+}
+
+/// Send several shared packets to the client at once
+void WorldSession::SendPackets(std::vector<SharedWorldPacket> const& packets)
+{
+    if (!m_Socket || packets.empty())
+        return;
+
+    if (m_Socket->SendPackets(packets) == -1)
+        m_Socket->CloseSocket();
+}
+
 /// Add an incoming packet to the queue
 void WorldSession::QueuePacket(WorldPacket* new_packet)
 {
-    std::lock_guard<std::mutex> guard(m_recvQueueLock);
-    m_recvQueue.push_back(new_packet);
+    m_recvQueue.add(new_packet);
 }
 
 /// Logging helper for unexpected opcodes
@@ -203,11 +241,37 @@ void WorldSession::LogUnprocessedTail(WorldPacket* packet)
 /// Update the WorldSession (triggered by World update)
 bool WorldSession::Update(PacketFilter& updater)
 {
-    std::lock_guard<std::mutex> guard(m_recvQueueLock);
-
     ///- Retrieve packets from the receive queue and call the appropriate handlers
     /// not process packets if socket already closed
-    while (m_Socket && !m_Socket->IsClosed() && !m_recvQueue.empty())
+    /// at most PacketsPerUpdate of them and for at most SessionTimeBudget, the rest waits for the next update
+    uint32 packetLimit = sWorld.getConfig(CONFIG_UINT32_SESSION_PACKETS_PER_UPDATE);
+    uint32 timeBudget = sWorld.getConfig(CONFIG_UINT32_SESSION_TIME_BUDGET);
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    uint32 now = WorldTimer::getMSTime();
+    uint32 processed = 0;
+    bool overBudget = false;
+
+    // packets deferred by the rate limits go first, all buckets refill to the same time so a newer
+    // packet finds no token of its opcode while an older one of it still waits
+    for (std::deque<WorldPacket*>::iterator itr = m_deferredPackets.begin(); itr != m_deferredPackets.end() && CanHandlePacket(processed, packetLimit, timeBudget, startTime, overBudget);)
+    {
+        if (!updater.Process(*itr) || !ConsumeRateToken((*itr)->GetOpcode(), now))
+        {
+            ++itr;
+            continue;
+        }
+
+        WorldPacket* packet = *itr;
+        itr = m_deferredPackets.erase(itr);
+
+        ++processed;
+        HandlePacket(packet);
+    }
+
+    // stop at the first packet the updater can't handle, Map::Update() takes only thread-safe ones
+    // and World::UpdateSessions() the rest, so packets are still handled in the order they arrived
+    WorldPacket* packet;
+    while (CanHandlePacket(processed, packetLimit, timeBudget, startTime, overBudget) && m_recvQueue.next(packet, updater))
     {
         /*#if 1
         sLog.outError( "MOEP: %s (0x%.4X)",
@@ -215,96 +279,20 @@ bool WorldSession::Update(PacketFilter& updater)
                         packet->GetOpcode());
         #endif*/
 
-        WorldPacket* packet = m_recvQueue.front();
-        m_recvQueue.pop_front();
-
-        OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
-        try
+        if (!ConsumeRateToken(packet->GetOpcode(), now))
         {
-            switch (opHandle.status)
-            {
-                case STATUS_LOGGEDIN:
-                    if (!_player)
-                    {
-                        // skip STATUS_LOGGEDIN opcode unexpected errors if player logout sometime ago - this can be network lag delayed packets
-                        if (!m_playerRecentlyLogout)
-                            LogUnexpectedOpcode(packet, "the player has not logged in yet");
-                    }
-                    else if (_player->IsInWorld())
-                        ExecuteOpcode(opHandle, packet);
-
-                    // lag can cause STATUS_LOGGEDIN opcodes to arrive after the player started a transfer
-                    break;
-                case STATUS_LOGGEDIN_OR_RECENTLY_LOGGEDOUT:
-                    if (!_player && !m_playerRecentlyLogout)
-                    {
-                        LogUnexpectedOpcode(packet, "the player has not logged in yet and not recently logout");
-                    }
-                    else
-                        // not expected _player or must checked in packet hanlder
-                        ExecuteOpcode(opHandle, packet);
-                    break;
-                case STATUS_TRANSFER:
-                    if (!_player)
-                        LogUnexpectedOpcode(packet, "the player has not logged in yet");
-                    else if (_player->IsInWorld())
-                        LogUnexpectedOpcode(packet, "the player is still in world");
-                    else
-                        ExecuteOpcode(opHandle, packet);
-                    break;
-                case STATUS_AUTHED:
-                    // prevent cheating with skip queue wait
-                    if (m_inQueue)
-                    {
-                        LogUnexpectedOpcode(packet, "the player not pass queue yet");
-                        break;
-                    }
-
-                    // single from authed time opcodes send in to after logout time
-                    // and before other STATUS_LOGGEDIN_OR_RECENTLY_LOGGOUT opcodes.
-                    if (packet->GetOpcode() != CMSG_SET_ACTIVE_VOICE_CHANNEL)
-                        m_playerRecentlyLogout = false;
-
-                    ExecuteOpcode(opHandle, packet);
-                    break;
-                case STATUS_NEVER:
-                    sLog.outError("SESSION: received not allowed opcode %s (0x%.4X)",
-                                  packet->GetOpcodeName(),
-                                  packet->GetOpcode());
-                    break;
-                case STATUS_UNHANDLED:
-                    DEBUG_LOG("SESSION: received not handled opcode %s (0x%.4X)",
-                              packet->GetOpcodeName(),
-                              packet->GetOpcode());
-                    break;
-                default:
-                    sLog.outError("SESSION: received wrong-status-req opcode %s (0x%.4X)",
-                                  packet->GetOpcodeName(),
-                                  packet->GetOpcode());
-                    break;
-            }
+            DeferPacket(packet);
+            continue;
         }
-        catch (ByteBufferException&)
-        {
-            sLog.outError("WorldSession::Update ByteBufferException occured while parsing a packet (opcode: %u) from client %s, accountid=%i.",
-                          packet->GetOpcode(), GetRemoteAddress().c_str(), GetAccountId());
-            if (sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
-            {
-                DEBUG_LOG("Dumping error causing packet:");
-                packet->hexlike();
-            }
 
-            if (sWorld.getConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET))
-            {
-                DETAIL_LOG("Disconnecting session [account id %u / address %s] for badly formatted packet.",
-                           GetAccountId(), GetRemoteAddress().c_str());
+        ++processed;
+        HandlePacket(packet);
+    }
 
-                KickPlayer();
-            }
-        }
+    if (overBudget && (!m_deferredPackets.empty() || m_recvQueue.size()))
+        ++m_throttleCounters.overBudget;
 
-        delete packet;
-    }
+    LogThrottling(now);
 
     ///- Cleanup socket pointer if need
     if (m_Socket && m_Socket->IsClosed())
@@ -329,6 +317,182 @@ bool WorldSession::Update(PacketFilter& updater)
     return true;
 }
 
+/// Pass a received packet to its handler if the session state allows it, and delete it
+void WorldSession::HandlePacket(WorldPacket* packet)
+{
+    OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
+    try
+    {
+        switch (opHandle.status)
+        {
+            case STATUS_LOGGEDIN:
+                if (!_player)
+                {
+                    // skip STATUS_LOGGEDIN opcode unexpected errors if player logout sometime ago - this can be network lag delayed packets
+                    if (!m_playerRecentlyLogout)
+                        LogUnexpectedOpcode(packet, "the player has not logged in yet");
+                }
+                else if (_player->IsInWorld())
+                    ExecuteOpcode(opHandle, packet);
+
+                // lag can cause STATUS_LOGGEDIN opcodes to arrive after the player started a transfer
+                break;
+            case STATUS_LOGGEDIN_OR_RECENTLY_LOGGEDOUT:
+                if (!_player && !m_playerRecentlyLogout)
+                {
+                    LogUnexpectedOpcode(packet, "the player has not logged in yet and not recently logout");
+                }
+                else
+                    // not expected _player or must checked in packet hanlder
+                    ExecuteOpcode(opHandle, packet);
+                break;
+            case STATUS_TRANSFER:
+                if (!_player)
+                    LogUnexpectedOpcode(packet, "the player has not logged in yet");
+                else if (_player->IsInWorld())
+                    LogUnexpectedOpcode(packet, "the player is still in world");
+                else
+                    ExecuteOpcode(opHandle, packet);
+                break;
+            case STATUS_AUTHED:
+                // prevent cheating with skip queue wait
+                if (m_inQueue)
+                {
+                    LogUnexpectedOpcode(packet, "the player not pass queue yet");
+                    break;
+                }
+
+                // single from authed time opcodes send in to after logout time
+                // and before other STATUS_LOGGEDIN_OR_RECENTLY_LOGGOUT opcodes.
+                if (packet->GetOpcode() != CMSG_SET_ACTIVE_VOICE_CHANNEL)
+                    m_playerRecentlyLogout = false;
+
+                ExecuteOpcode(opHandle, packet);
+                break;
+            case STATUS_NEVER:
+                sLog.outError("SESSION: received not allowed opcode %s (0x%.4X)",
+                              packet->GetOpcodeName(),
+                              packet->GetOpcode());
+                break;
+            case STATUS_UNHANDLED:
+                DEBUG_LOG("SESSION: received not handled opcode %s (0x%.4X)",
+                          packet->GetOpcodeName(),
+                          packet->GetOpcode());
+                break;
+            default:
+                sLog.outError("SESSION: received wrong-status-req opcode %s (0x%.4X)",
+                              packet->GetOpcodeName(),
+                              packet->GetOpcode());
+                break;
+        }
+    }
+    catch (ByteBufferException&)
+    {
+        sLog.outError("WorldSession::Update ByteBufferException occured while parsing a packet (opcode: %u) from client %s, accountid=%i.",
+                      packet->GetOpcode(), GetRemoteAddress().c_str(), GetAccountId());
+        if (sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
+        {
+            DEBUG_LOG("Dumping error causing packet:");
+            packet->hexlike();
+        }
+
+        if (sWorld.getConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET))
+        {
+            DETAIL_LOG("Disconnecting session [account id %u / address %s] for badly formatted packet.",
+                       GetAccountId(), GetRemoteAddress().c_str());
+
+            KickPlayer();
+        }
+    }
+
+    delete packet;
+}
+
+/// Whether one more received packet may be handled in the current update
+bool WorldSession::CanHandlePacket(uint32 processed, uint32 packetLimit, uint32 timeBudget, std::chrono::steady_clock::time_point startTime, bool& overBudget) const
+{
+    if (!m_Socket || m_Socket->IsClosed())
+        return false;
+
+    if (packetLimit && processed >= packetLimit)
+        return false;
+
+    // the first packet always runs, even a single slow handler must not stall the session
+    if (timeBudget && processed && std::chrono::steady_clock::now() - startTime >= std::chrono::microseconds(timeBudget))
+    {
+        overBudget = true;
+        return false;
+    }
+
+    return true;
+}
+
+/// Take a token from the bucket of a rate limited opcode, false if none is left
+bool WorldSession::ConsumeRateToken(uint16 opcode, uint32 now)
+{
+    OpcodeRateLimit const* limit = sWorld.GetOpcodeRateLimit(opcode);
+    if (!limit)
+        return true;
+
+    std::map<uint16, RateBucket>::iterator itr = m_rateBuckets.find(opcode);
+    if (itr == m_rateBuckets.end())
+    {
+        RateBucket bucket;
+        bucket.tokens = limit->burst;
+        bucket.lastRefill = now;
+        itr = m_rateBuckets.insert(std::make_pair(opcode, bucket)).first;
+    }
+
+    RateBucket& bucket = itr->second;
+    if (now != bucket.lastRefill)
+    {
+        bucket.tokens = std::min(limit->burst, bucket.tokens + limit->rate * WorldTimer::getMSTimeDiff(bucket.lastRefill, now) / IN_MILLISECONDS);
+        bucket.lastRefill = now;
+    }
+
+    if (bucket.tokens < 1.0f)
+        return false;
+
+    bucket.tokens -= 1.0f;
+    return true;
+}
+
+/// Keep a packet over its rate limit for a later update, or drop it if too many wait already
+void WorldSession::DeferPacket(WorldPacket* packet)
+{
+    if (m_deferredPackets.size() < sWorld.getConfig(CONFIG_UINT32_SESSION_MAX_DEFERRED))
+    {
+        m_deferredPackets.push_back(packet);
+        ++m_throttleCounters.deferred;
+        return;
+    }
+
+    DEBUG_LOG("SESSION: dropped rate limited opcode %s (0x%.4X) of account %u, %u packets deferred already",
+              packet->GetOpcodeName(), packet->GetOpcode(), GetAccountId(), uint32(m_deferredPackets.size()));
+
+    ++m_throttleCounters.dropped;
+    delete packet;
+}
+
+/// Log the throttling of the session, at most once per minute
+void WorldSession::LogThrottling(uint32 now)
+{
+    if (WorldTimer::getMSTimeDiff(m_throttleLogTime, now) < MINUTE * IN_MILLISECONDS)
+        return;
+
+    uint32 deferred = m_throttleCounters.deferred - m_throttleLogged.deferred;
+    uint32 dropped = m_throttleCounters.dropped - m_throttleLogged.dropped;
+    uint32 overBudget = m_throttleCounters.overBudget - m_throttleLogged.overBudget;
+    if (!deferred && !dropped && !overBudget)
+        return;
+
+    sLog.outString("SESSION: account %u (%s, player %s) throttled: %u packets deferred, %u dropped, %u updates over time budget",
+                   GetAccountId(), GetRemoteAddress().c_str(), GetPlayerName(), deferred, dropped, overBudget);
+
+    m_throttleLogged = m_throttleCounters;
+    m_throttleLogTime = now;
+}
+
 /// %Log the player out
 void WorldSession::LogoutPlayer(bool Save)
 {
@@ -700,7 +864,7 @@ void WorldSession::SetAccountData(AccountDataType type, time_t time_, const std:
         static SqlStatementID delId;
         static SqlStatementID insId;
 
-        CharacterDatabase.BeginTransaction();
+        CharacterDatabase.BeginTransaction(m_GUIDLow);
 
         SqlStatement stmt = CharacterDatabase.CreateStatement(delId, "DELETE FROM character_account_data WHERE guid=? AND type=?");
         stmt.PExecute(m_GUIDLow, uint32(type));
@@ -974,6 +1138,8 @@ void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* pac
     if (_player)
         _player->SetCanDelayTeleport(true);
 
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
     (this->*opHandle.handler)(*packet);
 
     if (_player)
@@ -987,6 +1153,8 @@ void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* pac
             _player->TeleportTo(_player->m_teleport_dest, _player->m_teleport_options);
     }
 
+    sOpcodeStats.CountHandled(packet->GetOpcode(), uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
+
     if (packet->rpos() < packet->wpos() && sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
         LogUnprocessedTail(packet);
 }
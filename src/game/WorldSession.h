@@ -28,7 +28,9 @@
 #include "ObjectGuid.h"
 #include "AuctionHouseMgr.h"
 #include "Item.h"
+#include "MPSCQueue.h"
 
+#include <chrono>
 #include <deque>
 #include <mutex>
 
@@ -45,6 +47,7 @@ class Object;
 class Player;
 class Unit;
 class WorldPacket;
+class SharedWorldPacket;
 class WorldSocket;
 class QueryResult;
 class LoginQueryHolder;
@@ -227,6 +230,16 @@ class WorldSessionFilter : public PacketFilter
         virtual bool Process(WorldPacket* packet) override;
 };
 
+/// Received packets held back by the session limits since login
+struct SessionThrottleCounters
+{
+    SessionThrottleCounters() : deferred(0), dropped(0), overBudget(0) {}
+
+    uint32 deferred;                                        // over the opcode rate limit, handled in a later update
+    uint32 dropped;                                         // over the opcode rate limit with the deferred queue full
+    uint32 overBudget;                                      // updates stopped by Network.SessionTimeBudget with packets left
+};
+
 /// Player session in the World
 class MANGOS_DLL_SPEC WorldSession
 {
@@ -246,6 +259,8 @@ class MANGOS_DLL_SPEC WorldSession
         void SendAddonsInfo();
 
         void SendPacket(WorldPacket const* packet);
+        void SendPacket(SharedWorldPacket const& packet);   // same data for many sessions, not copied per socket
+        void SendPackets(std::vector<SharedWorldPacket> const& packets);
         void SendNotification(const char* format, ...) ATTR_PRINTF(2, 3);
         void SendNotification(int32 string_id, ...);
         void SendPetNameInvalid(uint32 error, const std::string& name, DeclinedName* declinedName);
@@ -291,6 +306,9 @@ class MANGOS_DLL_SPEC WorldSession
         void KickPlayer();
 
         void QueuePacket(WorldPacket* new_packet);
+        size_t GetRecvQueueSize() const { return m_recvQueue.size(); }
+        size_t GetDeferredQueueSize() const { return m_deferredPackets.size(); }
+        SessionThrottleCounters const& GetThrottleCounters() const { return m_throttleCounters; }
 
         bool Update(PacketFilter& updater);
 
@@ -883,8 +901,15 @@ class MANGOS_DLL_SPEC WorldSession
         bool VerifyMovementInfo(MovementInfo const& movementInfo, ObjectGuid const& guid) const;
         void HandleMoverRelocation(MovementInfo& movementInfo);
 
+        void HandlePacket(WorldPacket* packet);
         void ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* packet);
 
+        // received packet limits
+        bool CanHandlePacket(uint32 processed, uint32 packetLimit, uint32 timeBudget, std::chrono::steady_clock::time_point startTime, bool& overBudget) const;
+        bool ConsumeRateToken(uint16 opcode, uint32 now);
+        void DeferPacket(WorldPacket* packet);
+        void LogThrottling(uint32 now);
+
         // logging helper
         void LogUnexpectedOpcode(WorldPacket* packet, const char* reason);
         void LogUnprocessedTail(WorldPacket* packet);
@@ -913,8 +938,19 @@ class MANGOS_DLL_SPEC WorldSession
         TutorialDataState m_tutorialState;
         AddonsList m_addonsList;
 
-        std::mutex m_recvQueueLock;
-        std::deque<WorldPacket *> m_recvQueue;
+        MPSCQueue<WorldPacket*> m_recvQueue;                // added by the network thread without waiting for Update()
+
+        struct RateBucket
+        {
+            float tokens;
+            uint32 lastRefill;
+        };
+
+        std::deque<WorldPacket*> m_deferredPackets;         // over the rate limit of their opcode, oldest first
+        std::map<uint16, RateBucket> m_rateBuckets;         // only for the rate limited opcodes the client sent
+        SessionThrottleCounters m_throttleCounters;
+        SessionThrottleCounters m_throttleLogged;           // counters at the previous throttle log line
+        uint32 m_throttleLogTime;
 };
 #endif
 /// @}
@@ -36,6 +36,7 @@
 #include "SharedDefines.h"
 #include "ByteBuffer.h"
 #include "Opcodes.h"
+#include "OpcodeStats.h"
 #include "Database/DatabaseEnv.h"
 #include "Auth/Sha1.h"
 #include "WorldSession.h"
@@ -99,6 +100,13 @@ struct ClientPktHeader
 #pragma pack(pop)
 #endif
 
+/// Shared packets up to this size are copied into the output buffer instead of being referenced
+static const size_t SHARED_PACKET_COPY_LIMIT = 512;
+/// Packets queued for a socket at most (bytes), client is dropped when reached
+static const size_t MAX_OUTPUT_QUEUE_SIZE = 8 * 1024 * 1024;
+/// Buffers gathered for one send call
+static const int MAX_OUTPUT_IOVECS = 64;
+
 WorldSocket::WorldSocket(void) :
     WorldHandler(),
     m_LastPingTime(ACE_Time_Value::zero),
@@ -109,13 +117,14 @@ WorldSocket::WorldSocket(void) :
     m_Header(sizeof(ClientPktHeader)),
     m_OutBuffer(0),
     m_OutBufferSize(65536),
+    m_OutQueueSize(0),
+    m_PlainQueued(0),
     m_OutActive(false),
+    m_FlushRequested(false),
+    m_NetThread(nullptr),
     m_Seed(static_cast<uint32>(rand32()))
 {
     reference_counting_policy().value(ACE_Event_Handler::Reference_Counting_Policy::ENABLED);
-
-    msg_queue()->high_water_mark(8 * 1024 * 1024);
-    msg_queue()->low_water_mark(8 * 1024 * 1024);
 }
 
 WorldSocket::~WorldSocket(void)
@@ -145,6 +154,9 @@ void WorldSocket::CloseSocket(void)
 
         closing_ = true;
         peer().close_writer();
+
+        // network thread drops the socket
+        RequestFlush();
     }
 
     {
@@ -169,39 +181,137 @@ int WorldSocket::SendPacket(const WorldPacket& pct)
     // Dump outgoing packet.
     sLog.outWorldPacketDump(uint32(get_handle()), pct.GetOpcode(), pct.GetOpcodeName(), &pct, false);
 
-    ServerPktHeader header(pct.size() + 2, pct.GetOpcode());
-    m_Crypt.EncryptSend((uint8*)header.header, header.getHeaderLength());
+    const uint8* data = pct.empty() ? nullptr : pct.contents();
 
-    if (m_OutBuffer->space() >= pct.size() + header.getHeaderLength() && msg_queue()->is_empty())
+    if (!AppendToOutBuffer(pct.GetOpcode(), data, pct.size()))
     {
-        // Put the packet on the buffer.
-        if (m_OutBuffer->copy((char*) header.header, header.getHeaderLength()) == -1)
-            MANGOS_ASSERT(false);
-
-        if (!pct.empty())
-            if (m_OutBuffer->copy((char*) pct.contents(), pct.size()) == -1)
-                MANGOS_ASSERT(false);
+        // the packet belongs to the caller, queue a copy
+        if (QueueOutgoing(pct.GetOpcode(), data ? std::make_shared<std::vector<uint8> const>(data, data + pct.size()) : std::make_shared<std::vector<uint8> const>()) == -1)
+            return -1;
     }
-    else
-    {
-        // Enqueue the packet.
-        ACE_Message_Block* mb;
 
-        ACE_NEW_RETURN(mb, ACE_Message_Block(pct.size() + header.getHeaderLength()), -1);
+    RequestFlush();
+    return 0;
+}
 
-        mb->copy((char*) header.header, header.getHeaderLength());
+int WorldSocket::SendPacket(const SharedWorldPacket& pct)
+{
+    std::lock_guard<std::mutex> guard(m_OutBufferLock);
 
-        if (!pct.empty())
-            mb->copy((const char*)pct.contents(), pct.size());
+    if (closing_)
+        return -1;
 
-        if (msg_queue()->enqueue_tail(mb, (ACE_Time_Value*)&ACE_Time_Value::zero) == -1)
-        {
-            sLog.outError("WorldSocket::SendPacket enqueue_tail");
-            mb->release();
+    if (SendSharedPacket(pct) == -1)
+        return -1;
+
+    RequestFlush();
+    return 0;
+}
+
+int WorldSocket::SendPackets(const std::vector<SharedWorldPacket>& packets)
+{
+    std::lock_guard<std::mutex> guard(m_OutBufferLock);
+
+    if (closing_)
+        return -1;
+
+    for (std::vector<SharedWorldPacket>::const_iterator itr = packets.begin(); itr != packets.end(); ++itr)
+        if (SendSharedPacket(*itr) == -1)
             return -1;
-        }
+
+    RequestFlush();
+    return 0;
+}
+
+int WorldSocket::SendSharedPacket(const SharedWorldPacket& pct)
+{
+    // Dump outgoing packet.
+    sLog.outWorldPacketDump(uint32(get_handle()), pct.GetOpcode(), pct.GetOpcodeName(), pct.contents(), pct.size(), false);
+
+    // small packets are cheaper to merge into the output buffer than to send separately
+    if (pct.size() <= SHARED_PACKET_COPY_LIMIT && AppendToOutBuffer(pct.GetOpcode(), pct.contents(), pct.size()))
+        return 0;
+
+    return QueueOutgoing(pct.GetOpcode(), pct.GetData());
+}
+
+bool WorldSocket::AppendToOutBuffer(uint16 opcode, const uint8* data, size_t size)
+{
+    ServerPktHeader header(size + 2, opcode);
+
+    if (!m_OutQueue.empty() || m_OutBuffer->space() < size + header.getHeaderLength())
+        return false;
+
+    // encrypted with the other headers when written
+    m_PlainHeaders.push_back(std::make_pair(size_t(m_OutBuffer->wr_ptr() - m_OutBuffer->base()), header.getHeaderLength()));
+
+    // Put the packet on the buffer.
+    if (m_OutBuffer->copy((char*) header.header, header.getHeaderLength()) == -1)
+        MANGOS_ASSERT(false);
+
+    if (size)
+        if (m_OutBuffer->copy((const char*) data, size) == -1)
+            MANGOS_ASSERT(false);
+
+    sOpcodeStats.CountSent(opcode, header.getHeaderLength() + size);
+    return true;
+}
+
+void WorldSocket::EncryptHeaders(void)
+{
+    if (m_PlainHeaders.empty() && !m_PlainQueued)
+        return;
+
+    // buffer content goes out before the queue, so this is stream order
+    m_CryptBuffers.clear();
+
+    for (std::vector<std::pair<size_t, uint8> >::const_iterator itr = m_PlainHeaders.begin(); itr != m_PlainHeaders.end(); ++itr)
+        m_CryptBuffers.push_back(std::make_pair((uint8*)m_OutBuffer->base() + itr->first, size_t(itr->second)));
+
+    for (std::deque<OutgoingPacket>::iterator itr = m_OutQueue.end() - m_PlainQueued; itr != m_OutQueue.end(); ++itr)
+        m_CryptBuffers.push_back(std::make_pair(itr->header, size_t(itr->headerSize)));
+
+    m_Crypt.EncryptSend(m_CryptBuffers);
+
+    m_PlainHeaders.clear();
+    m_PlainQueued = 0;
+}
+
+void WorldSocket::RequestFlush(void)
+{
+    // a socket registered for output is written by the reactor, unless it is closing and has to be dropped
+    if (m_FlushRequested || (m_OutActive && !closing_) || !m_NetThread)
+        return;
+
+    m_FlushRequested = true;
+
+    // released by the network thread after the flush
+    AddReference();
+    sWorldSocketMgr.RequestFlush(this);
+}
+
+int WorldSocket::QueueOutgoing(uint16 opcode, const PacketData& data)
+{
+    ServerPktHeader header(data->size() + 2, opcode);
+
+    if (m_OutQueueSize + header.getHeaderLength() + data->size() > MAX_OUTPUT_QUEUE_SIZE)
+    {
+        sLog.outError("WorldSocket::SendPacket: output queue of %s is full", GetRemoteAddress().c_str());
+        return -1;
     }
 
+    OutgoingPacket packet;
+    memcpy(packet.header, header.header, header.getHeaderLength());
+    packet.headerSize = header.getHeaderLength();
+    packet.data = data;
+    packet.sent = 0;
+
+    m_OutQueue.push_back(packet);
+    m_OutQueueSize += packet.headerSize + data->size();
+    ++m_PlainQueued;
+
+    sOpcodeStats.CountSent(opcode, packet.headerSize + data->size());
+
     return 0;
 }
 
@@ -223,6 +333,8 @@ int WorldSocket::open(void* a)
     if (m_OutBuffer)
         return -1;
 
+    m_AcceptTime = std::chrono::steady_clock::now();
+
     // This will also prevent the socket from being Updated
     // while we are initializing it.
     m_OutActive = true;
@@ -328,15 +440,56 @@ int WorldSocket::handle_output(ACE_HANDLE)
     if (closing_)
         return -1;
 
-    const size_t send_len = m_OutBuffer->length();
+    EncryptHeaders();
+
+    // gather output buffer and queued packets for one scatter send
+    iovec iov[MAX_OUTPUT_IOVECS];
+    int iovCount = 0;
+    size_t send_len = 0;
+
+    if (m_OutBuffer->length() > 0)
+    {
+        iov[iovCount].iov_base = m_OutBuffer->rd_ptr();
+        iov[iovCount].iov_len = m_OutBuffer->length();
+        send_len += m_OutBuffer->length();
+        ++iovCount;
+    }
+
+    for (std::deque<OutgoingPacket>::iterator itr = m_OutQueue.begin(); itr != m_OutQueue.end() && iovCount + 2 <= MAX_OUTPUT_IOVECS; ++itr)
+    {
+        size_t offset = itr->sent;
+
+        if (offset < itr->headerSize)
+        {
+            iov[iovCount].iov_base = (char*)(itr->header + offset);
+            iov[iovCount].iov_len = itr->headerSize - offset;
+            send_len += itr->headerSize - offset;
+            ++iovCount;
+            offset = itr->headerSize;
+        }
+
+        size_t dataOffset = offset - itr->headerSize;
+        if (dataOffset < itr->data->size())
+        {
+            iov[iovCount].iov_base = (char*)(&(*itr->data)[dataOffset]);
+            iov[iovCount].iov_len = itr->data->size() - dataOffset;
+            send_len += itr->data->size() - dataOffset;
+            ++iovCount;
+        }
+    }
 
     if (send_len == 0)
-        return handle_output_queue(guard);
+        return cancel_wakeup_output(guard);
 
 #ifdef MSG_NOSIGNAL
-    ssize_t n = peer().send(m_OutBuffer->rd_ptr(), send_len, MSG_NOSIGNAL);
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iovCount;
+
+    ssize_t n = ACE_OS::sendmsg(get_handle(), &msg, MSG_NOSIGNAL);
 #else
-    ssize_t n = peer().send(m_OutBuffer->rd_ptr(), send_len);
+    ssize_t n = peer().sendv(iov, iovCount);
 #endif // MSG_NOSIGNAL
 
     if (n == 0)
@@ -348,84 +501,45 @@ int WorldSocket::handle_output(ACE_HANDLE)
 
         return -1;
     }
-    else if (n < (ssize_t)send_len) // now n > 0
-    {
-        m_OutBuffer->rd_ptr(static_cast<size_t>(n));
 
-        // move the data to the base of the buffer
-        m_OutBuffer->crunch();
+    ConsumeOutput(static_cast<size_t>(n));
 
+    if (n < (ssize_t)send_len)                              // kernel buffer is full
         return schedule_wakeup_output(guard);
-    }
-    else // now n == send_len
-    {
-        m_OutBuffer->reset();
-
-        return handle_output_queue(guard);
-    }
 
-    ACE_NOTREACHED(return 0);
+    // everything gathered was sent, more packets may be queued behind the iovec limit
+    return m_OutQueue.empty() ? cancel_wakeup_output(guard) : ACE_Event_Handler::WRITE_MASK;
 }
 
-int WorldSocket::handle_output_queue(GuardType& g)
+void WorldSocket::ConsumeOutput(size_t sent)
 {
-    if (msg_queue()->is_empty())
-        return cancel_wakeup_output(g);
-
-    ACE_Message_Block* mblk;
-
-    if (msg_queue()->dequeue_head(mblk, (ACE_Time_Value*)&ACE_Time_Value::zero) == -1)
-    {
-        sLog.outError("WorldSocket::handle_output_queue dequeue_head");
-        return -1;
-    }
-
-    const size_t send_len = mblk->length();
-
-#ifdef MSG_NOSIGNAL
-    ssize_t n = peer().send(mblk->rd_ptr(), send_len, MSG_NOSIGNAL);
-#else
-    ssize_t n = peer().send(mblk->rd_ptr(), send_len);
-#endif // MSG_NOSIGNAL
-
-    if (n == 0)
+    size_t fromBuffer = std::min(sent, m_OutBuffer->length());
+    if (fromBuffer > 0)
     {
-        mblk->release();
+        m_OutBuffer->rd_ptr(fromBuffer);
+        sent -= fromBuffer;
 
-        return -1;
+        if (m_OutBuffer->length() == 0)
+            m_OutBuffer->reset();
+        else
+            m_OutBuffer->crunch();                          // move the data to the base of the buffer
     }
-    else if (n == -1)
-    {
-        if (errno == EWOULDBLOCK || errno == EAGAIN)
-        {
-            msg_queue()->enqueue_head(mblk, (ACE_Time_Value*) &ACE_Time_Value::zero);
-            return schedule_wakeup_output(g);
-        }
 
-        mblk->release();
-        return -1;
-    }
-    else if (n < (ssize_t)send_len) // now n > 0
+    while (sent > 0 && !m_OutQueue.empty())
     {
-        mblk->rd_ptr(static_cast<size_t>(n));
+        OutgoingPacket& packet = m_OutQueue.front();
+        size_t total = packet.headerSize + packet.data->size();
 
-        if (msg_queue()->enqueue_head(mblk, (ACE_Time_Value*) &ACE_Time_Value::zero) == -1)
+        if (sent < total - packet.sent)
         {
-            sLog.outError("WorldSocket::handle_output_queue enqueue_head");
-            mblk->release();
-            return -1;
+            packet.sent += sent;
+            break;
         }
 
-        return schedule_wakeup_output(g);
-    }
-    else // now n == send_len
-    {
-        mblk->release();
-
-        return msg_queue()->is_empty() ? cancel_wakeup_output(g) : ACE_Event_Handler::WRITE_MASK;
+        sent -= total - packet.sent;
+        m_OutQueueSize -= total;
+        m_OutQueue.pop_front();
     }
-
-    ACE_NOTREACHED(return -1);
 }
 
 int WorldSocket::handle_close(ACE_HANDLE h, ACE_Reactor_Mask)
@@ -438,6 +552,9 @@ int WorldSocket::handle_close(ACE_HANDLE h, ACE_Reactor_Mask)
 
         if (h == ACE_INVALID_HANDLE)
             peer().close_writer();
+
+        // network thread drops the socket
+        RequestFlush();
     }
 
     // Critical section
@@ -456,7 +573,7 @@ int WorldSocket::Update(void)
     if (closing_)
         return -1;
 
-    if (m_OutActive || (m_OutBuffer->length() == 0 && msg_queue()->is_empty()))
+    if (m_OutActive || (m_OutBuffer->length() == 0 && m_OutQueue.empty()))
         return 0;
 
     int ret;
@@ -467,6 +584,17 @@ int WorldSocket::Update(void)
     return ret;
 }
 
+int WorldSocket::Flush(void)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_OutBufferLock);
+
+        m_FlushRequested = false;
+    }
+
+    return Update();
+}
+
 int WorldSocket::handle_input_header(void)
 {
     MANGOS_ASSERT(m_RecvWPct == nullptr);
@@ -684,6 +812,8 @@ int WorldSocket::ProcessIncoming(WorldPacket* new_pct)
     // Dump received packet.
     sLog.outWorldPacketDump(uint32(get_handle()), new_pct->GetOpcode(), new_pct->GetOpcodeName(), new_pct, true);
 
+    sOpcodeStats.CountReceived(opcode, sizeof(ClientPktHeader) + new_pct->size());
+
     try
     {
         switch (opcode)
@@ -948,7 +1078,13 @@ int WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
     // NOTE ATM the socket is single-threaded, have this in mind ...
     ACE_NEW_RETURN(m_Session, WorldSession(id, this, AccountTypes(security), expansion, mutetime, locale), -1);
 
-    m_Crypt.Init(&K);
+    {
+        // headers written until now stay unencrypted, all later ones are encrypted
+        GuardType guard(m_OutBufferLock);
+
+        EncryptHeaders();
+        m_Crypt.Init(&K);
+    }
 
     m_Session->LoadGlobalAccountData();
     m_Session->LoadTutorialsData();
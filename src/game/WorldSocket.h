@@ -41,15 +41,59 @@
 #include "Auth/AuthCrypt.h"
 #include "Auth/BigNumber.h"
 
+#include <chrono>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 class ACE_Message_Block;
 class WorldPacket;
+class SharedWorldPacket;
 class WorldSession;
+class ReactorRunnable;
 
 /// Handler that can communicate over stream sockets.
 typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> WorldHandler;
 
+/// Passive socket that can share its port with the acceptors of other network threads (SO_REUSEPORT).
+class WorldSocketAcceptor : public ACE_SOCK_Acceptor
+{
+    public:
+        WorldSocketAcceptor() : m_ReusePort(false) {}
+
+        /// Must be called before open(), the kernel then spreads new connections over all sockets listening on the port
+        void SetReusePort(bool reusePort) { m_ReusePort = reusePort; }
+
+        int open(const ACE_Addr& local_sap, int reuse_addr = 0, int protocol_family = PF_UNSPEC, int backlog = ACE_DEFAULT_BACKLOG, int protocol = 0)
+        {
+            if (!m_ReusePort)
+                return ACE_SOCK_Acceptor::open(local_sap, reuse_addr, protocol_family, backlog, protocol);
+
+            if (local_sap != ACE_Addr::sap_any)
+                protocol_family = local_sap.get_type();
+            else if (protocol_family == PF_UNSPEC)
+                protocol_family = PF_INET;
+
+            if (ACE_SOCK::open(SOCK_STREAM, protocol_family, protocol, reuse_addr) == -1)
+                return -1;
+
+#ifdef SO_REUSEPORT
+            int one = 1;
+            if (set_option(SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) == -1)
+            {
+                close();
+                return -1;
+            }
+#endif
+
+            return shared_open(local_sap, protocol_family, backlog);
+        }
+
+    private:
+        bool m_ReusePort;
+};
+
 /**
  * WorldSocket.
  *
@@ -59,16 +103,19 @@ typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> WorldHandler;
  * The class uses reference counting.
  *
  * For output the class uses one buffer (64K usually) and
- * a queue where it stores packet if there is no place on
- * the queue. The reason this is done, is because the server
+ * a queue where it stores packet if there is no place in
+ * the buffer. The reason this is done, is because the server
  * does really a lot of small-size writes to it, and it doesn't
- * scale well to allocate memory for every. When something is
+ * scale well to allocate memory for every. Queued packets keep
+ * a reference to their (possibly shared with other sockets)
+ * data instead of a copy, and buffer and queue are written
+ * with one scatter send. When something is
  * written to the output buffer the socket is not immediately
- * activated for output (again for the same reason), there
- * is 10ms celling (thats why there is Update() override method).
- * This concept is similar to TCP_CORK, but TCP_CORK
- * uses 200ms celling. As result overhead generated by
- * sending packets from "producer" threads is minimal,
+ * activated for output (again for the same reason), instead
+ * the network thread of the socket is asked once to flush it,
+ * and writes everything gathered until it gets to it (thats
+ * why there is Update() override method). As result overhead
+ * generated by sending packets from "producer" threads is minimal,
  * and doing a lot of writes with small size is tolerated.
  *
  * The calls to Update () method are managed by WorldSocketMgr
@@ -90,12 +137,12 @@ class WorldSocket : protected WorldHandler
 {
     public:
         /// Declare some friends
-        friend class ACE_Acceptor< WorldSocket, ACE_SOCK_ACCEPTOR >;
+        friend class ACE_Acceptor< WorldSocket, WorldSocketAcceptor >;
         friend class WorldSocketMgr;
         friend class ReactorRunnable;
 
         /// Declare the acceptor for this class
-        typedef ACE_Acceptor< WorldSocket, ACE_SOCK_ACCEPTOR > Acceptor;
+        typedef ACE_Acceptor< WorldSocket, WorldSocketAcceptor > Acceptor;
 
         /// Mutex type used for various synchronizations.
         typedef std::mutex LockType;
@@ -115,6 +162,16 @@ class WorldSocket : protected WorldHandler
         /// @return -1 of failure
         int SendPacket(const WorldPacket& pct);
 
+        /// Send a packet whose data is shared with other sockets, this function is reentrant.
+        /// @param pct packet to send, its data is referenced until written
+        /// @return -1 of failure
+        int SendPacket(const SharedWorldPacket& pct);
+
+        /// Send several shared packets taking the output lock once, this function is reentrant.
+        /// @param packets packets to send in order
+        /// @return -1 of failure
+        int SendPackets(const std::vector<SharedWorldPacket>& packets);
+
         /// Add reference to this object.
         long AddReference(void);
 
@@ -148,6 +205,9 @@ class WorldSocket : protected WorldHandler
         /// Called by WorldSocketMgr/ReactorRunnable.
         int Update(void);
 
+        /// Called by ReactorRunnable for a flush asked by RequestFlush().
+        int Flush(void);
+
     private:
         /// Helper functions for processing incoming data.
         int handle_input_header(void);
@@ -159,8 +219,27 @@ class WorldSocket : protected WorldHandler
         int cancel_wakeup_output(GuardType& g);
         int schedule_wakeup_output(GuardType& g);
 
-        /// Drain the queue if its not empty.
-        int handle_output_queue(GuardType& g);
+        /// Data of a queued packet, taken as reference
+        typedef std::shared_ptr<std::vector<uint8> const> PacketData;
+
+        /// Copy packet with encrypted header to the output buffer if it fits and nothing is queued.
+        /// @return false if the packet must be queued instead
+        bool AppendToOutBuffer(uint16 opcode, const uint8* data, size_t size);
+
+        /// Write shared packet to the output buffer or queue, m_OutBufferLock must be held.
+        int SendSharedPacket(const SharedWorldPacket& pct);
+
+        /// Queue packet with encrypted header after everything already waiting for output.
+        int QueueOutgoing(uint16 opcode, const PacketData& data);
+
+        /// Drop bytes that were sent from the output buffer and the queue.
+        void ConsumeOutput(size_t sent);
+
+        /// Ask the network thread to write the output soon, m_OutBufferLock must be held.
+        void RequestFlush(void);
+
+        /// Encrypt headers of everything added since the last write with one cipher call, m_OutBufferLock must be held.
+        void EncryptHeaders(void);
 
         /// process one incoming packet.
         /// @param new_pct received packet ,note that you need to delete it.
@@ -211,9 +290,42 @@ class WorldSocket : protected WorldHandler
         /// Size of the m_OutBuffer.
         size_t m_OutBufferSize;
 
+        /// Packet which did not fit into m_OutBuffer.
+        struct OutgoingPacket
+        {
+            uint8 header[5];                                // encrypted before the first write
+            uint8 headerSize;
+            PacketData data;
+            size_t sent;                                    // bytes of header and data already written
+        };
+
+        /// Packets waiting for output after the content of m_OutBuffer.
+        std::deque<OutgoingPacket> m_OutQueue;
+
+        /// Total size of the packets in m_OutQueue.
+        size_t m_OutQueueSize;
+
+        /// Offset and size of headers in m_OutBuffer that are not encrypted yet.
+        std::vector<std::pair<size_t, uint8> > m_PlainHeaders;
+
+        /// Number of packets at the end of m_OutQueue whose header is not encrypted yet.
+        size_t m_PlainQueued;
+
+        /// Reused list of headers passed to AuthCrypt.
+        AuthCrypt::BufferList m_CryptBuffers;
+
         /// True if the socket is registered with the reactor for output
         bool m_OutActive;
 
+        /// True if the network thread was asked to call Flush()
+        bool m_FlushRequested;
+
+        /// Network thread handling the socket
+        ReactorRunnable* m_NetThread;
+
+        /// Time the connection was accepted
+        std::chrono::steady_clock::time_point m_AcceptTime;
+
         uint32 m_Seed;
 
         BigNumber m_s;
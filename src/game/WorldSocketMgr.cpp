@@ -43,21 +43,36 @@
 #include "Config/Config.h"
 #include "Database/DatabaseEnv.h"
 #include "WorldSocket.h"
+#include "OpcodeStats.h"
 #include "Policies/Lock.h"
 
+/// Sockets of a thread are all looked at this often (ms), in case a flush request was missed
+static const int SOCKET_SWEEP_INTERVAL = 1000;
+/// A connection stays on the thread that accepted it unless that has this many connections more than the least loaded one
+static const long ACCEPT_AFFINITY_SLACK = 16;
+
 /**
 * This is a helper class to WorldSocketMgr ,that manages
-* network threads, and assigning connections from acceptor thread
+* network threads, and assigning connections from acceptor threads
 * to other network threads
+*
+* The thread sleeps in the reactor until socket events arrive or
+* another thread notifies it about new sockets or sockets with
+* output waiting to be written.
 */
 class ReactorRunnable : protected ACE_Task_Base
 {
     public:
         ReactorRunnable() :
             m_Reactor(0),
-            m_ThreadId(-1)
+            m_ThreadId(-1),
+            m_Acceptor(0),
+            m_NotifyPending(false)
         {
             m_Connections = 0;
+            m_Accepted = 0;
+            m_AcceptLatencySum = 0;
+            m_AcceptLatencyMax = 0;
             ACE_Reactor_Impl* imp = 0;
 
 #if defined (ACE_HAS_EVENT_POLL) || defined (ACE_HAS_DEV_POLL)
@@ -82,9 +97,32 @@ class ReactorRunnable : protected ACE_Task_Base
             Stop();
             Wait();
 
+            delete m_Acceptor;
             delete m_Reactor;
         }
 
+        /// Accept connections in this thread
+        int Listen(ACE_INET_Addr const& addr, bool reusePort)
+        {
+            WorldSocket::Acceptor* acc = new WorldSocket::Acceptor;
+            m_Acceptor = acc;
+
+            acc->acceptor().SetReusePort(reusePort);
+
+            return acc->open(addr, m_Reactor, ACE_NONBLOCK);
+        }
+
+        void StopListen()
+        {
+            if (m_Acceptor)
+                m_Acceptor->close();
+        }
+
+        bool IsListening() const
+        {
+            return m_Acceptor != nullptr;
+        }
+
         void Stop()
         {
             m_Reactor->end_reactor_event_loop();
@@ -112,25 +150,69 @@ class ReactorRunnable : protected ACE_Task_Base
             ++m_Connections;
             sock->AddReference();
             sock->reactor(m_Reactor);
+            sock->m_NetThread = this;
             m_NewSockets.insert(sock);
 
+            NotifyLocked();
             return 0;
         }
 
+        /// Called with a reference of the socket that is released after the flush
+        void RequestFlush(WorldSocket* sock)
+        {
+            std::lock_guard<std::mutex> guard(m_NewSockets_Lock);
+
+            m_FlushSockets.push_back(sock);
+
+            NotifyLocked();
+        }
+
         ACE_Reactor* GetReactor()
         {
             return m_Reactor;
         }
 
-    protected:
-        void AddNewSockets()
+        void GetStats(NetworkThreadStats& stats) const
         {
-            std::lock_guard<std::mutex> guard(m_NewSockets_Lock);
+            stats.connections = uint32(m_Connections);
+            stats.listening = IsListening();
+            stats.accepted = m_Accepted;
+            stats.avgAcceptLatency = stats.accepted ? uint32(m_AcceptLatencySum / stats.accepted) : 0;
+            stats.maxAcceptLatency = m_AcceptLatencyMax;
+        }
 
-            if (m_NewSockets.empty())
+    protected:
+        /// Wake the thread up, one notification at a time is enough, m_NewSockets_Lock must be held
+        void NotifyLocked()
+        {
+            if (m_NotifyPending)
                 return;
 
-            for (SocketSet::const_iterator i = m_NewSockets.begin(); i != m_NewSockets.end(); ++i)
+            m_NotifyPending = true;
+            m_Reactor->notify(this, ACE_Event_Handler::EXCEPT_MASK);
+        }
+
+        /// Called in the thread by notify()
+        int handle_exception(ACE_HANDLE) override
+        {
+            ProcessRequests();
+            return 0;
+        }
+
+        void ProcessRequests()
+        {
+            SocketSet newSockets;
+            std::vector<WorldSocket*> flushSockets;
+
+            {
+                std::lock_guard<std::mutex> guard(m_NewSockets_Lock);
+
+                m_NotifyPending = false;
+                newSockets.swap(m_NewSockets);
+                flushSockets.swap(m_FlushSockets);
+            }
+
+            for (SocketSet::const_iterator i = newSockets.begin(); i != newSockets.end(); ++i)
             {
                 WorldSocket* sock = (*i);
 
@@ -140,10 +222,36 @@ class ReactorRunnable : protected ACE_Task_Base
                     --m_Connections;
                 }
                 else
+                {
                     m_Sockets.insert(sock);
+
+                    uint64 latency = uint64(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sock->m_AcceptTime).count());
+                    m_AcceptLatencySum += latency;
+                    if (latency > m_AcceptLatencyMax)
+                        m_AcceptLatencyMax = uint32(latency);
+                    ++m_Accepted;
+                }
             }
 
-            m_NewSockets.clear();
+            for (std::vector<WorldSocket*>::const_iterator i = flushSockets.begin(); i != flushSockets.end(); ++i)
+            {
+                if ((*i)->Flush() == -1)
+                    DropSocket(*i);
+
+                (*i)->RemoveReference();
+            }
+        }
+
+        void DropSocket(WorldSocket* sock)
+        {
+            SocketSet::iterator i = m_Sockets.find(sock);
+            if (i == m_Sockets.end())
+                return;                                     // already dropped
+
+            m_Sockets.erase(i);
+            sock->CloseSocket();
+            sock->RemoveReference();
+            --m_Connections;
         }
 
         virtual int svc()
@@ -160,12 +268,14 @@ class ReactorRunnable : protected ACE_Task_Base
             {
                 // dont be too smart to move this outside the loop
                 // the run_reactor_event_loop will modify interval
-                ACE_Time_Value interval(0, 10000);
+                ACE_Time_Value interval(0, SOCKET_SWEEP_INTERVAL * 1000);
 
                 if (m_Reactor->run_reactor_event_loop(interval) == -1)
                     break;
 
-                AddNewSockets();
+                ProcessRequests();
+
+                sOpcodeStats.Flush();
 
                 for (i = m_Sockets.begin(); i != m_Sockets.end();)
                 {
@@ -197,10 +307,18 @@ class ReactorRunnable : protected ACE_Task_Base
         std::atomic_int m_Connections;
         int m_ThreadId;
 
+        WorldSocket::Acceptor* m_Acceptor;
+
         SocketSet m_Sockets;
 
         SocketSet m_NewSockets;
+        std::vector<WorldSocket*> m_FlushSockets;
+        bool m_NotifyPending;
         std::mutex m_NewSockets_Lock;
+
+        std::atomic<uint64> m_Accepted;
+        std::atomic<uint64> m_AcceptLatencySum;
+        std::atomic<uint32> m_AcceptLatencyMax;
 };
 
 INSTANTIATE_SINGLETON_1(WorldSocketMgr);
@@ -208,17 +326,17 @@ INSTANTIATE_SINGLETON_1(WorldSocketMgr);
 WorldSocketMgr::WorldSocketMgr():
     m_NetThreads(0),
     m_NetThreadsCount(0),
+    m_FirstSocketThread(1),
+    m_ReusePort(false),
     m_SockOutKBuff(-1),
     m_SockOutUBuff(65536),
-    m_UseNoDelay(true),
-    m_Acceptor(0)
+    m_UseNoDelay(true)
 {
 }
 
 WorldSocketMgr::~WorldSocketMgr()
 {
     delete[] m_NetThreads;
-    delete m_Acceptor;
 }
 
 int WorldSocketMgr::StartReactiveIO(uint16 port, const char* address)
@@ -233,7 +351,15 @@ int WorldSocketMgr::StartReactiveIO(uint16 port, const char* address)
         return -1;
     }
 
-    m_NetThreadsCount = static_cast<size_t>(num_threads + 1);
+#ifdef SO_REUSEPORT
+    m_ReusePort = sConfig.GetBoolDefault("Network.ReusePort", false);
+#else
+    m_ReusePort = false;
+#endif
+
+    // with SO_REUSEPORT every thread accepts, otherwise one more thread does only that
+    m_FirstSocketThread = m_ReusePort ? 0 : 1;
+    m_NetThreadsCount = static_cast<size_t>(num_threads) + m_FirstSocketThread;
 
     m_NetThreads = new ReactorRunnable[m_NetThreadsCount];
 
@@ -250,17 +376,20 @@ int WorldSocketMgr::StartReactiveIO(uint16 port, const char* address)
         return -1;
     }
 
-    WorldSocket::Acceptor* acc = new WorldSocket::Acceptor;
-    m_Acceptor = acc;
-
     ACE_INET_Addr listen_addr(port, address);
 
-    if (acc->open(listen_addr, m_NetThreads[0].GetReactor(), ACE_NONBLOCK) == -1)
+    for (size_t i = 0; i < (m_ReusePort ? m_NetThreadsCount : 1); ++i)
     {
-        sLog.outError("Failed to open acceptor, check if the port is free");
-        return -1;
+        if (m_NetThreads[i].Listen(listen_addr, m_ReusePort) == -1)
+        {
+            sLog.outError("Failed to open acceptor, check if the port is free");
+            return -1;
+        }
     }
 
+    if (m_ReusePort)
+        BASIC_LOG("Network threads accept connections on their own sockets (SO_REUSEPORT)");
+
     for (size_t i = 0; i < m_NetThreadsCount; ++i)
         m_NetThreads[i].Start();
 
@@ -283,16 +412,11 @@ int WorldSocketMgr::StartNetwork(uint16 port, std::string& address)
 
 void WorldSocketMgr::StopNetwork()
 {
-    if (m_Acceptor)
-    {
-        WorldSocket::Acceptor* acc = dynamic_cast<WorldSocket::Acceptor*>(m_Acceptor);
-
-        if (acc)
-            acc->close();
-    }
-
     if (m_NetThreadsCount != 0)
     {
+        for (size_t i = 0; i < m_NetThreadsCount; ++i)
+            m_NetThreads[i].StopListen();
+
         for (size_t i = 0; i < m_NetThreadsCount; ++i)
             m_NetThreads[i].Stop();
     }
@@ -336,14 +460,39 @@ int WorldSocketMgr::OnSocketOpen(WorldSocket* sock)
     sock->m_OutBufferSize = static_cast<size_t>(m_SockOutUBuff);
 
     // we skip the Acceptor Thread
-    size_t min = 1;
+    size_t min = m_FirstSocketThread;
 
-    MANGOS_ASSERT(m_NetThreadsCount >= 1);
+    MANGOS_ASSERT(m_NetThreadsCount > m_FirstSocketThread);
 
-    for (size_t i = 1; i < m_NetThreadsCount; ++i)
+    for (size_t i = m_FirstSocketThread + 1; i < m_NetThreadsCount; ++i)
         if (m_NetThreads[i].Connections() < m_NetThreads[min].Connections())
             min = i;
 
+    // keep the socket in the thread that accepted it while that is not much busier than the others
+    for (size_t i = m_FirstSocketThread; i < m_NetThreadsCount; ++i)
+    {
+        if (m_NetThreads[i].GetReactor() == sock->reactor())
+        {
+            if (m_NetThreads[i].Connections() <= m_NetThreads[min].Connections() + ACCEPT_AFFINITY_SLACK)
+                min = i;
+
+            break;
+        }
+    }
+
     return m_NetThreads[min].AddSocket(sock);
 }
 
+void WorldSocketMgr::RequestFlush(WorldSocket* sock)
+{
+    sock->m_NetThread->RequestFlush(sock);
+}
+
+void WorldSocketMgr::GetNetworkStats(std::vector<NetworkThreadStats>& stats) const
+{
+    stats.resize(m_NetThreadsCount);
+
+    for (size_t i = 0; i < m_NetThreadsCount; ++i)
+        m_NetThreads[i].GetStats(stats[i]);
+}
+
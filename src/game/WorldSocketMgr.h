@@ -27,10 +27,20 @@
 
 #include "Platform/Define.h"
 #include <string>
+#include <vector>
 
 class WorldSocket;
 class ReactorRunnable;
-class ACE_Event_Handler;
+
+/// Counters of one network thread
+struct NetworkThreadStats
+{
+    uint32 connections;                                     // sockets handled by the thread
+    bool listening;                                         // thread accepts connections itself
+    uint64 accepted;                                        // connections taken over by the thread
+    uint32 avgAcceptLatency;                                // microseconds from accept() until the thread took over the socket
+    uint32 maxAcceptLatency;
+};
 
 /// Manages all sockets connected to peers and network threads
 class WorldSocketMgr
@@ -53,12 +63,23 @@ class WorldSocketMgr
         std::string& GetBindAddress() { return m_addr; }
         uint16 GetBindPort() { return m_port; }
 
+        /// True if every network thread has its own acceptor on the port (SO_REUSEPORT)
+        bool IsUsingReusePort() const { return m_ReusePort; }
+
+        /// Fill counters of every network thread, safe to call from any thread
+        void GetNetworkStats(std::vector<NetworkThreadStats>& stats) const;
+
     private:
         int OnSocketOpen(WorldSocket* sock);
         int StartReactiveIO(uint16 port, const char* address);
 
+        /// Called by WorldSocket with pending output, makes its network thread write it
+        void RequestFlush(WorldSocket* sock);
+
         ReactorRunnable* m_NetThreads;
         size_t m_NetThreadsCount;
+        size_t m_FirstSocketThread;                         // threads before it only accept connections
+        bool m_ReusePort;
 
         int m_SockOutKBuff;
         int m_SockOutUBuff;
@@ -66,8 +87,6 @@ class WorldSocketMgr
 
         std::string m_addr;
         uint16 m_port;
-
-        ACE_Event_Handler* m_Acceptor;
 };
 
 #define sWorldSocketMgr MaNGOS::Singleton<WorldSocketMgr>::Instance()
@@ -31,6 +31,11 @@
 #include "ObjectMgr.h"
 #include "ObjectGuid.h"
 #include "SpellMgr.h"
+#include "GridMap.h"
+#include "Map.h"
+#include "Util.h"
+
+#include <chrono>
 
 bool ChatHandler::HandleDebugSendSpellFailCommand(char* args)
 {
@@ -213,6 +218,93 @@ bool ChatHandler::HandleDebugUpdateWorldStateCommand(char* args)
     return true;
 }
 
+bool ChatHandler::HandleDebugTerrainBenchCommand(char* args)
+{
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 1000))
+        return false;
+
+    if (!count || count > 100000)
+        return false;
+
+    Player* player = m_session->GetPlayer();
+    Map* map = player->GetMap();
+    TerrainInfo const* terrain = map->GetTerrain();
+
+    float x, y, z;
+    player->GetPosition(x, y, z);
+
+    // random points around the player, as the targets of an area spell
+    std::vector<TerrainHeightQuery> heightQueries(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        heightQueries[i].x = x + frand(-40.0f, 40.0f);
+        heightQueries[i].y = y + frand(-40.0f, 40.0f);
+        heightQueries[i].z = z + frand(-5.0f, 5.0f);
+    }
+
+    // loads missing grids, they would count for the first run only
+    terrain->GetHeightsStatic(&heightQueries[0], count);
+
+    typedef std::chrono::steady_clock Clock;
+
+    std::vector<float> heights(count);
+    Clock::time_point start = Clock::now();
+    for (uint32 i = 0; i < count; ++i)
+        heights[i] = terrain->GetHeightStatic(heightQueries[i].x, heightQueries[i].y, heightQueries[i].z);
+    Clock::time_point scalarEnd = Clock::now();
+    terrain->GetHeightsStatic(&heightQueries[0], count);
+    Clock::time_point batchEnd = Clock::now();
+
+    uint32 heightDifferences = 0;
+    for (uint32 i = 0; i < count; ++i)
+        if (heights[i] != heightQueries[i].height)
+            ++heightDifferences;
+
+    PSendSysMessage("%u heights: %u us one by one, %u us batched, %u different results", count,
+                    uint32(std::chrono::duration_cast<std::chrono::microseconds>(scalarEnd - start).count()),
+                    uint32(std::chrono::duration_cast<std::chrono::microseconds>(batchEnd - scalarEnd).count()), heightDifferences);
+
+    // lines of sight of the points on the ground to the player, as the target checks of an area spell
+    std::vector<VMAP::LineOfSightQuery> losQueries(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        VMAP::LineOfSightQuery& query = losQueries[i];
+        query.x1 = heightQueries[i].x;
+        query.y1 = heightQueries[i].y;
+        query.z1 = (heightQueries[i].height > INVALID_HEIGHT ? heightQueries[i].height : heightQueries[i].z) + 2.0f;
+        query.x2 = x;
+        query.y2 = y;
+        query.z2 = z + 2.0f;
+    }
+
+    std::vector<bool> results(count);
+    start = Clock::now();
+    for (uint32 i = 0; i < count; ++i)
+    {
+        VMAP::LineOfSightQuery const& query = losQueries[i];
+        results[i] = map->IsInLineOfSight(query.x1, query.y1, query.z1, query.x2, query.y2, query.z2, player->GetPhaseMask());
+    }
+    scalarEnd = Clock::now();
+    map->IsInLineOfSight(&losQueries[0], count, player->GetPhaseMask());
+    batchEnd = Clock::now();
+
+    uint32 losDifferences = 0;
+    uint32 inLOS = 0;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        if (results[i] != losQueries[i].result)
+            ++losDifferences;
+        if (losQueries[i].result)
+            ++inLOS;
+    }
+
+    PSendSysMessage("%u lines of sight (%u clear): %u us one by one, %u us batched, %u different results", count, inLOS,
+                    uint32(std::chrono::duration_cast<std::chrono::microseconds>(scalarEnd - start).count()),
+                    uint32(std::chrono::duration_cast<std::chrono::microseconds>(batchEnd - scalarEnd).count()), losDifferences);
+    return true;
+}
+
 bool ChatHandler::HandleDebugPlayCinematicCommand(char* args)
 {
     // USAGE: .debug play cinematic #cinematicid
@@ -32,6 +32,13 @@
 #include <cmath>
 
 #define MAX_STACK_SIZE 64
+/// Rays traversed together by BIH::intersectRays()
+#define BIH_PACKET_SIZE 4
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BIH_USE_SSE2
+#include <emmintrin.h>
+#endif
 
 #ifdef _MSC_VER
 #define isnan(x) _isnan(x)
@@ -272,6 +279,30 @@ class BIH
             }
         }
 
+        /**
+            Traverses the tree once for a packet of count <= BIH_PACKET_SIZE rays.
+            Every ray gets the same results as intersectRay() would give it: the callback
+            is called as intersectCallback(rayIndex, ray, object, maxDist[rayIndex], stopAtFirst)
+            and a ray stops at its first hit when stopAtFirst is set.
+            Without SSE2 the rays are traversed one after another.
+        */
+        template<typename RayCallback>
+        void intersectRays(const Ray* rays, uint32 count, RayCallback& intersectCallback, float* maxDist, bool stopAtFirst = false) const
+        {
+#ifdef BIH_USE_SSE2
+            if (count > 1)
+            {
+                intersectPacket(rays, count, intersectCallback, maxDist, stopAtFirst);
+                return;
+            }
+#endif
+            for (uint32 i = 0; i < count; ++i)
+            {
+                PacketLaneCallback<RayCallback> laneCallback(intersectCallback, i);
+                intersectRay(rays[i], laneCallback, maxDist[i], stopAtFirst);
+            }
+        }
+
         template<typename IsectCallback>
         void intersectPoint(const Vector3& p, IsectCallback& intersectCallback) const
         {
@@ -376,6 +407,233 @@ class BIH
             float tfar;
         };
 
+        /// Passes the index of the ray to the callback of intersectRays()
+        template<typename RayCallback>
+        class PacketLaneCallback
+        {
+            public:
+                PacketLaneCallback(RayCallback& callback, uint32 rayIndex) : m_callback(callback), m_rayIndex(rayIndex) {}
+                bool operator()(const Ray& r, uint32 entry, float& maxDist, bool stopAtFirst)
+                {
+                    return m_callback(m_rayIndex, r, entry, maxDist, stopAtFirst);
+                }
+
+            private:
+                RayCallback& m_callback;
+                uint32 m_rayIndex;
+        };
+
+#ifdef BIH_USE_SSE2
+        struct PacketStackNode
+        {
+            __m128 tnear;
+            __m128 tfar;
+            uint32 node;
+        };
+
+        static inline __m128 selectPs(__m128 mask, __m128 a, __m128 b)
+        {
+            return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+        }
+
+        /// intersectRay() with the ray intervals of the packet in SSE registers, one lane per ray
+        template<typename RayCallback>
+        void intersectPacket(const Ray* rays, uint32 count, RayCallback& intersectCallback, float* maxDist, bool stopAtFirst) const
+        {
+            float orgLanes[3][BIH_PACKET_SIZE];
+            float invDirLanes[3][BIH_PACKET_SIZE];
+            uint32 negDirLanes[3][BIH_PACKET_SIZE];
+            float intervalMinLanes[BIH_PACKET_SIZE];
+            float intervalMaxLanes[BIH_PACKET_SIZE];
+            float maxDistLanes[BIH_PACKET_SIZE];
+
+            // clip every ray against the tree bounds like intersectRay(), unused lanes get an empty interval
+            for (uint32 lane = 0; lane < BIH_PACKET_SIZE; ++lane)
+            {
+                intervalMinLanes[lane] = 1.f;
+                intervalMaxLanes[lane] = -1.f;
+                maxDistLanes[lane] = 0.f;
+                for (int i = 0; i < 3; ++i)
+                {
+                    orgLanes[i][lane] = 0.f;
+                    invDirLanes[i][lane] = 1.f;
+                    negDirLanes[i][lane] = 0;
+                }
+
+                if (lane >= count)
+                    continue;
+
+                maxDistLanes[lane] = maxDist[lane];
+
+                float intervalMin = -1.f;
+                float intervalMax = -1.f;
+                Vector3 org = rays[lane].origin();
+                Vector3 dir = rays[lane].direction();
+                bool missed = false;
+                for (int i = 0; i < 3; ++i)
+                {
+                    orgLanes[i][lane] = org[i];
+                    invDirLanes[i][lane] = 1.f / dir[i];
+                    negDirLanes[i][lane] = (floatToRawIntBits(dir[i]) >> 31) ? 0xFFFFFFFF : 0;
+                    if (!missed && G3D::fuzzyNe(dir[i], 0.0f))
+                    {
+                        float t1 = (bounds.low()[i]  - org[i]) * invDirLanes[i][lane];
+                        float t2 = (bounds.high()[i] - org[i]) * invDirLanes[i][lane];
+                        if (t1 > t2)
+                            std::swap(t1, t2);
+                        if (t1 > intervalMin)
+                            intervalMin = t1;
+                        if (t2 < intervalMax || intervalMax < 0.f)
+                            intervalMax = t2;
+                        if (intervalMax <= 0 || intervalMin >= maxDist[lane])
+                            missed = true;
+                    }
+                }
+
+                if (missed || intervalMin > intervalMax)
+                    continue;
+                intervalMinLanes[lane] = std::max(intervalMin, 0.f);
+                intervalMaxLanes[lane] = std::min(intervalMax, maxDist[lane]);
+            }
+
+            __m128 org[3];
+            __m128 invDir[3];
+            __m128 negDir[3];
+            for (int i = 0; i < 3; ++i)
+            {
+                org[i] = _mm_loadu_ps(orgLanes[i]);
+                invDir[i] = _mm_loadu_ps(invDirLanes[i]);
+                negDir[i] = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(negDirLanes[i])));
+            }
+
+            __m128 intervalMin = _mm_loadu_ps(intervalMinLanes);
+            __m128 intervalMax = _mm_loadu_ps(intervalMaxLanes);
+            __m128 maxDistPacket = _mm_loadu_ps(maxDistLanes);
+            int doneMask = 0;
+
+            PacketStackNode stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+            int node = 0;
+
+            while (true)
+            {
+                // lanes with a ray interval in this node, like the maxDist check when moving up the stack in intersectRay()
+                __m128 inside = _mm_and_ps(_mm_cmple_ps(intervalMin, intervalMax), _mm_cmple_ps(intervalMin, maxDistPacket));
+                int activeMask = _mm_movemask_ps(inside) & ~doneMask;
+
+                while (activeMask)
+                {
+                    uint32 tn = tree[node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    bool BVH2 = tn & (1 << 29);
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            // "normal" interior node, the left child is in front for rays in positive direction
+                            __m128 tl = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(intBitsToFloat(tree[node + 1])), org[axis]), invDir[axis]);
+                            __m128 tr = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(intBitsToFloat(tree[node + 2])), org[axis]), invDir[axis]);
+                            // the interval is the first operand of min/max, a NaN plane distance keeps it unchanged
+                            __m128 leftMin = selectPs(negDir[axis], _mm_max_ps(tl, intervalMin), intervalMin);
+                            __m128 leftMax = selectPs(negDir[axis], intervalMax, _mm_min_ps(tl, intervalMax));
+                            __m128 rightMin = selectPs(negDir[axis], intervalMin, _mm_max_ps(tr, intervalMin));
+                            __m128 rightMax = selectPs(negDir[axis], _mm_min_ps(tr, intervalMax), intervalMax);
+                            int leftMask = _mm_movemask_ps(_mm_cmple_ps(leftMin, leftMax)) & activeMask;
+                            int rightMask = _mm_movemask_ps(_mm_cmple_ps(rightMin, rightMax)) & activeMask;
+
+                            if (leftMask && rightMask)
+                            {
+                                // visit the child in front of the first active ray first and push the other one
+                                if (_mm_movemask_ps(negDir[axis]) & activeMask & -activeMask)
+                                {
+                                    stack[stackPos].node = offset;
+                                    stack[stackPos].tnear = leftMin;
+                                    stack[stackPos].tfar = leftMax;
+                                    node = offset + 3;
+                                    intervalMin = rightMin;
+                                    intervalMax = rightMax;
+                                    activeMask = rightMask;
+                                }
+                                else
+                                {
+                                    stack[stackPos].node = offset + 3;
+                                    stack[stackPos].tnear = rightMin;
+                                    stack[stackPos].tfar = rightMax;
+                                    node = offset;
+                                    intervalMin = leftMin;
+                                    intervalMax = leftMax;
+                                    activeMask = leftMask;
+                                }
+                                ++stackPos;
+                            }
+                            else if (leftMask)
+                            {
+                                node = offset;
+                                intervalMin = leftMin;
+                                intervalMax = leftMax;
+                                activeMask = leftMask;
+                            }
+                            else
+                            {
+                                node = offset + 3;
+                                intervalMin = rightMin;
+                                intervalMax = rightMax;
+                                activeMask = rightMask;
+                            }
+                            continue;
+                        }
+                        else
+                        {
+                            // leaf - test some objects for every ray in it
+                            int n = tree[node + 1];
+                            for (uint32 lane = 0; lane < count; ++lane)
+                            {
+                                if (!(activeMask & (1 << lane)))
+                                    continue;
+
+                                for (int i = 0; i < n; ++i)
+                                {
+                                    bool hit = intersectCallback(lane, rays[lane], objects[offset + i], maxDist[lane], stopAtFirst);
+                                    if (stopAtFirst && hit)
+                                    {
+                                        doneMask |= 1 << lane;
+                                        break;
+                                    }
+                                }
+                            }
+                            if (stopAtFirst && doneMask == (1 << count) - 1)
+                                return;
+                            maxDistPacket = _mm_setr_ps(maxDist[0], count > 1 ? maxDist[1] : 0.f, count > 2 ? maxDist[2] : 0.f, count > 3 ? maxDist[3] : 0.f);
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        if (axis > 2)
+                            return; // should not happen
+                        __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(intBitsToFloat(tree[node + 1])), org[axis]), invDir[axis]);
+                        __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(intBitsToFloat(tree[node + 2])), org[axis]), invDir[axis]);
+                        node = offset;
+                        intervalMin = _mm_max_ps(selectPs(negDir[axis], t2, t1), intervalMin);
+                        intervalMax = _mm_min_ps(selectPs(negDir[axis], t1, t2), intervalMax);
+                        activeMask &= _mm_movemask_ps(_mm_cmple_ps(intervalMin, intervalMax));
+                        continue;
+                    }
+                } // traversal loop
+
+                // stack is empty?
+                if (stackPos == 0)
+                    return;
+                // move back up the stack
+                --stackPos;
+                node = stack[stackPos].node;
+                intervalMin = stack[stackPos].tnear;
+                intervalMax = stack[stackPos].tfar;
+            }
+        }
+#endif
+
         class BuildStats
         {
             private:
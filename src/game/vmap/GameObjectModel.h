@@ -59,6 +59,7 @@ class GameObjectModel
         /** Enables\disables collision. */
         void disable() { phasemask = 0;}
         void enable(uint32 ph_mask) { phasemask = ph_mask;}
+        uint32 getPhaseMask() const { return phasemask; }
 
         bool intersectRay(const G3D::Ray& Ray, float& MaxDist, bool StopAtFirstHit, uint32 ph_mask) const;
 
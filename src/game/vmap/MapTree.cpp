@@ -47,6 +47,27 @@ namespace VMAP
             bool hit;
     };
 
+    class MapRayPacketCallback
+    {
+        public:
+            MapRayPacketCallback(ModelInstance* val): prims(val)
+            {
+                for (uint32 i = 0; i < BIH_PACKET_SIZE; ++i)
+                    hit[i] = false;
+            }
+            bool operator()(uint32 rayIndex, const G3D::Ray& ray, uint32 entry, float& distance, bool pStopAtFirstHit)
+            {
+                bool result = prims[entry].intersectRay(ray, distance, pStopAtFirstHit);
+                if (result)
+                    hit[rayIndex] = true;
+                return result;
+            }
+            bool didHit(uint32 rayIndex) const { return hit[rayIndex]; }
+        protected:
+            ModelInstance* prims;
+            bool hit[BIH_PACKET_SIZE];
+    };
+
     class AreaInfoCallback
     {
         public:
@@ -162,6 +183,34 @@ namespace VMAP
 
         return true;
     }
+
+    void StaticMapTree::isInLineOfSight(const Vector3* pos1, const Vector3* pos2, bool* results, uint32 count) const
+    {
+        G3D::Ray rays[BIH_PACKET_SIZE];
+        float maxDist[BIH_PACKET_SIZE];
+        uint32 rayQuery[BIH_PACKET_SIZE];
+        uint32 rayCount = 0;
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            results[i] = true;
+            float dist = (pos2[i] - pos1[i]).magnitude();
+            MANGOS_ASSERT(dist < std::numeric_limits<float>::max());
+            if (dist < 1e-10f)
+                continue;
+
+            rays[rayCount] = G3D::Ray::fromOriginAndDirection(pos1[i], (pos2[i] - pos1[i]) / dist);
+            maxDist[rayCount] = dist;
+            rayQuery[rayCount] = i;
+            ++rayCount;
+        }
+
+        MapRayPacketCallback intersectionCallBack(iTreeValues);
+        iTree.intersectRays(rays, rayCount, intersectionCallBack, maxDist, true);
+        for (uint32 i = 0; i < rayCount; ++i)
+            if (intersectionCallBack.didHit(i))
+                results[rayQuery[i]] = false;
+    }
     //=========================================================
     /**
     When moving from pos1 to pos2 check if we hit an object. Return true and the position if we hit one
@@ -226,6 +275,22 @@ namespace VMAP
         return height;
     }
 
+    void StaticMapTree::getHeights(const Vector3* pos, const float* maxSearchDist, float* heights, uint32 count) const
+    {
+        G3D::Ray rays[BIH_PACKET_SIZE];
+        float maxDist[BIH_PACKET_SIZE];
+        for (uint32 i = 0; i < count; ++i)
+        {
+            rays[i] = G3D::Ray(pos[i], Vector3(0, 0, -1));
+            maxDist[i] = maxSearchDist[i];
+        }
+
+        MapRayPacketCallback intersectionCallBack(iTreeValues);
+        iTree.intersectRays(rays, count, intersectionCallBack, maxDist, false);
+        for (uint32 i = 0; i < count; ++i)
+            heights[i] = intersectionCallBack.didHit(i) ? pos[i].z - maxDist[i] : G3D::inf();
+    }
+
     //=========================================================
 
     bool StaticMapTree::CanLoadMap(const std::string& vmapPath, uint32 mapID, uint32 tileX, uint32 tileY)
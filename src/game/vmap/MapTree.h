@@ -70,6 +70,10 @@ namespace VMAP
             bool isInLineOfSight(const G3D::Vector3& pos1, const G3D::Vector3& pos2) const;
             bool getObjectHitPos(const G3D::Vector3& pos1, const G3D::Vector3& pos2, G3D::Vector3& pResultHitPos, float pModifyDist) const;
             float getHeight(const G3D::Vector3& pPos, float maxSearchDist) const;
+            /// isInLineOfSight() of pos1[i] to pos2[i] for count <= BIH_PACKET_SIZE rays traversing the tree together
+            void isInLineOfSight(const G3D::Vector3* pos1, const G3D::Vector3* pos2, bool* results, uint32 count) const;
+            /// getHeight() for count <= BIH_PACKET_SIZE positions traversing the tree together
+            void getHeights(const G3D::Vector3* pos, const float* maxSearchDist, float* heights, uint32 count) const;
             bool getAreaInfo(G3D::Vector3& pos, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const;
             bool GetLocationInfo(const Vector3& pos, LocationInfo& info) const;
 
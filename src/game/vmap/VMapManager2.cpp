@@ -154,6 +154,36 @@ namespace VMAP
         }
         return result;
     }
+
+    void VMapManager2::isInLineOfSight(unsigned int pMapId, LineOfSightQuery* queries, uint32 count)
+    {
+        for (uint32 i = 0; i < count; ++i)
+            queries[i].result = true;
+
+        if (!isLineOfSightCalcEnabled())
+            return;
+        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return;
+
+        Vector3 pos1[BIH_PACKET_SIZE];
+        Vector3 pos2[BIH_PACKET_SIZE];
+        bool results[BIH_PACKET_SIZE];
+        for (uint32 first = 0; first < count; first += BIH_PACKET_SIZE)
+        {
+            uint32 packetSize = std::min<uint32>(count - first, BIH_PACKET_SIZE);
+            for (uint32 i = 0; i < packetSize; ++i)
+            {
+                LineOfSightQuery const& query = queries[first + i];
+                pos1[i] = convertPositionToInternalRep(query.x1, query.y1, query.z1);
+                pos2[i] = convertPositionToInternalRep(query.x2, query.y2, query.z2);
+            }
+
+            instanceTree->second->isInLineOfSight(pos1, pos2, results, packetSize);
+            for (uint32 i = 0; i < packetSize; ++i)
+                queries[first + i].result = results[i];
+        }
+    }
     //=========================================================
     /**
     get the hit position and return true if we hit something
@@ -207,6 +237,37 @@ namespace VMAP
         return height;
     }
 
+    void VMapManager2::getHeights(unsigned int pMapId, HeightQuery* queries, uint32 count)
+    {
+        for (uint32 i = 0; i < count; ++i)
+            queries[i].height = VMAP_INVALID_HEIGHT_VALUE;  // no height
+
+        if (!isHeightCalcEnabled())
+            return;
+        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+        if (instanceTree == iInstanceMapTrees.end())
+            return;
+
+        Vector3 pos[BIH_PACKET_SIZE];
+        float maxSearchDist[BIH_PACKET_SIZE];
+        float heights[BIH_PACKET_SIZE];
+        for (uint32 first = 0; first < count; first += BIH_PACKET_SIZE)
+        {
+            uint32 packetSize = std::min<uint32>(count - first, BIH_PACKET_SIZE);
+            for (uint32 i = 0; i < packetSize; ++i)
+            {
+                HeightQuery const& query = queries[first + i];
+                pos[i] = convertPositionToInternalRep(query.x, query.y, query.z);
+                maxSearchDist[i] = query.maxSearchDist;
+            }
+
+            instanceTree->second->getHeights(pos, maxSearchDist, heights, packetSize);
+            for (uint32 i = 0; i < packetSize; ++i)
+                if (heights[i] < G3D::inf())
+                    queries[first + i].height = heights[i];
+        }
+    }
+
     //=========================================================
 
     bool VMapManager2::getAreaInfo(unsigned int pMapId, float x, float y, float& z, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const
@@ -89,6 +89,8 @@ namespace VMAP
             */
             bool getObjectHitPos(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float pModifyDist) override;
             float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) override;
+            void isInLineOfSight(unsigned int pMapId, LineOfSightQuery* queries, uint32 count) override;
+            void getHeights(unsigned int pMapId, HeightQuery* queries, uint32 count) override;
 
             bool processCommand(char* /*pCommand*/) override { return false; }      // for debug and extensions
 
@@ -28,6 +28,7 @@
 #include "Master.h"
 #include "SystemConfig.h"
 #include "AuctionHouseBot/AuctionHouseBot.h"
+#include "Auth/AuthCrypt.h"
 #include "revision.h"
 #include <openssl/opensslv.h>
 #include <openssl/crypto.h>
@@ -65,6 +66,7 @@ void usage(const char* prog)
                    "    -v, --version            print version and exist\n\r"
                    "    -c config_file           use config_file as configuration file\n\r"
                    "    -a, --ahbot config_file  use config_file as ahbot configuration file\n\r"
+                   "    --crypt-benchmark headers  measure packet header encryption per second and exit\n\r"
 #ifdef WIN32
                    "    Running as service functions:\n\r"
                    "    -s run                   run as service\n\r"
@@ -89,8 +91,10 @@ extern int main(int argc, char** argv)
     ACE_Get_Opt cmd_opts(argc, argv, options);
     cmd_opts.long_option("version", 'v', ACE_Get_Opt::NO_ARG);
     cmd_opts.long_option("ahbot", 'a', ACE_Get_Opt::ARG_REQUIRED);
+    cmd_opts.long_option("crypt-benchmark", 'b', ACE_Get_Opt::ARG_REQUIRED);
 
     char serviceDaemonMode = '\0';
+    uint32 benchmarkHeaders = 0;
 
     int option;
     while ((option = cmd_opts()) != EOF)
@@ -103,6 +107,9 @@ extern int main(int argc, char** argv)
             case 'c':
                 cfg_file = cmd_opts.opt_arg();
                 break;
+            case 'b':
+                benchmarkHeaders = uint32(atoi(cmd_opts.opt_arg()));
+                break;
             case 'v':
                 printf("%s\n", _FULLVERSION(REVISION_DATE, REVISION_TIME, REVISION_ID));
                 printf("Boost version %u.%u.%u\n", (BOOST_VERSION / 100000), ((BOOST_VERSION / 100) % 1000), (BOOST_VERSION % 100));
@@ -203,6 +210,12 @@ extern int main(int argc, char** argv)
 
     DETAIL_LOG("Using ACE: %s", ACE_VERSION);
 
+    if (benchmarkHeaders)
+    {
+        AuthCrypt::RunBenchmark(benchmarkHeaders);
+        return 0;
+    }
+
     ///- Set progress bars show mode
     BarGoLink::SetOutputState(sConfig.GetBoolDefault("ShowProgressBars", false));
 
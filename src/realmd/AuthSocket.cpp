@@ -28,6 +28,7 @@
 #include "AuthSocket.h"
 #include "AuthCodes.h"
 #include "PatchHandler.h"
+#include "SRP6.h"
 
 #include <openssl/md5.h>
 //#include "Util.h" -- for commented utf8ToUpperOnlyLatin
@@ -178,25 +179,19 @@ const AuthHandler table[] =
 
 #define AUTH_TOTAL_COMMANDS sizeof(table)/sizeof(AuthHandler)
 
-/// Constructor - set the N and g values for SRP6
+/// Constructor
 AuthSocket::AuthSocket()
 {
-    N.SetHexStr("894B645E89E1535BBDAD5B8B290650530801B18EBFBF5E8FAB3C82872A3E9BB7");
-    g.SetDword(7);
     _authed = false;
     _autoreg = sConfig.GetIntDefault("UseAutoReg", 0) != 0;
 
     _accountSecurityLevel = SEC_PLAYER;
 
     _build = 0;
-    patch_ = ACE_INVALID_HANDLE;
 }
 
-/// Close patch file descriptor before leaving
 AuthSocket::~AuthSocket()
 {
-    if (patch_ != ACE_INVALID_HANDLE)
-        ACE_OS::close(patch_);
 }
 
 /// Accept the connection and set the s random value for SRP6
@@ -249,26 +244,8 @@ void AuthSocket::OnRead()
 /// Make the SRP6 calculation from hash in dB
 void AuthSocket::_SetVSFields(const std::string& rI)
 {
-    s.SetRand(s_BYTE_SIZE * 8);
+    sSRP6.CreateVerifier(rI, s, v);
 
-    BigNumber I;
-    I.SetHexStr(rI.c_str());
-
-    // In case of leading zeros in the rI hash, restore them
-    uint8 mDigest[SHA_DIGEST_LENGTH];
-    memset(mDigest, 0, SHA_DIGEST_LENGTH);
-    if (I.GetNumBytes() <= SHA_DIGEST_LENGTH)
-        memcpy(mDigest, I.AsByteArray(), I.GetNumBytes());
-
-    std::reverse(mDigest, mDigest + SHA_DIGEST_LENGTH);
-
-    Sha1Hash sha;
-    sha.UpdateData(s.AsByteArray(), s.GetNumBytes());
-    sha.UpdateData(mDigest, SHA_DIGEST_LENGTH);
-    sha.Finalize();
-    BigNumber x;
-    x.SetBinary(sha.GetDigest(), sha.GetLength());
-    v = g.ModExp(x, N);
     // No SQL injection (username escaped)
     const char* v_hex, *s_hex;
     v_hex = v.AsHexStr();
@@ -389,10 +366,12 @@ bool AuthSocket::_HandleLogonChallenge()
     }
     else
     {
-        ///- Get the account details from the account table
+        ///- Get the account details from the account table, together with an active ban if any
         // No SQL injection (escaped user name)
 
-        result = LoginDatabase.PQuery("SELECT sha_pass_hash,id,locked,last_ip,gmlevel,v,s FROM account WHERE username = '%s'", _safelogin.c_str());
+        result = LoginDatabase.PQuery("SELECT a.sha_pass_hash, a.id, a.locked, a.last_ip, a.gmlevel, a.v, a.s, ab.bandate, ab.unbandate FROM account a "
+                                      "LEFT JOIN account_banned ab ON ab.id = a.id AND ab.active = 1 AND (ab.unbandate > UNIX_TIMESTAMP() OR ab.unbandate = ab.bandate) "
+                                      "WHERE a.username = '%s'", _safelogin.c_str());
         if (result)
         {
             ///- If the IP is 'locked', check that the player comes indeed from the correct IP address
@@ -420,11 +399,9 @@ bool AuthSocket::_HandleLogonChallenge()
             if (!locked)
             {
                 ///- If the account is banned, reject the logon attempt
-                QueryResult* banresult = LoginDatabase.PQuery("SELECT bandate,unbandate FROM account_banned WHERE "
-                                         "id = %u AND active = 1 AND (unbandate > UNIX_TIMESTAMP() OR unbandate = bandate)", (*result)[1].GetUInt32());
-                if (banresult)
+                if (!(*result)[7].IsNULL())
                 {
-                    if ((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
+                    if ((*result)[7].GetUInt64() == (*result)[8].GetUInt64())
                     {
                         pkt << (uint8) WOW_FAIL_BANNED;
                         BASIC_LOG("[AuthChallenge] Banned account %s tries to login!", _login.c_str());
@@ -434,8 +411,6 @@ bool AuthSocket::_HandleLogonChallenge()
                         pkt << (uint8) WOW_FAIL_SUSPENDED;
                         BASIC_LOG("[AuthChallenge] Temporarily banned account %s tries to login!", _login.c_str());
                     }
-
-                    delete banresult;
                 }
                 else
                 {
@@ -449,7 +424,7 @@ bool AuthSocket::_HandleLogonChallenge()
                     DEBUG_LOG("database authentication values: v='%s' s='%s'", databaseV.c_str(), databaseS.c_str());
 
                     // multiply with 2, bytes are stored as hexstring
-                    if (databaseV.size() != s_BYTE_SIZE * 2 || databaseS.size() != s_BYTE_SIZE * 2)
+                    if (databaseV.size() != SRP6::s_BYTE_SIZE * 2 || databaseS.size() != SRP6::s_BYTE_SIZE * 2)
                         _SetVSFields(rI);
                     else
                     {
@@ -457,11 +432,7 @@ bool AuthSocket::_HandleLogonChallenge()
                         v.SetHexStr(databaseV.c_str());
                     }
 
-                    b.SetRand(19 * 8);
-                    BigNumber gmod = g.ModExp(b, N);
-                    B = ((v * 3) + gmod) % N;
-
-                    MANGOS_ASSERT(gmod.GetNumBytes() <= 32);
+                    sSRP6.CreateChallenge(v, b, B);
 
                     BigNumber unk3;
                     unk3.SetRand(16 * 8);
@@ -472,9 +443,9 @@ bool AuthSocket::_HandleLogonChallenge()
                     // B may be calculated < 32B so we force minimal length to 32B
                     pkt.append(B.AsByteArray(32), 32);      // 32 bytes
                     pkt << uint8(1);
-                    pkt.append(g.AsByteArray(), 1);
+                    pkt << uint8(sSRP6.GetGByte());
                     pkt << uint8(32);
-                    pkt.append(N.AsByteArray(32), 32);
+                    pkt.append(sSRP6.GetNBytes(), 32);
                     pkt.append(s.AsByteArray(), s.GetNumBytes());// 32 bytes
                     pkt.append(unk3.AsByteArray(16), 16);
                     uint8 securityFlags = 0;
@@ -533,15 +504,11 @@ bool AuthSocket::_HandleLogonChallenge()
                 _SetVSFields(rI);
                 OPENSSL_free((void*)rI);
 
-                b.SetRand(19 * 8);
-                BigNumber gmod = g.ModExp(b, N);
-                B = ((v * 3) + gmod) % N;
+                sSRP6.CreateChallenge(v, b, B);
 
                 if (B.GetNumBytes() < 32)
                     sLog.outDetail("Interesting, calculation of B in realmd is < 32.");
 
-                MANGOS_ASSERT(gmod.GetNumBytes() <= 32);
-
                 BigNumber unk3;
                 unk3.SetRand(16 * 8);
 
@@ -549,9 +516,9 @@ bool AuthSocket::_HandleLogonChallenge()
                 pkt << (uint8)WOW_SUCCESS;
                 pkt.append(B.AsByteArray(), 32);
                 pkt << (uint8)1;
-                pkt.append(g.AsByteArray(), 1);
+                pkt << (uint8)sSRP6.GetGByte();
                 pkt << (uint8)32;
-                pkt.append(N.AsByteArray(), 32);
+                pkt.append(sSRP6.GetNBytes(), 32);
                 pkt.append(s.AsByteArray(), s.GetNumBytes());
                 pkt.append(unk3.AsByteArray(), 16);
                 pkt << (uint8)0;                // Added in 1.12.x client branch
@@ -581,7 +548,7 @@ bool AuthSocket::_HandleLogonProof()
     /// <ul><li> If the client has no valid version
     if (!valid_version)
     {
-        if (this->patch_ != ACE_INVALID_HANDLE)
+        if (patch_)
             return false;
 
         ///- Check if we have the apropriate patch on the disk
@@ -593,10 +560,11 @@ bool AuthSocket::_HandleLogonProof()
         char filename[PATH_MAX];
         if (ACE_OS::realpath(tmp, filename) != nullptr)
         {
-            patch_ = ACE_OS::open(filename, GENERIC_READ | FILE_FLAG_SEQUENTIAL_SCAN);
+            // patch is mapped once and shared by everyone downloading it
+            patch_ = sPatchCache.GetPatch(tmp);
         }
 
-        if (patch_ == ACE_INVALID_HANDLE)
+        if (!patch_)
         {
             // no patch found
             ByteBuffer pkt;
@@ -610,28 +578,14 @@ bool AuthSocket::_HandleLogonProof()
         }
 
         XFER_INIT xferh;
-
-        ACE_OFF_T file_size = ACE_OS::filesize(this->patch_);
-
-        if (file_size == -1)
-        {
-            close_connection();
-            return false;
-        }
-
-        if (!sPatchCache.GetHash(tmp, (uint8*)&xferh.md5))
-        {
-            // calculate patch md5, happens if patch was added while realmd was running
-            sPatchCache.LoadPatchMD5(tmp);
-            sPatchCache.GetHash(tmp, (uint8*)&xferh.md5);
-        }
+        memcpy(xferh.md5, patch_->GetMD5(), MD5_DIGEST_LENGTH);
 
         uint8 data[2] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_VERSION_UPDATE};
         send((const char*)data, sizeof(data));
 
         memcpy(&xferh, "0\x05Patch", 7);
         xferh.cmd = CMD_XFER_INITIATE;
-        xferh.file_size = file_size;
+        xferh.file_size = patch_->GetSize();
 
         send((const char*)&xferh, sizeof(xferh));
         return true;
@@ -647,70 +601,8 @@ bool AuthSocket::_HandleLogonProof()
     if (A.isZero())
         return false;
 
-    Sha1Hash sha;
-    sha.UpdateBigNumbers(&A, &B, nullptr);
-    sha.Finalize();
-    BigNumber u;
-    u.SetBinary(sha.GetDigest(), 20);
-    BigNumber S = (A * (v.ModExp(u, N))).ModExp(b, N);
-
-    uint8 t[32];
-    uint8 t1[16];
-    uint8 vK[40];
-    memcpy(t, S.AsByteArray(32), 32);
-    for (int i = 0; i < 16; ++i)
-    {
-        t1[i] = t[i * 2];
-    }
-    sha.Initialize();
-    sha.UpdateData(t1, 16);
-    sha.Finalize();
-    for (int i = 0; i < 20; ++i)
-    {
-        vK[i * 2] = sha.GetDigest()[i];
-    }
-    for (int i = 0; i < 16; ++i)
-    {
-        t1[i] = t[i * 2 + 1];
-    }
-    sha.Initialize();
-    sha.UpdateData(t1, 16);
-    sha.Finalize();
-    for (int i = 0; i < 20; ++i)
-    {
-        vK[i * 2 + 1] = sha.GetDigest()[i];
-    }
-    K.SetBinary(vK, 40);
-
-    uint8 hash[20];
-
-    sha.Initialize();
-    sha.UpdateBigNumbers(&N, nullptr);
-    sha.Finalize();
-    memcpy(hash, sha.GetDigest(), 20);
-    sha.Initialize();
-    sha.UpdateBigNumbers(&g, nullptr);
-    sha.Finalize();
-    for (int i = 0; i < 20; ++i)
-    {
-        hash[i] ^= sha.GetDigest()[i];
-    }
-    BigNumber t3;
-    t3.SetBinary(hash, 20);
-
-    sha.Initialize();
-    sha.UpdateData(_login);
-    sha.Finalize();
-    uint8 t4[SHA_DIGEST_LENGTH];
-    memcpy(t4, sha.GetDigest(), SHA_DIGEST_LENGTH);
-
-    sha.Initialize();
-    sha.UpdateBigNumbers(&t3, nullptr);
-    sha.UpdateData(t4, SHA_DIGEST_LENGTH);
-    sha.UpdateBigNumbers(&s, &A, &B, &K, nullptr);
-    sha.Finalize();
     BigNumber M;
-    M.SetBinary(sha.GetDigest(), 20);
+    sSRP6.CalculateProof(_login, s, v, b, B, A, K, M);
 
     ///- Check if SRP6 results match (password is correct), else send an error
     if (!memcmp(M.AsByteArray(), lp.M1, 20))
@@ -746,7 +638,7 @@ bool AuthSocket::_HandleLogonProof()
         OPENSSL_free((void*)K_hex);
 
         ///- Finish SRP6 and send the final result to the client
-        sha.Initialize();
+        Sha1Hash sha;
         sha.UpdateBigNumbers(&A, &M, &K, nullptr);
         sha.Finalize();
 
@@ -928,10 +820,10 @@ bool AuthSocket::_HandleRealmList()
 
     recv_skip(5);
 
-    ///- Get the user id (else close the connection)
+    ///- Get the user id and the character amount on every realm at once (else close the connection)
     // No SQL injection (escaped user name)
-
-    QueryResult* result = LoginDatabase.PQuery("SELECT id,sha_pass_hash FROM account WHERE username = '%s'", _safelogin.c_str());
+    QueryResult* result = LoginDatabase.PQuery("SELECT a.id, rc.realmid, rc.numchars FROM account a "
+                          "LEFT JOIN realmcharacters rc ON rc.acctid = a.id WHERE a.username = '%s'", _safelogin.c_str());
     if (!result)
     {
         sLog.outError("[ERROR] user %s tried to login and we cannot find him in the database.", _login.c_str());
@@ -939,16 +831,19 @@ bool AuthSocket::_HandleRealmList()
         return false;
     }
 
-    uint32 id = (*result)[0].GetUInt32();
-    std::string rI = (*result)[1].GetCppString();
+    CharacterCounts characterCounts;
+    do
+    {
+        Field* fields = result->Fetch();
+        if (!fields[1].IsNULL())
+            characterCounts[fields[1].GetUInt32()] = fields[2].GetUInt8();
+    }
+    while (result->NextRow());
     delete result;
 
-    ///- Update realm list if need
-    sRealmList.UpdateIfNeed();
-
     ///- Circle through realms in the RealmList and construct the return packet (including # of user characters in each realm)
     ByteBuffer pkt;
-    LoadRealmlist(pkt, id);
+    LoadRealmlist(pkt, characterCounts);
 
     ByteBuffer hdr;
     hdr << (uint8) CMD_REALM_LIST;
@@ -960,8 +855,10 @@ bool AuthSocket::_HandleRealmList()
     return true;
 }
 
-void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
+void AuthSocket::LoadRealmlist(ByteBuffer& pkt, CharacterCounts const& characterCounts)
 {
+    RealmList::RealmMapPtr realms = sRealmList.GetRealms();
+
     switch (_build)
     {
         case 5875:                                          // 1.12.1
@@ -969,22 +866,12 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
         case 6141:                                          // 1.12.3
         {
             pkt << uint32(0);                               // unused value
-            pkt << uint8(sRealmList.size());
+            pkt << uint8(realms->size());
 
-            for (RealmList::RealmMap::const_iterator  i = sRealmList.begin(); i != sRealmList.end(); ++i)
+            for (RealmList::RealmMap::const_iterator i = realms->begin(); i != realms->end(); ++i)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i->second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
+                CharacterCounts::const_iterator count = characterCounts.find(i->second.m_ID);
+                uint8 AmountOfCharacters = count != characterCounts.end() ? count->second : 0;
 
                 bool ok_build = std::find(i->second.realmbuilds.begin(), i->second.realmbuilds.end(), _build) != i->second.realmbuilds.end();
 
@@ -1030,22 +917,12 @@ void AuthSocket::LoadRealmlist(ByteBuffer& pkt, uint32 acctid)
         default:                                            // and later
         {
             pkt << uint32(0);                               // unused value
-            pkt << uint16(sRealmList.size());
+            pkt << uint16(realms->size());
 
-            for (RealmList::RealmMap::const_iterator  i = sRealmList.begin(); i != sRealmList.end(); ++i)
+            for (RealmList::RealmMap::const_iterator i = realms->begin(); i != realms->end(); ++i)
             {
-                uint8 AmountOfCharacters;
-
-                // No SQL injection. id of realm is controlled by the database.
-                QueryResult* result = LoginDatabase.PQuery("SELECT numchars FROM realmcharacters WHERE realmid = '%d' AND acctid='%u'", i->second.m_ID, acctid);
-                if (result)
-                {
-                    Field* fields = result->Fetch();
-                    AmountOfCharacters = fields[0].GetUInt8();
-                    delete result;
-                }
-                else
-                    AmountOfCharacters = 0;
+                CharacterCounts::const_iterator count = characterCounts.find(i->second.m_ID);
+                uint8 AmountOfCharacters = count != characterCounts.end() ? count->second : 0;
 
                 bool ok_build = std::find(i->second.realmbuilds.begin(), i->second.realmbuilds.end(), _build) != i->second.realmbuilds.end();
 
@@ -1102,27 +979,13 @@ bool AuthSocket::_HandleXferResume()
     uint64 start_pos;
     recv((char*)&start_pos, 8);
 
-    if (patch_ == ACE_INVALID_HANDLE)
-    {
-        close_connection();
-        return false;
-    }
-
-    ACE_OFF_T file_size = ACE_OS::filesize(patch_);
-
-    if (file_size == -1 || start_pos >= (uint64)file_size)
+    if (!patch_ || start_pos >= patch_->GetSize())
     {
         close_connection();
         return false;
     }
 
-    if (ACE_OS::lseek(patch_, start_pos, SEEK_SET) == -1)
-    {
-        close_connection();
-        return false;
-    }
-
-    InitPatch();
+    InitPatch(start_pos);
 
     return true;
 }
@@ -1145,16 +1008,22 @@ bool AuthSocket::_HandleXferAccept()
 
     recv_skip(1);
 
-    InitPatch();
+    InitPatch(0);
 
     return true;
 }
 
-void AuthSocket::InitPatch()
+void AuthSocket::InitPatch(uint64 startPos)
 {
-    PatchHandler* handler = new PatchHandler(ACE_OS::dup(get_handle()), patch_);
+    if (!patch_)
+    {
+        close_connection();
+        return;
+    }
+
+    PatchHandler* handler = new PatchHandler(ACE_OS::dup(get_handle()), patch_, startPos);
 
-    patch_ = ACE_INVALID_HANDLE;
+    patch_.reset();
 
     if (handler->open() == -1)
     {
@@ -29,20 +29,21 @@
 #include "ByteBuffer.h"
 
 #include "BufferedSocket.h"
+#include "PatchHandler.h"
 
 /// Handle login commands
 class AuthSocket: public BufferedSocket
 {
     public:
-        const static int s_BYTE_SIZE = 32;
-
         AuthSocket();
         ~AuthSocket();
 
         void OnAccept() override;
         void OnRead() override;
         void SendProof(Sha1Hash sha);
-        void LoadRealmlist(ByteBuffer& pkt, uint32 acctid);
+        typedef std::map<uint32, uint8> CharacterCounts;    // realm id -> number of characters
+
+        void LoadRealmlist(ByteBuffer& pkt, CharacterCounts const& characterCounts);
 
         bool _HandleLogonChallenge();
         bool _HandleLogonProof();
@@ -59,7 +60,7 @@ class AuthSocket: public BufferedSocket
 
     private:
 
-        BigNumber N, s, g, v;
+        BigNumber s, v;
         BigNumber b, B;
         BigNumber K;
         BigNumber _reconnectProof;
@@ -76,9 +77,9 @@ class AuthSocket: public BufferedSocket
         uint16 _build;
         AccountTypes _accountSecurityLevel;
 
-        ACE_HANDLE patch_;
+        PatchCache::PatchFilePtr patch_;
 
-        void InitPatch();
+        void InitPatch(uint64 startPos);
 };
 #endif
 /// @}
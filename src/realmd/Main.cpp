@@ -27,6 +27,7 @@
 #include "Config/Config.h"
 #include "Log.h"
 #include "AuthSocket.h"
+#include "SRP6.h"
 #include "SystemConfig.h"
 #include "revision.h"
 #include "revision_sql.h"
@@ -43,6 +44,10 @@
 
 #include <boost/version.hpp>
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #ifdef WIN32
 #include "ServiceWin32.h"
 char serviceName[] = "realmd";
@@ -59,11 +64,11 @@ int m_ServiceStatus = -1;
 #include "PosixDaemon.h"
 #endif
 
-bool StartDB();
+bool StartDB(int nConnections);
 void UnhookSignals();
 void HookSignals();
 
-bool stopEvent = false;                                     ///< Setting it to true stops the server
+std::atomic<bool> stopEvent(false);                         ///< Setting it to true stops the server
 
 DatabaseType LoginDatabase;                                 ///< Accessor to the realm server database
 
@@ -73,6 +78,7 @@ void usage(const char* prog)
     sLog.outString("Usage: \n %s [<options>]\n"
                    "    -v, --version            print version and exist\n\r"
                    "    -c config_file           use config_file as configuration file\n\r"
+                   "    --srp6-benchmark logins  measure SRP6 logins per second and exit\n\r"
 #ifdef WIN32
                    "    Running as service functions:\n\r"
                    "    -s run                   run as service\n\r"
@@ -96,8 +102,10 @@ extern int main(int argc, char** argv)
 
     ACE_Get_Opt cmd_opts(argc, argv, options);
     cmd_opts.long_option("version", 'v');
+    cmd_opts.long_option("srp6-benchmark", 'b', ACE_Get_Opt::ARG_REQUIRED);
 
     char serviceDaemonMode = '\0';
+    uint32 benchmarkLogins = 0;
 
     int option;
     while ((option = cmd_opts()) != EOF)
@@ -107,6 +115,9 @@ extern int main(int argc, char** argv)
             case 'c':
                 cfg_file = cmd_opts.opt_arg();
                 break;
+            case 'b':
+                benchmarkLogins = uint32(atoi(cmd_opts.opt_arg()));
+                break;
             case 'v':
                 printf("%s\n", _FULLVERSION(REVISION_DATE, REVISION_TIME, REVISION_ID));
                 printf("Boost version %u.%u.%u\n", (BOOST_VERSION / 100000), ((BOOST_VERSION / 100) % 1000), (BOOST_VERSION % 100));
@@ -212,6 +223,16 @@ extern int main(int argc, char** argv)
 
     DETAIL_LOG("Using ACE: %s", ACE_VERSION);
 
+    ///- Start precomputing SRP6 challenge secrets
+    sSRP6.Initialize(sConfig.GetIntDefault("SRP6.PrecomputedSecrets", 1000));
+
+    if (benchmarkLogins)
+    {
+        sSRP6.RunBenchmark(benchmarkLogins);
+        sSRP6.Shutdown();
+        return 0;
+    }
+
 #if defined (ACE_HAS_EVENT_POLL) || defined (ACE_HAS_DEV_POLL)
     ACE_Reactor::instance(new ACE_Reactor(new ACE_Dev_Poll_Reactor(ACE::max_handles(), 1), 1), true);
 #else
@@ -235,8 +256,18 @@ extern int main(int argc, char** argv)
         sLog.outString("Daemon PID: %u\n", pid);
     }
 
+    ///- Every network thread handles its clients with a login database connection of its own
+    int networkThreads = sConfig.GetIntDefault("Network.Threads", 1);
+    if (networkThreads < 1)
+        networkThreads = 1;
+    else if (networkThreads > 16)
+    {
+        sLog.outError("Network.Threads can be at most 16 (size of the login database connection pool), using 16.");
+        networkThreads = 16;
+    }
+
     ///- Initialize the database connection
-    if (!StartDB())
+    if (!StartDB(networkThreads))
     {
         Log::WaitBeforeContinueIfNeed();
         return 1;
@@ -329,6 +360,35 @@ extern int main(int argc, char** argv)
 #ifndef WIN32
     detachDaemon();
 #endif
+
+    ///- Additional network threads dispatch events of the same reactor, one socket is never handled by two of them at once
+    std::vector<std::thread> networkWorkers;
+    for (int i = 1; i < networkThreads; ++i)
+    {
+        networkWorkers.push_back(std::thread([i]()
+        {
+            LoginDatabase.ThreadStart();
+            LoginDatabase.BindQueryConnection(i);
+
+            while (!stopEvent)
+            {
+                ACE_Time_Value interval(0, 100000);
+
+                if (ACE_Reactor::instance()->run_reactor_event_loop(interval) == -1)
+                    break;
+            }
+
+            LoginDatabase.UnbindQueryConnection();
+            LoginDatabase.ThreadEnd();
+        }));
+    }
+
+    if (networkThreads > 1)
+        sLog.outString("Using %d network threads", networkThreads);
+
+    ///- The main thread is network thread 0
+    LoginDatabase.BindQueryConnection(0);
+
     ///- Wait for termination signal
     while (!stopEvent)
     {
@@ -338,6 +398,9 @@ extern int main(int argc, char** argv)
         if (ACE_Reactor::instance()->run_reactor_event_loop(interval) == -1)
             break;
 
+        ///- Refresh the realm list snapshot here, realm list requests only read it
+        sRealmList.UpdateIfNeed();
+
         if ((++loopCounter) == numLoops)
         {
             loopCounter = 0;
@@ -350,6 +413,13 @@ extern int main(int argc, char** argv)
 #endif
     }
 
+    ///- Wait for the network threads to exit
+    stopEvent = true;
+    for (std::vector<std::thread>::iterator itr = networkWorkers.begin(); itr != networkWorkers.end(); ++itr)
+        itr->join();
+
+    sSRP6.Shutdown();
+
     ///- Wait for the delay thread to exit
     LoginDatabase.HaltDelayThread();
 
@@ -381,7 +451,7 @@ void OnSignal(int s)
 }
 
 /// Initialize connection to the database
-bool StartDB()
+bool StartDB(int nConnections)
 {
     std::string dbstring = sConfig.GetStringDefault("LoginDatabaseInfo", "");
     if (dbstring.empty())
@@ -390,9 +460,9 @@ bool StartDB()
         return false;
     }
 
-    sLog.outString("Login Database total connections: %i", 1 + 1);
+    sLog.outString("Login Database total connections: %i", nConnections + 1);
 
-    if (!LoginDatabase.Initialize(dbstring.c_str()))
+    if (!LoginDatabase.Initialize(dbstring.c_str(), nConnections))
     {
         sLog.outError("Cannot connect to database");
         return false;
@@ -415,6 +485,9 @@ void HookSignals()
     signal(SIGTERM, OnSignal);
 #ifdef _WIN32
     signal(SIGBREAK, OnSignal);
+#else
+    // patch transfers use sendfile() which can not be asked for MSG_NOSIGNAL
+    signal(SIGPIPE, SIG_IGN);
 #endif
 }
 
@@ -425,6 +498,8 @@ void UnhookSignals()
     signal(SIGTERM, 0);
 #ifdef _WIN32
     signal(SIGBREAK, 0);
+#else
+    signal(SIGPIPE, 0);
 #endif
 }
 
@@ -26,13 +26,15 @@
 #include "Log.h"
 
 #include <ace/OS_NS_sys_socket.h>
+#include <ace/OS_NS_sys_sendfile.h>
+#include <ace/OS_NS_sys_stat.h>
 #include <ace/OS_NS_dirent.h>
 #include <ace/OS_NS_errno.h>
 #include <ace/OS_NS_unistd.h>
 
 #include <ace/os_include/netinet/os_tcp.h>
 
-#include <mutex>
+#include <algorithm>
 
 #ifndef MSG_NOSIGNAL
 #define MSG_NOSIGNAL 0
@@ -44,11 +46,10 @@
 #pragma pack(push,1)
 #endif
 
-struct Chunk
+struct ChunkHeader
 {
     ACE_UINT8 cmd;
     ACE_UINT16 data_size;
-    ACE_UINT8 data[4096]; // 4096 - page size on most arch
 };
 
 #if defined( __GNUC__ )
@@ -57,22 +58,22 @@ struct Chunk
 #pragma pack(pop)
 #endif
 
-PatchHandler::PatchHandler(ACE_HANDLE socket, ACE_HANDLE patch)
+static const size_t CHUNK_DATA_SIZE = 4096;                 // 4096 - page size on most arch
+
+PatchHandler::PatchHandler(ACE_HANDLE socket, PatchCache::PatchFilePtr const& patch, ACE_UINT64 startPos) :
+    patch_(patch), pos_(startPos)
 {
     reactor(nullptr);
     set_handle(socket);
-    patch_fd_ = patch;
 }
 
 PatchHandler::~PatchHandler()
 {
-    if (patch_fd_ != ACE_INVALID_HANDLE)
-        ACE_OS::close(patch_fd_);
 }
 
 int PatchHandler::open(void*)
 {
-    if (get_handle() == ACE_INVALID_HANDLE || patch_fd_ == ACE_INVALID_HANDLE)
+    if (get_handle() == ACE_INVALID_HANDLE || !patch_)
         return -1;
 
     int nodelay = 0;
@@ -106,39 +107,125 @@ int PatchHandler::svc(void)
     // Seems client have problems with too fast sends.
     ACE_OS::sleep(1);
 
-    int flags = MSG_NOSIGNAL;
-
-    Chunk data;
-    data.cmd = CMD_XFER_DATA;
+    ChunkHeader header;
+    header.cmd = CMD_XFER_DATA;
 
-    ssize_t r;
+    ACE_UINT64 size = patch_->GetSize();
 
-    while ((r = ACE_OS::read(patch_fd_, data.data, sizeof(data.data))) > 0)
+    while (pos_ < size)
     {
-        data.data_size = (ACE_UINT16)r;
+        size_t chunk = (size_t)std::min<ACE_UINT64>(size - pos_, CHUNK_DATA_SIZE);
+        header.data_size = (ACE_UINT16)chunk;
 
-        if (peer().send((const char*)&data,
-                        ((size_t) r) + sizeof(data) - sizeof(data.data),
-                        flags) == -1)
-        {
+#if defined ACE_HAS_SENDFILE && ACE_HAS_SENDFILE == 1
+        // data goes from the page cache to the socket, TCP_CORK merges it with the header
+        if (peer().send_n(&header, sizeof(header), MSG_NOSIGNAL) != (ssize_t)sizeof(header))
             return -1;
+
+        off_t offset = (off_t)pos_;
+        while (chunk > 0)
+        {
+            ssize_t r = ACE_OS::sendfile(get_handle(), patch_->GetHandle(), &offset, chunk);
+            if (r <= 0)
+            {
+                if (r == -1 && ACE_OS::last_error() == EINTR)
+                    continue;
+
+                return -1;
+            }
+
+            chunk -= r;
         }
+
+        pos_ = offset;
+#else
+        // no sendfile, write straight from the shared mapping
+        iovec iov[2];
+        iov[0].iov_base = (char*)&header;
+        iov[0].iov_len = sizeof(header);
+        iov[1].iov_base = (char*)(patch_->GetData() + pos_);
+        iov[1].iov_len = chunk;
+
+        if (peer().sendv_n(iov, 2) != (ssize_t)(sizeof(header) + chunk))
+            return -1;
+
+        pos_ += chunk;
+#endif
     }
 
-    if (r == -1)
+    return 0;
+}
+
+bool PatchCache::PatchFile::Open(const std::string& path)
+{
+    ACE_stat st;
+    if (ACE_OS::stat(path.c_str(), &st) == -1 || st.st_size <= 0)
+        return false;
+
+    if (map_.map(path.c_str(), (size_t)st.st_size, O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_PRIVATE) == -1)
+        return false;
+
+    size_ = map_.size();
+    mtime_ = st.st_mtime;
+
+    if (!LoadStoredMD5(path))
     {
-        return -1;
+        sLog.outDebug("Calculating MD5 of patch %s", path.c_str());
+        MD5(GetData(), (size_t)size_, md5_);
+        StoreMD5(path);
     }
 
-    return 0;
+    return true;
+}
+
+bool PatchCache::PatchFile::LoadStoredMD5(const std::string& path)
+{
+    FILE* file = fopen((path + ".md5").c_str(), "r");
+    if (!file)
+        return false;
+
+    char hex[MD5_DIGEST_LENGTH * 2 + 1];
+    unsigned long long size;
+    long long mtime;
+    int read = fscanf(file, "%32s %llu %lld", hex, &size, &mtime);
+    fclose(file);
+
+    // stored hash is from an older version of the file
+    if (read != 3 || strlen(hex) != MD5_DIGEST_LENGTH * 2 || size != size_ || mtime != (long long)mtime_)
+        return false;
+
+    for (int i = 0; i < MD5_DIGEST_LENGTH; ++i)
+    {
+        unsigned int byte;
+        if (sscanf(&hex[i * 2], "%2x", &byte) != 1)
+            return false;
+
+        md5_[i] = (ACE_UINT8)byte;
+    }
+
+    return true;
+}
+
+void PatchCache::PatchFile::StoreMD5(const std::string& path) const
+{
+    FILE* file = fopen((path + ".md5").c_str(), "w");
+    if (!file)
+    {
+        sLog.outDebug("Can't store MD5 of patch %s, it will be calculated again on next start", path.c_str());
+        return;
+    }
+
+    for (int i = 0; i < MD5_DIGEST_LENGTH; ++i)
+        fprintf(file, "%02x", md5_[i]);
+
+    fprintf(file, " %llu %lld\n", (unsigned long long)size_, (long long)mtime_);
+    fclose(file);
 }
 
 INSTANTIATE_SINGLETON_1(PatchCache);
 
 PatchCache::~PatchCache()
 {
-    for (Patches::iterator i = patches_.begin(); i != patches_.end(); ++i)
-        delete i->second;
 }
 
 PatchCache::PatchCache()
@@ -146,48 +233,41 @@ PatchCache::PatchCache()
     LoadPatchesInfo();
 }
 
-void PatchCache::LoadPatchMD5(const char* szFileName)
+PatchCache::PatchFilePtr PatchCache::LoadPatch(const std::string& path)
 {
-    // Try to open the patch file
-    std::string path = "./patches/";
-    path += szFileName;
-    FILE* pPatch = fopen(path.c_str(), "rb");
     sLog.outDebug("Loading patch info from %s", path.c_str());
 
-    if (!pPatch)
-        return;
-
-    // Calculate the MD5 hash
-    MD5_CTX ctx;
-    MD5_Init(&ctx);
+    std::shared_ptr<PatchFile> patch(new PatchFile);
+    if (!patch->Open(path))
+        return PatchFilePtr();
 
-    const size_t check_chunk_size = 4 * 1024;
+    // connections still sending a replaced patch keep their own reference to it
+    std::lock_guard<std::mutex> guard(lock_);
+    patches_[path] = patch;
+    return patch;
+}
 
-    ACE_UINT8 buf[check_chunk_size];
+PatchCache::PatchFilePtr PatchCache::GetPatch(const char* path)
+{
+    ACE_stat st;
+    if (ACE_OS::stat(path, &st) == -1)
+        return PatchFilePtr();
 
-    while (!feof(pPatch))
     {
-        size_t read = fread(buf, 1, check_chunk_size, pPatch);
-        MD5_Update(&ctx, buf, read);
-    }
+        std::lock_guard<std::mutex> guard(lock_);
 
-    fclose(pPatch);
+        for (Patches::const_iterator i = patches_.begin(); i != patches_.end(); ++i)
+            if (!stricmp(path, i->first.c_str()))
+            {
+                if (i->second->GetSize() == (ACE_UINT64)st.st_size && i->second->GetModifyTime() == st.st_mtime)
+                    return i->second;
 
-    // Store the result in the internal patch hash map
-    patches_[path] = new PATCH_INFO;
-    MD5_Final((ACE_UINT8*) & patches_[path]->md5, &ctx);
-}
-
-bool PatchCache::GetHash(const char* pat, ACE_UINT8 mymd5[MD5_DIGEST_LENGTH])
-{
-    for (Patches::iterator i = patches_.begin(); i != patches_.end(); ++i)
-        if (!stricmp(pat, i->first.c_str()))
-        {
-            memcpy(mymd5, i->second->md5, MD5_DIGEST_LENGTH);
-            return true;
-        }
+                break;
+            }
+    }
 
-    return false;
+    // patch was added or replaced while realmd was running
+    return LoadPatch(path);
 }
 
 void PatchCache::LoadPatchesInfo()
@@ -206,7 +286,7 @@ void PatchCache::LoadPatchesInfo()
             continue;
 
         if (!memcmp(&dp->d_name[l - 4], ".mpq", 4))
-            LoadPatchMD5(dp->d_name);
+            LoadPatch(std::string("./patches/") + dp->d_name);
     }
 
     ACE_OS::closedir(dirp);
@@ -28,13 +28,19 @@
 #include <ace/SOCK_Stream.h>
 #include <ace/Message_Block.h>
 #include <ace/Auto_Ptr.h>
+#include <ace/Mem_Map.h>
 #include <map>
+#include <memory>
+#include <mutex>
 
 #include <openssl/bn.h>
 #include <openssl/md5.h>
 
 /**
- * @brief Caches MD5 hash of client patches present on the server
+ * @brief Keeps client patches present on the server mapped in memory together with their MD5 hash
+ *
+ * Every patch is mapped once and shared by all connections downloading it. The hash is stored
+ * in a <patch>.md5 file next to the patch and reused as long as size and modification time match.
  */
 class PatchCache
 {
@@ -42,29 +48,41 @@ class PatchCache
         ~PatchCache();
         PatchCache();
 
-        struct PATCH_INFO
+        class PatchFile
         {
-            ACE_UINT8 md5[MD5_DIGEST_LENGTH];
-        };
+            public:
+                PatchFile() : size_(0), mtime_(0) {}
 
-        typedef std::map<std::string, PATCH_INFO*> Patches;
+                bool Open(const std::string& path);
 
-        Patches::const_iterator begin() const
-        {
-            return patches_.begin();
-        }
+                ACE_HANDLE GetHandle() const { return map_.handle(); }
+                const ACE_UINT8* GetData() const { return (const ACE_UINT8*)map_.addr(); }
+                ACE_UINT64 GetSize() const { return size_; }
+                time_t GetModifyTime() const { return mtime_; }
+                const ACE_UINT8* GetMD5() const { return md5_; }
 
-        Patches::const_iterator end() const
-        {
-            return patches_.end();
-        }
+            private:
+                bool LoadStoredMD5(const std::string& path);
+                void StoreMD5(const std::string& path) const;
 
-        void LoadPatchMD5(const char*);
-        bool GetHash(const char* pat, ACE_UINT8 mymd5[MD5_DIGEST_LENGTH]);
+                ACE_Mem_Map map_;
+                ACE_UINT64 size_;
+                time_t mtime_;
+                ACE_UINT8 md5_[MD5_DIGEST_LENGTH];
+        };
+
+        typedef std::shared_ptr<PatchFile const> PatchFilePtr;
+        typedef std::map<std::string, PatchFilePtr> Patches;
+
+        /// Returns the patch at path (like "./patches/5875enGB.mpq"), (re)loading it when it was added or changed on disk
+        PatchFilePtr GetPatch(const char* path);
 
     private:
         void LoadPatchesInfo();
+        PatchFilePtr LoadPatch(const std::string& path);
+
         Patches patches_;
+        std::mutex lock_;
 };
 
 #define sPatchCache MaNGOS::Singleton<PatchCache>::Instance()
@@ -75,7 +93,7 @@ class PatchHandler: public ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH>
         typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> Base;
 
     public:
-        PatchHandler(ACE_HANDLE socket, ACE_HANDLE patch);
+        PatchHandler(ACE_HANDLE socket, PatchCache::PatchFilePtr const& patch, ACE_UINT64 startPos);
         virtual ~PatchHandler();
 
         int open(void* = 0) override;
@@ -84,7 +102,8 @@ class PatchHandler: public ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH>
         virtual int svc(void) override;
 
     private:
-        ACE_HANDLE patch_fd_;
+        PatchCache::PatchFilePtr patch_;
+        ACE_UINT64 pos_;
 };
 
 #endif /* _BK_PATCHHANDLER_H__ */
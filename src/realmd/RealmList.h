@@ -25,6 +25,9 @@
 
 #include "Common.h"
 
+#include <memory>
+#include <mutex>
+
 struct RealmBuildInfo
 {
     int build;
@@ -53,10 +56,12 @@ struct Realm
 };
 
 /// Storage object for the list of realms on the server
+/// Every update builds a new map, sockets keep using the snapshot they got until they are done with it
 class RealmList
 {
     public:
         typedef std::map<std::string, Realm> RealmMap;
+        typedef std::shared_ptr<RealmMap const> RealmMapPtr;
 
         static RealmList& Instance();
 
@@ -65,16 +70,18 @@ class RealmList
 
         void Initialize(uint32 updateInterval);
 
+        /// Reload realms from DB when the update interval expired, called from the main loop only
         void UpdateIfNeed();
 
-        RealmMap::const_iterator begin() const { return m_realms.begin(); }
-        RealmMap::const_iterator end() const { return m_realms.end(); }
-        uint32 size() const { return m_realms.size(); }
+        /// Current realms, safe to use from any network thread
+        RealmMapPtr GetRealms() const;
+        uint32 size() const { return GetRealms()->size(); }
     private:
         void UpdateRealms(bool init);
-        void UpdateRealm(uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds);
+        void UpdateRealm(RealmMap& realms, uint32 ID, const std::string& name, const std::string& address, uint32 port, uint8 icon, RealmFlags realmflags, uint8 timezone, AccountTypes allowedSecurityLevel, float popu, const std::string& builds);
     private:
-        RealmMap m_realms;                                  ///< Internal map of realms
+        mutable std::mutex m_realmsLock;
+        RealmMapPtr m_realms;                               ///< Internal map of realms
         uint32   m_UpdateInterval;
         time_t   m_NextUpdateTime;
 };
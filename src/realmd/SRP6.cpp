@@ -0,0 +1,306 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/** \file
+    \ingroup realmd
+*/
+
+#include "SRP6.h"
+#include "Log.h"
+
+#include <openssl/bn.h>
+#include <algorithm>
+#include <chrono>
+
+INSTANTIATE_SINGLETON_1(SRP6);
+
+SRP6::SRP6() : m_mont(BN_MONT_CTX_new()), m_poolSize(0), m_stopPool(false)
+{
+    m_N.SetHexStr("894B645E89E1535BBDAD5B8B290650530801B18EBFBF5E8FAB3C82872A3E9BB7");
+    m_g.SetDword(7);
+
+    BN_MONT_CTX_set(m_mont, m_N.BN(), BigNumber::Context());
+
+    // byte forms are prepared once, AsByteArray() of shared numbers is not thread safe
+    memcpy(m_NBytes, m_N.AsByteArray(s_BYTE_SIZE), s_BYTE_SIZE);
+    m_gByte = m_g.AsByteArray()[0];
+
+    Sha1Hash sha;
+    sha.UpdateBigNumbers(&m_N, nullptr);
+    sha.Finalize();
+    memcpy(m_NgHash, sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&m_g, nullptr);
+    sha.Finalize();
+    for (int i = 0; i < SHA_DIGEST_LENGTH; ++i)
+        m_NgHash[i] ^= sha.GetDigest()[i];
+
+    // hashed as number, without most significant zero bytes
+    BigNumber t3;
+    t3.SetBinary(m_NgHash, SHA_DIGEST_LENGTH);
+    m_NgHashSize = t3.GetNumBytes();
+}
+
+SRP6::~SRP6()
+{
+    Shutdown();
+    BN_MONT_CTX_free(m_mont);
+}
+
+void SRP6::Initialize(uint32 poolSize)
+{
+    m_poolSize = poolSize;
+    m_stopPool = false;
+
+    if (m_poolSize && !m_poolThread.joinable())
+        m_poolThread = std::thread(&SRP6::PoolThread, this);
+}
+
+void SRP6::Shutdown()
+{
+    if (!m_poolThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(m_poolLock);
+        m_stopPool = true;
+    }
+    m_poolCond.notify_all();
+
+    m_poolThread.join();
+    m_pool.clear();
+}
+
+void SRP6::PoolThread()
+{
+    std::unique_lock<std::mutex> guard(m_poolLock);
+
+    while (!m_stopPool)
+    {
+        if (m_pool.size() >= m_poolSize)
+        {
+            m_poolCond.wait(guard);
+            continue;
+        }
+
+        guard.unlock();
+
+        Ephemeral ephemeral;
+        CreateEphemeral(ephemeral);
+
+        guard.lock();
+        m_pool.push_back(ephemeral);
+    }
+}
+
+BigNumber SRP6::ModExp(BigNumber& base, BigNumber& exponent)
+{
+    BigNumber ret;
+    BN_mod_exp_mont(ret.BN(), base.BN(), exponent.BN(), m_N.BN(), BigNumber::Context(), m_mont);
+    return ret;
+}
+
+void SRP6::CreateEphemeral(Ephemeral& ephemeral)
+{
+    ephemeral.b.SetRand(19 * 8);
+    ephemeral.gb = ModExp(m_g, ephemeral.b);
+}
+
+BigNumber SRP6::CalculateX(BigNumber& s, std::string const& rI)
+{
+    BigNumber I;
+    I.SetHexStr(rI.c_str());
+
+    // In case of leading zeros in the rI hash, restore them
+    uint8 mDigest[SHA_DIGEST_LENGTH];
+    memset(mDigest, 0, SHA_DIGEST_LENGTH);
+    if (I.GetNumBytes() <= SHA_DIGEST_LENGTH)
+        memcpy(mDigest, I.AsByteArray(), I.GetNumBytes());
+
+    std::reverse(mDigest, mDigest + SHA_DIGEST_LENGTH);
+
+    Sha1Hash sha;
+    sha.UpdateData(s.AsByteArray(), s.GetNumBytes());
+    sha.UpdateData(mDigest, SHA_DIGEST_LENGTH);
+    sha.Finalize();
+
+    BigNumber x;
+    x.SetBinary(sha.GetDigest(), sha.GetLength());
+    return x;
+}
+
+void SRP6::CreateVerifier(std::string const& rI, BigNumber& s, BigNumber& v)
+{
+    s.SetRand(s_BYTE_SIZE * 8);
+
+    BigNumber x = CalculateX(s, rI);
+    v = ModExp(m_g, x);
+}
+
+void SRP6::CreateChallenge(BigNumber& v, BigNumber& b, BigNumber& B)
+{
+    Ephemeral ephemeral;
+    bool precomputed = false;
+
+    {
+        std::lock_guard<std::mutex> guard(m_poolLock);
+        if (!m_pool.empty())
+        {
+            ephemeral = m_pool.front();
+            m_pool.pop_front();
+            precomputed = true;
+        }
+    }
+
+    if (precomputed)
+        m_poolCond.notify_one();
+    else
+        CreateEphemeral(ephemeral);
+
+    b = ephemeral.b;
+    B = ((v * 3) + ephemeral.gb) % m_N;
+}
+
+void SRP6::CalculateSessionKey(BigNumber& S, BigNumber& K)
+{
+    uint8 t[32];
+    uint8 t1[16];
+    uint8 vK[40];
+    memcpy(t, S.AsByteArray(32), 32);
+
+    Sha1Hash sha;
+    for (int i = 0; i < 16; ++i)
+        t1[i] = t[i * 2];
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+        vK[i * 2] = sha.GetDigest()[i];
+
+    for (int i = 0; i < 16; ++i)
+        t1[i] = t[i * 2 + 1];
+    sha.Initialize();
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+        vK[i * 2 + 1] = sha.GetDigest()[i];
+
+    K.SetBinary(vK, 40);
+}
+
+BigNumber SRP6::CalculateM(std::string const& login, BigNumber& s, BigNumber& A, BigNumber& B, BigNumber& K)
+{
+    Sha1Hash sha;
+    sha.UpdateData(login);
+    sha.Finalize();
+    uint8 t4[SHA_DIGEST_LENGTH];
+    memcpy(t4, sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    sha.Initialize();
+    sha.UpdateData(m_NgHash, m_NgHashSize);
+    sha.UpdateData(t4, SHA_DIGEST_LENGTH);
+    sha.UpdateBigNumbers(&s, &A, &B, &K, nullptr);
+    sha.Finalize();
+
+    BigNumber M;
+    M.SetBinary(sha.GetDigest(), 20);
+    return M;
+}
+
+void SRP6::CalculateProof(std::string const& login, BigNumber& s, BigNumber& v, BigNumber& b, BigNumber& B, BigNumber& A, BigNumber& K, BigNumber& M)
+{
+    Sha1Hash sha;
+    sha.UpdateBigNumbers(&A, &B, nullptr);
+    sha.Finalize();
+    BigNumber u;
+    u.SetBinary(sha.GetDigest(), 20);
+
+    BigNumber S = (A * ModExp(v, u)) % m_N;
+    S = ModExp(S, b);
+
+    CalculateSessionKey(S, K);
+    M = CalculateM(login, s, A, B, K);
+}
+
+void SRP6::RunBenchmark(uint32 logins)
+{
+    std::string const login = "BENCHMARK";
+
+    // account as created in DB, sha_pass_hash = SHA1(UPPER(user):UPPER(pass))
+    Sha1Hash sha;
+    sha.UpdateData(login + ":" + login);
+    sha.Finalize();
+
+    std::string rI;
+    for (int i = 0; i < SHA_DIGEST_LENGTH; ++i)
+    {
+        char hex[3];
+        snprintf(hex, sizeof(hex), "%02X", sha.GetDigest()[i]);
+        rI += hex;
+    }
+
+    BigNumber s, v;
+    CreateVerifier(rI, s, v);
+    BigNumber x = CalculateX(s, rI);
+
+    sLog.outString("SRP6 benchmark: %u logins, %u precomputed challenge secrets", logins, m_poolSize);
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::duration serverTime = Clock::duration::zero();
+    uint32 verified = 0;
+
+    for (uint32 i = 0; i < logins; ++i)
+    {
+        // client: public A
+        BigNumber a;
+        a.SetRand(19 * 8);
+        BigNumber A = ModExp(m_g, a);
+
+        // server: challenge
+        Clock::time_point start = Clock::now();
+        BigNumber b, B;
+        CreateChallenge(v, b, B);
+        serverTime += Clock::now() - start;
+
+        // client: S = (B - 3 * g^x) ^ (a + u * x), and its proof M1
+        sha.Initialize();
+        sha.UpdateBigNumbers(&A, &B, nullptr);
+        sha.Finalize();
+        BigNumber u;
+        u.SetBinary(sha.GetDigest(), 20);
+
+        BigNumber base = ((B + m_N) - ((v * 3) % m_N)) % m_N;
+        BigNumber exponent = a + (u * x);
+        BigNumber clientS = ModExp(base, exponent);
+        BigNumber clientK;
+        CalculateSessionKey(clientS, clientK);
+        BigNumber M1 = CalculateM(login, s, A, B, clientK);
+
+        // server: proof
+        start = Clock::now();
+        BigNumber K, M;
+        CalculateProof(login, s, v, b, B, A, K, M);
+        if (!memcmp(M.AsByteArray(20), M1.AsByteArray(20), 20))
+            ++verified;
+        serverTime += Clock::now() - start;
+    }
+
+    double seconds = std::chrono::duration<double>(serverTime).count();
+    sLog.outString("SRP6 benchmark: %u of %u proofs verified, server side %.3f s, %.0f logins per second",
+                   verified, logins, seconds, seconds > 0.0 ? logins / seconds : 0.0);
+}
@@ -0,0 +1,107 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \addtogroup realmd
+/// @{
+/// \file
+
+#ifndef _SRP6_H
+#define _SRP6_H
+
+#include "Common.h"
+#include "Auth/BigNumber.h"
+#include "Auth/Sha1.h"
+#include "Policies/Singleton.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+struct bn_mont_ctx_st;
+
+/**
+ * Server side of the SRP6 login used by AuthSocket.
+ *
+ * Modular exponentiations use a Montgomery context of N prepared once and the OpenSSL
+ * context of the calling thread. The random secret b and g^b mod N of a challenge do not
+ * depend on the account, a background thread keeps a pool of them ready so a logon
+ * challenge only costs one multiplication when the pool is not drained.
+ */
+class SRP6
+{
+    public:
+        static const int s_BYTE_SIZE = 32;
+
+        SRP6();
+        ~SRP6();
+
+        /// Start filling the pool of challenge secrets, 0 computes them when needed
+        void Initialize(uint32 poolSize);
+        void Shutdown();
+
+        /// N as sent to the client, s_BYTE_SIZE bytes
+        uint8 const* GetNBytes() const { return m_NBytes; }
+        uint8 GetGByte() const { return m_gByte; }
+
+        /// New salt s and verifier v for the SHA1(USER:PASS) hash rI stored in hex
+        void CreateVerifier(std::string const& rI, BigNumber& s, BigNumber& v);
+
+        /// Secret b and public B for an account with verifier v
+        void CreateChallenge(BigNumber& v, BigNumber& b, BigNumber& B);
+
+        /// Session key K and the proof M the client must have sent for its public A
+        void CalculateProof(std::string const& login, BigNumber& s, BigNumber& v, BigNumber& b, BigNumber& B, BigNumber& A, BigNumber& K, BigNumber& M);
+
+        /// Simulate logins with client and server side, print the server logins per second
+        void RunBenchmark(uint32 logins);
+
+    private:
+        struct Ephemeral
+        {
+            BigNumber b;
+            BigNumber gb;                                   // g^b mod N
+        };
+
+        BigNumber ModExp(BigNumber& base, BigNumber& exponent);
+        BigNumber CalculateX(BigNumber& s, std::string const& rI);
+        void CalculateSessionKey(BigNumber& S, BigNumber& K);
+        BigNumber CalculateM(std::string const& login, BigNumber& s, BigNumber& A, BigNumber& B, BigNumber& K);
+        void CreateEphemeral(Ephemeral& ephemeral);
+        void PoolThread();
+
+        BigNumber m_N;
+        BigNumber m_g;
+        uint8 m_NgHash[SHA_DIGEST_LENGTH];                  // H(N) xor H(g)
+        int m_NgHashSize;
+        uint8 m_NBytes[s_BYTE_SIZE];
+        uint8 m_gByte;
+        struct bn_mont_ctx_st* m_mont;
+
+        uint32 m_poolSize;
+        bool m_stopPool;
+        std::deque<Ephemeral> m_pool;
+        std::mutex m_poolLock;
+        std::condition_variable m_poolCond;                 // signaled when a secret was taken or on shutdown
+        std::thread m_poolThread;
+};
+
+#define sSRP6 MaNGOS::Singleton<SRP6>::Instance()
+
+#endif
+/// @}
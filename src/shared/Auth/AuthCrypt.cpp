@@ -21,6 +21,11 @@
 #include "Log.h"
 #include "BigNumber.h"
 
+#include <chrono>
+
+/// Buffers are gathered into this many bytes for one cipher call
+static const size_t CRYPT_BATCH_SIZE = 2048;
+
 AuthCrypt::AuthCrypt() : _clientDecrypt(SHA_DIGEST_LENGTH), _serverEncrypt(SHA_DIGEST_LENGTH)
 {
     _initialized = false;
@@ -77,3 +82,100 @@ void AuthCrypt::EncryptSend(uint8* data, size_t len)
 
     _serverEncrypt.UpdateData(len, data);
 }
+
+void AuthCrypt::EncryptSend(BufferList const& buffers)
+{
+    if (!_initialized)
+        return;
+
+    uint8 batch[CRYPT_BATCH_SIZE];
+    size_t batchSize = 0;
+    BufferList::const_iterator batchStart = buffers.begin();
+
+    for (BufferList::const_iterator itr = buffers.begin();; ++itr)
+    {
+        if (itr == buffers.end() || batchSize + itr->second > sizeof(batch))
+        {
+            // RC4 is a stream cipher, encrypting gathered buffers equals encrypting them one after another
+            if (batchSize)
+            {
+                _serverEncrypt.UpdateData(int(batchSize), batch);
+
+                uint8 const* encrypted = batch;
+                for (; batchStart != itr; ++batchStart)
+                {
+                    memcpy(batchStart->first, encrypted, batchStart->second);
+                    encrypted += batchStart->second;
+                }
+
+                batchSize = 0;
+            }
+
+            if (itr == buffers.end())
+                break;
+
+            // too big to be gathered
+            if (itr->second > sizeof(batch))
+            {
+                _serverEncrypt.UpdateData(int(itr->second), itr->first);
+                batchStart = itr + 1;
+                continue;
+            }
+        }
+
+        memcpy(batch + batchSize, itr->first, itr->second);
+        batchSize += itr->second;
+    }
+}
+
+void AuthCrypt::RunBenchmark(uint32 headers)
+{
+    // header sizes as sent by WorldSocket, 4 bytes and 5 for big packets
+    std::vector<size_t> sizes(headers);
+    size_t total = 0;
+    for (uint32 i = 0; i < headers; ++i)
+        total += sizes[i] = (i % 8) ? 4 : 5;
+
+    std::vector<uint8> perHeader(total);
+    for (size_t i = 0; i < total; ++i)
+        perHeader[i] = uint8(i);
+
+    std::vector<uint8> batched(perHeader);
+    BufferList buffers;
+    buffers.reserve(headers);
+
+    for (uint32 i = 0, offset = 0; i < headers; offset += sizes[i], ++i)
+        buffers.push_back(std::make_pair(&batched[offset], sizes[i]));
+
+    BigNumber K;
+    K.SetRand(40 * 8);
+
+    AuthCrypt single, batch;
+    single.Init(&K);
+    batch.Init(&K);
+
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::time_point start = Clock::now();
+    for (BufferList::const_iterator itr = buffers.begin(); itr != buffers.end(); ++itr)
+        single.EncryptSend(&perHeader[itr->first - &batched[0]], itr->second);
+    double singleTime = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // sockets encrypt what was queued since their last write, use typical broadcast sized groups
+    static const size_t HEADERS_PER_WRITE = 64;
+
+    start = Clock::now();
+    BufferList group;
+    group.reserve(HEADERS_PER_WRITE);
+    for (size_t i = 0; i < buffers.size(); i += HEADERS_PER_WRITE)
+    {
+        group.assign(buffers.begin() + i, buffers.begin() + std::min(i + HEADERS_PER_WRITE, buffers.size()));
+        batch.EncryptSend(group);
+    }
+    double batchTime = std::chrono::duration<double>(Clock::now() - start).count();
+
+    sLog.outString("Header crypt benchmark: %u headers", headers);
+    sLog.outString("  per header:          %.0f headers/s", singleTime > 0 ? headers / singleTime : 0.0);
+    sLog.outString("  batched by " SIZEFMTD ":       %.0f headers/s", HEADERS_PER_WRITE, batchTime > 0 ? headers / batchTime : 0.0);
+    sLog.outString("  results %s", perHeader == batched ? "match" : "DIFFER");
+}
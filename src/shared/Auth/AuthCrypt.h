@@ -22,11 +22,16 @@
 #include <Common.h>
 #include "SARC4.h"
 
+#include <vector>
+
 class BigNumber;
 
 class AuthCrypt
 {
     public:
+        /// Buffers (pointer and size) that follow each other in the encrypted stream
+        typedef std::vector<std::pair<uint8*, size_t> > BufferList;
+
         AuthCrypt();
         ~AuthCrypt();
 
@@ -34,6 +39,12 @@ class AuthCrypt
         void DecryptRecv(uint8*, size_t);
         void EncryptSend(uint8*, size_t);
 
+        /// Encrypt all buffers in order with as few cipher calls as possible, same result as EncryptSend() on each of them
+        void EncryptSend(BufferList const& buffers);
+
+        /// Measure headers per second of EncryptSend() per header and batched, and check they produce the same stream
+        static void RunBenchmark(uint32 headers);
+
         bool IsInitialized() { return _initialized; }
 
     private:
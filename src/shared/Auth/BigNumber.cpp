@@ -19,6 +19,24 @@
 #include "Auth/BigNumber.h"
 #include <openssl/bn.h>
 #include <algorithm>
+#include <ace/TSS_T.h>
+
+/// Scratch space of OpenSSL operations, one per thread instead of one per operation
+struct BigNumberContext
+{
+    BigNumberContext() : ctx(BN_CTX_new()) {}
+    ~BigNumberContext() { BN_CTX_free(ctx); }
+
+    BN_CTX* ctx;
+};
+
+typedef ACE_TSS<BigNumberContext> BigNumberContextTSS;
+static BigNumberContextTSS bnContext;
+
+BN_CTX* BigNumber::Context()
+{
+    return bnContext->ctx;
+}
 
 BigNumber::BigNumber()
 {
@@ -95,33 +113,21 @@ BigNumber BigNumber::operator-=(const BigNumber& bn)
 
 BigNumber BigNumber::operator*=(const BigNumber& bn)
 {
-    BN_CTX* bnctx;
-
-    bnctx = BN_CTX_new();
-    BN_mul(_bn, _bn, bn._bn, bnctx);
-    BN_CTX_free(bnctx);
+    BN_mul(_bn, _bn, bn._bn, Context());
 
     return *this;
 }
 
 BigNumber BigNumber::operator/=(const BigNumber& bn)
 {
-    BN_CTX* bnctx;
-
-    bnctx = BN_CTX_new();
-    BN_div(_bn, nullptr, _bn, bn._bn, bnctx);
-    BN_CTX_free(bnctx);
+    BN_div(_bn, nullptr, _bn, bn._bn, Context());
 
     return *this;
 }
 
 BigNumber BigNumber::operator%=(const BigNumber& bn)
 {
-    BN_CTX* bnctx;
-
-    bnctx = BN_CTX_new();
-    BN_mod(_bn, _bn, bn._bn, bnctx);
-    BN_CTX_free(bnctx);
+    BN_mod(_bn, _bn, bn._bn, Context());
 
     return *this;
 }
@@ -129,11 +135,7 @@ BigNumber BigNumber::operator%=(const BigNumber& bn)
 BigNumber BigNumber::Exp(const BigNumber& bn)
 {
     BigNumber ret;
-    BN_CTX* bnctx;
-
-    bnctx = BN_CTX_new();
-    BN_exp(ret._bn, _bn, bn._bn, bnctx);
-    BN_CTX_free(bnctx);
+    BN_exp(ret._bn, _bn, bn._bn, Context());
 
     return ret;
 }
@@ -141,11 +143,7 @@ BigNumber BigNumber::Exp(const BigNumber& bn)
 BigNumber BigNumber::ModExp(const BigNumber& bn1, const BigNumber& bn2)
 {
     BigNumber ret;
-    BN_CTX* bnctx;
-
-    bnctx = BN_CTX_new();
-    BN_mod_exp(ret._bn, _bn, bn1._bn, bn2._bn, bnctx);
-    BN_CTX_free(bnctx);
+    BN_mod_exp(ret._bn, _bn, bn1._bn, bn2._bn, Context());
 
     return ret;
 }
@@ -22,6 +22,7 @@
 #include "Common.h"
 
 struct bignum_st;
+struct bignum_ctx;
 
 class BigNumber
 {
@@ -80,6 +81,9 @@ class BigNumber
 
         struct bignum_st* BN() { return _bn; }
 
+        /// OpenSSL context of the calling thread, reused by all operations
+        static struct bignum_ctx* Context();
+
         uint32 AsDword();
         uint8* AsByteArray(int minSize = 0, bool reverse = true);
 
@@ -90,13 +90,29 @@ bool SqlConnection::ExecuteStmt(int nIndex, const SqlStmtParameters& id)
     return pStmt->execute();
 }
 
+QueryResult* SqlConnection::QueryStmt(int nIndex, const SqlStmtParameters& id)
+{
+    if (nIndex == -1)
+        return nullptr;
+
+    // get prepared statement object
+    SqlPreparedStatement* pStmt = GetStmt(nIndex);
+    if (!pStmt->isQuery())
+        return nullptr;
+
+    // bind parameters
+    pStmt->bind(id);
+    // execute statement and read result set
+    return pStmt->query();
+}
+
 //////////////////////////////////////////////////////////////////////////
 Database::~Database()
 {
     StopServer();
 }
 
-bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
+bool Database::Initialize(const char* infoString, int nConns /*= 1*/, int nAsyncConns /*= 1*/)
 {
     // Enable logging of SQL commands (usually only GM commands)
     // (See method: PExecuteLog)
@@ -133,10 +149,25 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
         m_pQueryConnections.push_back(pConn);
     }
 
-    // create and initialize connection for async requests
-    m_pAsyncConn = CreateConnection();
-    if (!m_pAsyncConn->Initialize(infoString))
-        return false;
+    // create and initialize connections for async requests
+    if (nAsyncConns < MIN_CONNECTION_POOL_SIZE)
+        nAsyncConns = MIN_CONNECTION_POOL_SIZE;
+    else if (nAsyncConns > MAX_CONNECTION_POOL_SIZE)
+        nAsyncConns = MAX_CONNECTION_POOL_SIZE;
+
+    for (int i = 0; i < nAsyncConns; ++i)
+    {
+        SqlConnection* pConn = CreateConnection();
+        if (!pConn->Initialize(infoString))
+        {
+            delete pConn;
+            return false;
+        }
+
+        m_pAsyncConnections.push_back(pConn);
+    }
+
+    m_pAsyncConn = m_pAsyncConnections[0];
 
     m_pResultQueue = new SqlResultQueue;
 
@@ -149,9 +180,12 @@ void Database::StopServer()
     HaltDelayThread();
 
     delete m_pResultQueue;
-    delete m_pAsyncConn;
-
     m_pResultQueue = nullptr;
+
+    for (size_t i = 0; i < m_pAsyncConnections.size(); ++i)
+        delete m_pAsyncConnections[i];
+
+    m_pAsyncConnections.clear();
     m_pAsyncConn = nullptr;
 
     for (size_t i = 0; i < m_pQueryConnections.size(); ++i)
@@ -160,30 +194,77 @@ void Database::StopServer()
     m_pQueryConnections.clear();
 }
 
-SqlDelayThread* Database::CreateDelayThread()
+SqlDelayThread* Database::CreateDelayThread(SqlConnection* conn, bool pingDatabase)
 {
-    assert(m_pAsyncConn);
-    return new SqlDelayThread(this, m_pAsyncConn);
+    assert(conn);
+    return new SqlDelayThread(this, conn, pingDatabase);
 }
 
 void Database::InitDelayThread()
 {
-    assert(!m_delayThread);
+    assert(m_delayThreads.empty());
 
-    // New delay thread for delay execute
-    m_threadBody = CreateDelayThread();              // will deleted at m_delayThread delete
-    m_delayThread = new MaNGOS::Thread(m_threadBody);
+    // New delay thread for delay execute, one per async connection
+    for (size_t i = 0; i < m_pAsyncConnections.size(); ++i)
+    {
+        SqlDelayThread* threadBody = CreateDelayThread(m_pAsyncConnections[i], i == 0);
+        m_threadBodies.push_back(threadBody);               // will deleted at delay thread delete
+        m_delayThreads.push_back(new MaNGOS::Thread(threadBody));
+    }
+
+    m_delayThreadsRunning = true;
 }
 
 void Database::HaltDelayThread()
 {
-    if (!m_threadBody || !m_delayThread) return;
+    if (m_threadBodies.empty() || m_delayThreads.empty()) return;
+
+    {
+        // barriers queued before are executed by the threads while flushing their queues,
+        // requests queued from now on are executed by the thread bodies destructors one after another
+        std::lock_guard<std::mutex> guard(m_barrierLock);
+        m_delayThreadsRunning = false;
+
+        for (size_t i = 0; i < m_threadBodies.size(); ++i)
+            m_threadBodies[i]->Stop();                      // Stop event
+    }
 
-    m_threadBody->Stop();                                   // Stop event
-    m_delayThread->wait();                                  // Wait for flush to DB
-    delete m_delayThread;                                   // This also deletes m_threadBody
-    m_delayThread = nullptr;
-    m_threadBody = nullptr;
+    for (size_t i = 0; i < m_delayThreads.size(); ++i)
+    {
+        m_delayThreads[i]->wait();                          // Wait for flush to DB
+        delete m_delayThreads[i];                           // This also deletes the thread body
+    }
+
+    m_delayThreads.clear();
+    m_threadBodies.clear();
+}
+
+void Database::DelayOperation(SqlOperation* op, uint32 shardKey)
+{
+    if (shardKey || m_threadBodies.size() == 1)
+    {
+        getDelayThread(shardKey)->Delay(op);
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(m_barrierLock);
+
+    if (!m_delayThreadsRunning)
+    {
+        getDelayThread()->Delay(op);
+        return;
+    }
+
+    SqlBarrierRequest::BarrierPtr barrier(new SqlBarrierRequest::Barrier(op, uint32(m_threadBodies.size())));
+    for (size_t i = 0; i < m_threadBodies.size(); ++i)
+        m_threadBodies[i]->Delay(new SqlBarrierRequest(barrier));
+}
+
+void Database::GetAsyncStats(std::vector<SqlDelayThreadStats>& stats) const
+{
+    stats.resize(m_threadBodies.size());
+    for (size_t i = 0; i < m_threadBodies.size(); ++i)
+        m_threadBodies[i]->GetStats(stats[i]);
 }
 
 void Database::ThreadStart()
@@ -212,8 +293,21 @@ void Database::escape_string(std::string& str)
     delete[] buf;
 }
 
+void Database::BindQueryConnection(uint32 index)
+{
+    m_threadConnection->conn = m_pQueryConnections[index % m_nQueryConnPoolSize];
+}
+
+void Database::UnbindQueryConnection()
+{
+    m_threadConnection->conn = nullptr;
+}
+
 SqlConnection* Database::getQueryConnection()
 {
+    if (SqlConnection* conn = m_threadConnection->conn)
+        return conn;
+
     int nCount = 0;
 
     if (m_nQueryCounter == long(1 << 31))
@@ -228,8 +322,9 @@ void Database::Ping()
 {
     const char* sql = "SELECT 1";
 
+    for (size_t i = 0; i < m_pAsyncConnections.size(); ++i)
     {
-        SqlConnection::Lock guard(m_pAsyncConn);
+        SqlConnection::Lock guard(m_pAsyncConnections[i]);
         delete guard->Query(sql);
     }
 
@@ -340,7 +435,7 @@ bool Database::Execute(const char* sql)
             return DirectExecute(sql);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPlainRequest(sql));
+        DelayOperation(new SqlPlainRequest(sql), 0);
     }
 
     return true;
@@ -386,14 +481,14 @@ bool Database::DirectPExecute(const char* format, ...)
     return DirectExecute(szQuery);
 }
 
-bool Database::BeginTransaction()
+bool Database::BeginTransaction(uint32 shardKey /*= 0*/)
 {
     if (!m_pAsyncConn)
         return false;
 
     // initiate transaction on current thread
     // currently we do not support queued transactions
-    m_TransStorage->init();
+    m_TransStorage->init(shardKey);
     return true;
 }
 
@@ -410,8 +505,9 @@ bool Database::CommitTransaction()
     if (!m_bAllowAsyncTransactions)
         return CommitTransactionDirect();
 
-    // add SqlTransaction to the async queue
-    m_threadBody->Delay(m_TransStorage->detach());
+    // add SqlTransaction to the async queue of its shard
+    SqlTransaction* pTrans = m_TransStorage->detach();
+    DelayOperation(pTrans, pTrans->GetShardKey());
     return true;
 }
 
@@ -426,12 +522,18 @@ bool Database::CommitTransactionDirect()
 
     // directly execute SqlTransaction
     SqlTransaction* pTrans = m_TransStorage->detach();
-    pTrans->Execute(m_pAsyncConn);
+    pTrans->Execute(getAsyncConnection(pTrans->GetShardKey()));
     delete pTrans;
 
     return true;
 }
 
+uint32 Database::GetTransactionSize()
+{
+    SqlTransaction* pTrans = m_TransStorage->get();
+    return pTrans ? pTrans->GetSize() : 0;
+}
+
 bool Database::RollbackTransaction()
 {
     if (!m_pAsyncConn)
@@ -552,7 +654,7 @@ bool Database::ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params)
             return DirectExecuteStmt(id, params);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPreparedRequest(id.ID(), params));
+        DelayOperation(new SqlPreparedRequest(id.ID(), params), 0);
     }
 
     return true;
@@ -567,6 +669,15 @@ bool Database::DirectExecuteStmt(const SqlStatementID& id, SqlStmtParameters* pa
     return _guard->ExecuteStmt(id.ID(), *params);
 }
 
+QueryResult* Database::QueryStmt(const SqlStatementID& id, SqlStmtParameters* params)
+{
+    MANGOS_ASSERT(params);
+    std::auto_ptr<SqlStmtParameters> p(params);
+    // query statement
+    SqlConnection::Lock _guard(getQueryConnection());
+    return _guard->QueryStmt(id.ID(), *params);
+}
+
 SqlStatement Database::CreateStatement(SqlStatementID& index, const char* fmt)
 {
     int nId = -1;
@@ -618,10 +729,10 @@ Database::TransHelper::~TransHelper()
     reset();
 }
 
-SqlTransaction* Database::TransHelper::init()
+SqlTransaction* Database::TransHelper::init(uint32 shardKey)
 {
     MANGOS_ASSERT(!m_pTrans);   // if we will get a nested transaction request - we MUST fix code!!!
-    m_pTrans = new SqlTransaction;
+    m_pTrans = new SqlTransaction(shardKey);
     return m_pTrans;
 }
 
@@ -63,6 +63,7 @@ class MANGOS_DLL_SPEC SqlConnection
 
         // methods to work with prepared statements
         bool ExecuteStmt(int nIndex, const SqlStmtParameters& id);
+        QueryResult* QueryStmt(int nIndex, const SqlStmtParameters& id);
 
         // SqlConnection object lock
         class Lock
@@ -104,10 +105,10 @@ class MANGOS_DLL_SPEC Database
     public:
         virtual ~Database();
 
-        virtual bool Initialize(const char* infoString, int nConns = 1);
-        // start worker thread for async DB request execution
+        virtual bool Initialize(const char* infoString, int nConns = 1, int nAsyncConns = 1);
+        // start worker threads for async DB request execution
         virtual void InitDelayThread();
-        // stop worker thread
+        // stop worker threads
         virtual void HaltDelayThread();
 
         /// Synchronous DB queries
@@ -183,11 +184,16 @@ class MANGOS_DLL_SPEC Database
         // Writes SQL commands to a LOG file (see mangosd.conf "LogSQL")
         bool PExecuteLog(const char* format, ...) ATTR_PRINTF(2, 3);
 
-        bool BeginTransaction();
+        // operations of transactions with same shard key (usually the guid of the only character they touch)
+        // are executed in order, others can be executed in parallel when more than one async connection is used
+        // transactions without key are ordered with all async requests, use them for data of several characters
+        bool BeginTransaction(uint32 shardKey = 0);
         bool CommitTransaction();
         bool RollbackTransaction();
         // for sync transaction execution
         bool CommitTransactionDirect();
+        // number of requests added to the transaction of the current thread so far
+        uint32 GetTransactionSize();
 
         // PREPARED STATEMENT API
 
@@ -206,6 +212,11 @@ class MANGOS_DLL_SPEC Database
         // must be called before finish thread run (one time for thread using one from existing Database objects)
         virtual void ThreadEnd();
 
+        // bind the calling thread to sync query connection index (modulo the pool size), all its queries use it
+        // threads bound to different connections don't wait for each others queries
+        void BindQueryConnection(uint32 index);
+        void UnbindQueryConnection();
+
         // set database-wide result queue. also we should use object-bases and not thread-based result queues
         void ProcessResultQueue();
 
@@ -215,6 +226,15 @@ class MANGOS_DLL_SPEC Database
         // function to ping database connections
         void Ping();
 
+        // number of connections (and worker threads) used for async requests
+        uint32 GetAsyncConnectionCount() const { return uint32(m_pAsyncConnections.size()); }
+        // queue depth and latency counters of each async connection
+        void GetAsyncStats(std::vector<SqlDelayThreadStats>& stats) const;
+
+        // queue an async request on the connection of its shard key, a request without key (0)
+        // waits for the requests queued before on all connections and delays all requests queued after it
+        void DelayOperation(SqlOperation* op, uint32 shardKey);
+
         // set this to allow async transactions
         // you should call it explicitly after your server successfully started up
         // NO ASYNC TRANSACTIONS DURING SERVER STARTUP - ONLY DURING RUNTIME!!!
@@ -223,7 +243,7 @@ class MANGOS_DLL_SPEC Database
     protected:
         Database() :
             m_nQueryConnPoolSize(1), m_pAsyncConn(nullptr), m_pResultQueue(nullptr),
-            m_threadBody(nullptr), m_delayThread(nullptr), m_bAllowAsyncTransactions(false),
+            m_delayThreadsRunning(false), m_bAllowAsyncTransactions(false),
             m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0)
         {
             m_nQueryCounter = -1;
@@ -234,7 +254,7 @@ class MANGOS_DLL_SPEC Database
         // factory method to create SqlConnection objects
         virtual SqlConnection* CreateConnection() = 0;
         // factory method to create SqlDelayThread objects
-        virtual SqlDelayThread* CreateDelayThread();
+        virtual SqlDelayThread* CreateDelayThread(SqlConnection* conn, bool pingDatabase);
 
         class MANGOS_DLL_SPEC TransHelper
         {
@@ -243,7 +263,7 @@ class MANGOS_DLL_SPEC Database
                 ~TransHelper();
 
                 // initializes new SqlTransaction object
-                SqlTransaction* init();
+                SqlTransaction* init(uint32 shardKey);
                 // gets pointer on current transaction object. Returns nullptr if transaction was not initiated
                 SqlTransaction* get() const { return m_pTrans; }
                 // detaches SqlTransaction object allocated by init() function
@@ -261,18 +281,30 @@ class MANGOS_DLL_SPEC Database
         typedef ACE_TSS<Database::TransHelper> DBTransHelperTSS;
         Database::DBTransHelperTSS m_TransStorage;
 
+        // per-thread sync query connection set by BindQueryConnection()
+        struct ThreadConnection
+        {
+            ThreadConnection() : conn(nullptr) {}
+            SqlConnection* conn;
+        };
+
+        typedef ACE_TSS<ThreadConnection> ThreadConnectionTSS;
+        ThreadConnectionTSS m_threadConnection;
+
         ///< DB connections
 
-        // round-robin connection selection
+        // connection bound to the thread, round-robin connection selection otherwise
         SqlConnection* getQueryConnection();
-        // for now return one single connection for async requests
-        SqlConnection* getAsyncConnection() const { return m_pAsyncConn; }
+        // connection and worker thread used for async requests with this shard key
+        SqlConnection* getAsyncConnection(uint32 shardKey = 0) const { return m_pAsyncConnections[shardKey % m_pAsyncConnections.size()]; }
+        SqlDelayThread* getDelayThread(uint32 shardKey = 0) const { return m_threadBodies[shardKey % m_threadBodies.size()]; }
 
         friend class SqlStatement;
         // PREPARED STATEMENT API
         // query function for prepared statements
         bool ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params);
         bool DirectExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params);
+        QueryResult* QueryStmt(const SqlStatementID& id, SqlStmtParameters* params);
 
         // connection helper counters
         int m_nQueryConnPoolSize;                           // current size of query connection pool
@@ -282,12 +314,20 @@ class MANGOS_DLL_SPEC Database
         typedef std::vector< SqlConnection* > SqlConnectionContainer;
         SqlConnectionContainer m_pQueryConnections;
 
-        // only one single DB connection for transactions
+        // pool of connections for transactions and async queries, one worker thread per connection
+        SqlConnectionContainer m_pAsyncConnections;
+        // first async connection, also used for direct execution
         SqlConnection* m_pAsyncConn;
 
+        typedef std::vector<SqlDelayThread*> SqlDelayThreadContainer;
+        typedef std::vector<MaNGOS::Thread*> ThreadContainer;
+
         SqlResultQueue*     m_pResultQueue;                 ///< Transaction queues from diff. threads
-        SqlDelayThread*     m_threadBody;                   ///< Pointer to delay sql executer (owned by m_delayThread)
-        MaNGOS::Thread*     m_delayThread;                  ///< Pointer to executer thread
+        SqlDelayThreadContainer m_threadBodies;             ///< Delay sql executers, one per async connection (owned by m_delayThreads)
+        ThreadContainer     m_delayThreads;                 ///< Executer threads
+
+        std::mutex m_barrierLock;                           ///< requests without shard key are queued on all threads in the same order
+        bool m_delayThreadsRunning;                         ///< cleared under m_barrierLock when the threads are stopped
 
         bool m_bAllowAsyncTransactions;                     ///< flag which specifies if async transactions are enabled
 
@@ -315,7 +315,7 @@ SqlPreparedStatement* MySQLConnection::CreateStatement(const std::string& fmt)
 
 //////////////////////////////////////////////////////////////////////////
 MySqlPreparedStatement::MySqlPreparedStatement(const std::string& fmt, SqlConnection& conn, MYSQL* mysql) : SqlPreparedStatement(fmt, conn),
-    m_pMySQLConn(mysql), m_stmt(nullptr), m_pInputArgs(nullptr), m_pResult(nullptr), m_pResultMetadata(nullptr)
+    m_pMySQLConn(mysql), m_stmt(nullptr), m_pInputArgs(nullptr), m_pResultMetadata(nullptr)
 {
 }
 
@@ -376,7 +376,7 @@ bool MySqlPreparedStatement::prepare()
         /* Get total columns in the query */
         m_nColumns = mysql_num_fields(m_pResultMetadata);
 
-        // bind output buffers
+        // output buffers are bound by QueryResultMysqlStmt for each query
     }
 
     m_bPrepared = true;
@@ -444,14 +444,12 @@ void MySqlPreparedStatement::RemoveBinds()
         return;
 
     delete[] m_pInputArgs;
-    delete[] m_pResult;
 
     mysql_free_result(m_pResultMetadata);
     mysql_stmt_close(m_stmt);
 
     m_stmt = nullptr;
     m_pResultMetadata = nullptr;
-    m_pResult = nullptr;
     m_pInputArgs = nullptr;
 
     m_bPrepared = false;
@@ -472,6 +470,29 @@ bool MySqlPreparedStatement::execute()
     return true;
 }
 
+QueryResult* MySqlPreparedStatement::query()
+{
+    if (!isPrepared() || !isQuery())
+        return nullptr;
+
+    uint32 _s = WorldTimer::getMSTime();
+
+    if (!execute())
+        return nullptr;
+
+    QueryResultMysqlStmt* queryResult = new QueryResultMysqlStmt(m_nColumns);
+    if (!queryResult->FetchRows(m_stmt, m_pResultMetadata) || !queryResult->GetRowCount())
+    {
+        delete queryResult;
+        return nullptr;
+    }
+
+    DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), m_szFmt.c_str());
+
+    queryResult->NextRow();
+    return queryResult;
+}
+
 enum_field_types MySqlPreparedStatement::ToMySQLType(const SqlStmtFieldData& data, my_bool& bUnsigned)
 {
     bUnsigned = 0;
@@ -48,6 +48,9 @@ class MANGOS_DLL_SPEC MySqlPreparedStatement : public SqlPreparedStatement
         // execute DML statement
         virtual bool execute() override;
 
+        // execute query and read result set with binary protocol
+        virtual QueryResult* query() override;
+
     protected:
         // bind parameters
         void addParam(unsigned int nIndex, const SqlStmtFieldData& data);
@@ -60,7 +63,6 @@ class MANGOS_DLL_SPEC MySqlPreparedStatement : public SqlPreparedStatement
         MYSQL* m_pMySQLConn;
         MYSQL_STMT* m_stmt;
         MYSQL_BIND* m_pInputArgs;
-        MYSQL_BIND* m_pResult;
         MYSQL_RES* m_pResultMetadata;
 };
 
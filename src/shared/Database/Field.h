@@ -21,6 +21,8 @@
 
 #include "Common.h"
 
+#include <cfloat>
+
 class Field
 {
     public:
@@ -34,28 +36,44 @@ class Field
             DB_TYPE_BOOL    = 0x04
         };
 
-        Field() : mValue(nullptr), mType(DB_TYPE_UNKNOWN) {}
-        Field(const char* value, enum DataTypes type) : mValue(value), mType(type) {}
+        Field() : mValue(nullptr), mType(DB_TYPE_UNKNOWN), mBinary(BINARY_NONE) { mNumeric.u = 0; }
+        Field(const char* value, enum DataTypes type) : mValue(value), mType(type), mBinary(BINARY_NONE) { mNumeric.u = 0; }
 
         ~Field() {}
 
         enum DataTypes GetType() const { return mType; }
         bool IsNULL() const { return mValue == nullptr; }
 
-        const char* GetString() const { return mValue; }
+        const char* GetString() const { return mBinary ? BinaryToString() : mValue; }
         std::string GetCppString() const
         {
-            return mValue ? mValue : "";                    // std::string s = 0 have undefine result in C++
+            const char* value = GetString();
+            return value ? value : "";                      // std::string s = 0 have undefine result in C++
+        }
+        float GetFloat() const
+        {
+            if (mBinary)
+                return static_cast<float>(BinaryToDouble());
+
+            return mValue ? static_cast<float>(atof(mValue)) : 0.0f;
+        }
+        bool GetBool() const
+        {
+            if (mBinary)
+                return mBinary == BINARY_UINT64 ? mNumeric.u > 0 : BinaryToInt64() > 0;
+
+            return mValue ? atoi(mValue) > 0 : false;
         }
-        float GetFloat() const { return mValue ? static_cast<float>(atof(mValue)) : 0.0f; }
-        bool GetBool() const { return mValue ? atoi(mValue) > 0 : false; }
-        int32 GetInt32() const { return mValue ? static_cast<int32>(atol(mValue)) : int32(0); }
-        uint8 GetUInt8() const { return mValue ? static_cast<uint8>(atol(mValue)) : uint8(0); }
-        uint16 GetUInt16() const { return mValue ? static_cast<uint16>(atol(mValue)) : uint16(0); }
-        int16 GetInt16() const { return mValue ? static_cast<int16>(atol(mValue)) : int16(0); }
-        uint32 GetUInt32() const { return mValue ? static_cast<uint32>(atol(mValue)) : uint32(0); }
+        int32 GetInt32() const { return static_cast<int32>(GetInteger()); }
+        uint8 GetUInt8() const { return static_cast<uint8>(GetInteger()); }
+        uint16 GetUInt16() const { return static_cast<uint16>(GetInteger()); }
+        int16 GetInt16() const { return static_cast<int16>(GetInteger()); }
+        uint32 GetUInt32() const { return static_cast<uint32>(GetInteger()); }
         uint64 GetUInt64() const
         {
+            if (mBinary)
+                return mBinary == BINARY_UINT64 ? mNumeric.u : static_cast<uint64>(BinaryToInt64());
+
             uint64 value = 0;
             if (!mValue || sscanf(mValue, UI64FMTD, &value) == -1)
                 return 0;
@@ -66,13 +84,92 @@ class Field
         void SetType(enum DataTypes type) { mType = type; }
         // no need for memory allocations to store resultset field strings
         // all we need is to cache pointers returned by different DBMS APIs
-        void SetValue(const char* value) { mValue = value; };
+        void SetValue(const char* value) { mValue = value; mBinary = BINARY_NONE; }
+
+        // size of the buffer a binary value is formatted into by GetString()
+        static const size_t NUMERIC_TEXT_SIZE = 32;
+
+        // native values from binary (prepared statement) result sets, text is only built if requested
+        // into the NUMERIC_TEXT_SIZE bytes at text, owned by the result set like the text values
+        void SetInt64Value(int64 value, char* text) { mNumeric.i = value; SetBinary(BINARY_INT64, text); }
+        void SetUInt64Value(uint64 value, char* text) { mNumeric.u = value; SetBinary(BINARY_UINT64, text); }
+        void SetDoubleValue(double value, bool singlePrecision, char* text) { mNumeric.d = value; SetBinary(singlePrecision ? BINARY_FLOAT : BINARY_DOUBLE, text); }
 
     private:
         Field(Field const&);
         Field& operator=(Field const&);
 
+        enum BinaryTypes
+        {
+            BINARY_NONE     = 0x00,                         // value is text in mValue
+            BINARY_INT64    = 0x01,
+            BINARY_UINT64   = 0x02,
+            BINARY_FLOAT    = 0x03,
+            BINARY_DOUBLE   = 0x04
+        };
+
+        void SetBinary(BinaryTypes type, char* text)
+        {
+            mBinary = type;
+            text[0] = '\0';                                 // formatted on first GetString()
+            mValue = text;
+        }
+
+        int64 GetInteger() const
+        {
+            if (mBinary)
+                return BinaryToInt64();
+
+            return mValue ? static_cast<int64>(atol(mValue)) : 0;
+        }
+
+        int64 BinaryToInt64() const
+        {
+            switch (mBinary)
+            {
+                case BINARY_UINT64: return static_cast<int64>(mNumeric.u);
+                case BINARY_FLOAT:
+                case BINARY_DOUBLE: return static_cast<int64>(mNumeric.d);
+                default:            return mNumeric.i;
+            }
+        }
+
+        double BinaryToDouble() const
+        {
+            switch (mBinary)
+            {
+                case BINARY_INT64:  return static_cast<double>(mNumeric.i);
+                case BINARY_UINT64: return static_cast<double>(mNumeric.u);
+                default:            return mNumeric.d;
+            }
+        }
+
+        const char* BinaryToString() const
+        {
+            // mValue points to the writable buffer given to SetBinary()
+            char* text = const_cast<char*>(mValue);
+            if (!text[0])
+            {
+                switch (mBinary)
+                {
+                    case BINARY_INT64:  snprintf(text, NUMERIC_TEXT_SIZE, SI64FMTD, mNumeric.i); break;
+                    case BINARY_UINT64: snprintf(text, NUMERIC_TEXT_SIZE, UI64FMTD, mNumeric.u); break;
+                    case BINARY_FLOAT:  snprintf(text, NUMERIC_TEXT_SIZE, "%.*g", FLT_DIG, mNumeric.d); break;
+                    default:            snprintf(text, NUMERIC_TEXT_SIZE, "%.*g", DBL_DIG, mNumeric.d); break;
+                }
+            }
+
+            return text;
+        }
+
         const char* mValue;
         enum DataTypes mType;
+        BinaryTypes mBinary;
+        union
+        {
+            int64 i;
+            uint64 u;
+            double d;
+        } mNumeric;
 };
 #endif
@@ -68,7 +68,7 @@ void QueryResultMysql::EndQuery()
     }
 }
 
-enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType) const
+enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType)
 {
     switch (mysqlType)
     {
@@ -98,4 +98,193 @@ enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysql
             return Field::DB_TYPE_UNKNOWN;
     }
 }
+
+//////////////////////////////////////////////////////////////////////////
+QueryResultMysqlStmt::QueryResultMysqlStmt(uint32 fieldCount) :
+    QueryResult(0, fieldCount), mNumericText(fieldCount * Field::NUMERIC_TEXT_SIZE), mNextRow(0)
+{
+    mCurrentRow = new Field[mFieldCount];
+    MANGOS_ASSERT(mCurrentRow);
+}
+
+QueryResultMysqlStmt::~QueryResultMysqlStmt()
+{
+    EndQuery();
+}
+
+bool QueryResultMysqlStmt::FetchRows(MYSQL_STMT* stmt, MYSQL_RES* metadata)
+{
+    // strings longer than this are read in a second step with a buffer of exact size
+    static const unsigned long MAX_INITIAL_STRING_BUFFER = 1024;
+
+    struct ColumnBuffer
+    {
+        CellValue value;
+        std::vector<char> text;
+        unsigned long length;
+        my_bool isNull;
+    };
+
+    MYSQL_FIELD* fields = mysql_fetch_fields(metadata);
+
+    std::vector<ColumnBuffer> buffers(mFieldCount);
+    std::vector<MYSQL_BIND> binds(mFieldCount);
+    memset(&binds[0], 0, sizeof(MYSQL_BIND) * mFieldCount);
+    mColumns.resize(mFieldCount);
+
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        MYSQL_FIELD const& field = fields[i];
+        ColumnBuffer& buffer = buffers[i];
+        MYSQL_BIND& bind = binds[i];
+
+        mCurrentRow[i].SetType(QueryResultMysql::ConvertNativeType(field.type));
+
+        bind.length = &buffer.length;
+        bind.is_null = &buffer.isNull;
+
+        switch (field.type)
+        {
+            case MYSQL_TYPE_TINY:
+            case MYSQL_TYPE_SHORT:
+            case MYSQL_TYPE_LONG:
+            case MYSQL_TYPE_INT24:
+            case MYSQL_TYPE_LONGLONG:
+                mColumns[i] = (field.flags & UNSIGNED_FLAG) ? COLUMN_UINT64 : COLUMN_INT64;
+                bind.buffer_type = MYSQL_TYPE_LONGLONG;
+                bind.is_unsigned = (field.flags & UNSIGNED_FLAG) ? 1 : 0;
+                bind.buffer = &buffer.value;
+                break;
+            case MYSQL_TYPE_FLOAT:
+            case MYSQL_TYPE_DOUBLE:
+                mColumns[i] = field.type == MYSQL_TYPE_FLOAT ? COLUMN_FLOAT : COLUMN_DOUBLE;
+                bind.buffer_type = MYSQL_TYPE_DOUBLE;
+                bind.buffer = &buffer.value;
+                break;
+            default:                                        // text, blobs, decimals, dates: as the server formats them
+                mColumns[i] = COLUMN_STRING;
+                buffer.text.resize(std::min(field.length, MAX_INITIAL_STRING_BUFFER) + 1);
+                bind.buffer_type = MYSQL_TYPE_STRING;
+                bind.buffer = &buffer.text[0];
+                bind.buffer_length = buffer.text.size();
+                break;
+        }
+    }
+
+    if (mysql_stmt_bind_result(stmt, &binds[0]))
+    {
+        sLog.outError("SQL ERROR: mysql_stmt_bind_result() failed");
+        sLog.outError("SQL ERROR: %s", mysql_stmt_error(stmt));
+        mysql_stmt_free_result(stmt);
+        return false;
+    }
+
+    for (;;)
+    {
+        int status = mysql_stmt_fetch(stmt);
+        if (status == MYSQL_NO_DATA)
+            break;
+
+        if (status == 1)
+        {
+            sLog.outError("SQL ERROR: mysql_stmt_fetch() failed");
+            sLog.outError("SQL ERROR: %s", mysql_stmt_error(stmt));
+            mysql_stmt_free_result(stmt);
+            return false;
+        }
+
+        bool rebind = false;
+        for (uint32 i = 0; i < mFieldCount; ++i)
+        {
+            ColumnBuffer& buffer = buffers[i];
+            CellValue cell = buffer.value;
+
+            if (!buffer.isNull && mColumns[i] == COLUMN_STRING)
+            {
+                // value did not fit, grow buffer and read the whole value again
+                if (buffer.length >= buffer.text.size())
+                {
+                    buffer.text.resize(buffer.length + 1);
+                    binds[i].buffer = &buffer.text[0];
+                    binds[i].buffer_length = buffer.text.size();
+                    if (mysql_stmt_fetch_column(stmt, &binds[i], i, 0))
+                    {
+                        sLog.outError("SQL ERROR: mysql_stmt_fetch_column() failed");
+                        sLog.outError("SQL ERROR: %s", mysql_stmt_error(stmt));
+                        mysql_stmt_free_result(stmt);
+                        return false;
+                    }
+                    rebind = true;
+                }
+
+                cell.u = mStrings.size();
+                mStrings.insert(mStrings.end(), buffer.text.begin(), buffer.text.begin() + buffer.length);
+                mStrings.push_back('\0');
+            }
+
+            mCells.push_back(cell);
+            mNulls.push_back(buffer.isNull != 0);
+        }
+
+        // grown buffers are used for next rows
+        if (rebind && mysql_stmt_bind_result(stmt, &binds[0]))
+        {
+            sLog.outError("SQL ERROR: mysql_stmt_bind_result() failed");
+            sLog.outError("SQL ERROR: %s", mysql_stmt_error(stmt));
+            mysql_stmt_free_result(stmt);
+            return false;
+        }
+    }
+
+    mysql_stmt_free_result(stmt);
+
+    mRowCount = mFieldCount ? mCells.size() / mFieldCount : 0;
+    return true;
+}
+
+bool QueryResultMysqlStmt::NextRow()
+{
+    if (mNextRow >= mRowCount)
+    {
+        EndQuery();
+        return false;
+    }
+
+    size_t rowStart = size_t(mNextRow * mFieldCount);
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        Field& field = mCurrentRow[i];
+        CellValue const& cell = mCells[rowStart + i];
+        char* text = &mNumericText[i * Field::NUMERIC_TEXT_SIZE];
+
+        if (mNulls[rowStart + i])
+        {
+            field.SetValue(nullptr);
+            continue;
+        }
+
+        switch (mColumns[i])
+        {
+            case COLUMN_STRING: field.SetValue(&mStrings[size_t(cell.u)]);       break;
+            case COLUMN_INT64:  field.SetInt64Value(cell.i, text);               break;
+            case COLUMN_UINT64: field.SetUInt64Value(cell.u, text);              break;
+            case COLUMN_FLOAT:  field.SetDoubleValue(cell.d, true, text);        break;
+            case COLUMN_DOUBLE: field.SetDoubleValue(cell.d, false, text);       break;
+        }
+    }
+
+    ++mNextRow;
+    return true;
+}
+
+void QueryResultMysqlStmt::EndQuery()
+{
+    delete[] mCurrentRow;
+    mCurrentRow = 0;
+
+    mCells.clear();
+    mNulls.clear();
+    mStrings.clear();
+    mNumericText.clear();
+}
 #endif
@@ -39,11 +39,54 @@ class QueryResultMysql : public QueryResult
 
         bool NextRow() override;
 
+        static enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType);
+
     private:
-        enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType) const;
         void EndQuery();
 
         MYSQL_RES* mResult;
 };
+
+/// Result set of a MySQL prepared statement
+/// Rows are read with the binary protocol into typed buffers, so numeric columns reach
+/// Field as native values and never go through text formatting and parsing.
+class QueryResultMysqlStmt : public QueryResult
+{
+    public:
+        explicit QueryResultMysqlStmt(uint32 fieldCount);
+
+        ~QueryResultMysqlStmt();
+
+        /// Read all rows of executed statement, must be called with the statement connection locked
+        bool FetchRows(MYSQL_STMT* stmt, MYSQL_RES* metadata);
+
+        bool NextRow() override;
+
+    private:
+        enum ColumnTypes
+        {
+            COLUMN_STRING,
+            COLUMN_INT64,
+            COLUMN_UINT64,
+            COLUMN_FLOAT,
+            COLUMN_DOUBLE
+        };
+
+        union CellValue
+        {
+            int64 i;
+            uint64 u;                                       // offset in mStrings for string columns
+            double d;
+        };
+
+        void EndQuery();
+
+        std::vector<ColumnTypes> mColumns;
+        std::vector<CellValue> mCells;                      // all rows, row by row
+        std::vector<bool> mNulls;
+        std::vector<char> mStrings;                         // zero terminated values of string columns
+        std::vector<char> mNumericText;                     // GetString() buffers of the current row, Field::NUMERIC_TEXT_SIZE per column
+        uint64 mNextRow;
+};
 #endif
 #endif
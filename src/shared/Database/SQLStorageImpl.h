@@ -189,7 +189,10 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         delete result;
     }
 
-    result = WorldDatabase.PQuery("SELECT * FROM %s", store.GetTableName());
+    // prepared statement: rows come with the binary protocol, numeric columns are not parsed from text
+    std::string selectSql = std::string("SELECT * FROM ") + store.GetTableName();
+    SqlStatementID selectStmt;
+    result = WorldDatabase.CreateStatement(selectStmt, selectSql.c_str()).Query();
 
     if (!result)
     {
@@ -19,8 +19,13 @@
 #include "Database/SqlDelayThread.h"
 #include "Database/SqlOperations.h"
 #include "DatabaseEnv.h"
+#include "Timer.h"
 
-SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn) : m_dbEngine(db), m_dbConnection(conn), m_running(true)
+#include <chrono>
+
+SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn, bool pingDatabase)
+    : m_dbEngine(db), m_dbConnection(conn), m_running(true), m_pingDatabase(pingDatabase),
+      m_executed(0), m_totalLatency(0), m_lastLatency(0), m_maxLatency(0)
 {
 }
 
@@ -30,29 +35,52 @@ SqlDelayThread::~SqlDelayThread()
     ProcessRequests();
 }
 
+bool SqlDelayThread::Delay(SqlOperation* sql)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_queueLock);
+        m_sqlQueue.push_back(QueuedOperation(sql, WorldTimer::getMSTime()));
+    }
+    m_queueCond.notify_one();
+    return true;
+}
+
 void SqlDelayThread::run()
 {
 #ifndef DO_POSTGRESQL
     mysql_thread_init();
 #endif
 
-    const uint32 loopSleepms = 10;
+    // MaxPingTime = 0 disables the pings
+    std::chrono::milliseconds const pingInterval(m_dbEngine->GetPingIntervall());
+    bool const ping = pingInterval.count() > 0;
+    std::chrono::steady_clock::time_point nextPing = std::chrono::steady_clock::now() + pingInterval;
 
-    const uint32 pingEveryLoop = m_dbEngine->GetPingIntervall() / loopSleepms;
-
-    uint32 loopCounter = 0;
-    while (m_running)
+    for (;;)
     {
+        bool running;
+        {
+            // sleep until something is queued, stop is requested or a ping is due
+            std::unique_lock<std::mutex> guard(m_queueLock);
+            if (ping)
+                m_queueCond.wait_until(guard, nextPing, [this] { return !m_running || !m_sqlQueue.empty(); });
+            else
+                m_queueCond.wait(guard, [this] { return !m_running || !m_sqlQueue.empty(); });
+            running = m_running;
+        }
+
         // if the running state gets turned off while sleeping
         // empty the queue before exiting
-        MaNGOS::Thread::Sleep(loopSleepms);
-
         ProcessRequests();
 
-        if ((loopCounter++) >= pingEveryLoop)
+        if (!running)
+            break;
+
+        if (ping && std::chrono::steady_clock::now() >= nextPing)
         {
-            loopCounter = 0;
-            m_dbEngine->Ping();
+            nextPing = std::chrono::steady_clock::now() + pingInterval;
+            if (m_pingDatabase)
+                m_dbEngine->Ping();
         }
     }
 
@@ -63,15 +91,43 @@ void SqlDelayThread::run()
 
 void SqlDelayThread::Stop()
 {
-    m_running = false;
+    {
+        std::lock_guard<std::mutex> guard(m_queueLock);
+        m_running = false;
+    }
+    m_queueCond.notify_one();
+}
+
+void SqlDelayThread::GetStats(SqlDelayThreadStats& stats) const
+{
+    std::lock_guard<std::mutex> guard(m_queueLock);
+    stats.queueSize = uint32(m_sqlQueue.size());
+    stats.executed = m_executed;
+    stats.lastLatency = m_lastLatency;
+    stats.avgLatency = m_executed ? uint32(m_totalLatency / m_executed) : 0;
+    stats.maxLatency = m_maxLatency;
 }
 
 void SqlDelayThread::ProcessRequests()
 {
-    SqlOperation* s = nullptr;
-    while (m_sqlQueue.next(s))
+    SqlQueue batch;
     {
-        s->Execute(m_dbConnection);
-        delete s;
+        std::lock_guard<std::mutex> guard(m_queueLock);
+        batch.swap(m_sqlQueue);
+    }
+
+    for (SqlQueue::const_iterator itr = batch.begin(); itr != batch.end(); ++itr)
+    {
+        itr->op->Execute(m_dbConnection);
+        delete itr->op;
+
+        uint32 latency = WorldTimer::getMSTimeDiff(itr->queueTime, WorldTimer::getMSTime());
+
+        std::lock_guard<std::mutex> guard(m_queueLock);
+        ++m_executed;
+        m_totalLatency += latency;
+        m_lastLatency = latency;
+        if (latency > m_maxLatency)
+            m_maxLatency = latency;
     }
 }
@@ -19,34 +19,67 @@
 #ifndef __SQLDELAYTHREAD_H
 #define __SQLDELAYTHREAD_H
 
-#include "LockedQueue.h"
+#include "Common.h"
 #include "Threading.h"
 
+#include <condition_variable>
+#include <deque>
 #include <mutex>
 
 class Database;
 class SqlOperation;
 class SqlConnection;
 
+/// Counters of one async connection, see Database::GetAsyncStats()
+struct SqlDelayThreadStats
+{
+    SqlDelayThreadStats() : queueSize(0), executed(0), lastLatency(0), avgLatency(0), maxLatency(0) {}
+
+    uint32 queueSize;                                       ///< operations waiting for execution
+    uint64 executed;                                        ///< operations executed since start
+    uint32 lastLatency;                                     ///< ms between queueing and end of execution, last operation
+    uint32 avgLatency;                                      ///< same, average over all executed operations
+    uint32 maxLatency;                                      ///< same, highest value
+};
+
 class SqlDelayThread : public MaNGOS::Runnable
 {
-        typedef ACE_Based::LockedQueue<SqlOperation*> SqlQueue;
+        struct QueuedOperation
+        {
+            QueuedOperation(SqlOperation* _op, uint32 _queueTime) : op(_op), queueTime(_queueTime) {}
+
+            SqlOperation* op;
+            uint32 queueTime;
+        };
+
+        typedef std::deque<QueuedOperation> SqlQueue;
 
     private:
         SqlQueue m_sqlQueue;                                ///< Queue of SQL statements
         Database* m_dbEngine;                               ///< Pointer to used Database engine
         SqlConnection* m_dbConnection;                      ///< Pointer to DB connection
-        volatile bool m_running;
+        bool m_running;
+        bool m_pingDatabase;                                ///< ping all connections of m_dbEngine, only one thread per database does it
+
+        mutable std::mutex m_queueLock;                     ///< guards m_sqlQueue, m_running and the counters
+        std::condition_variable m_queueCond;                ///< signaled on new operation and at stop
+
+        uint64 m_executed;
+        uint64 m_totalLatency;
+        uint32 m_lastLatency;
+        uint32 m_maxLatency;
 
         // process all enqueued requests
         void ProcessRequests();
 
     public:
-        SqlDelayThread(Database* db, SqlConnection* conn);
+        SqlDelayThread(Database* db, SqlConnection* conn, bool pingDatabase);
         ~SqlDelayThread();
 
         ///< Put sql statement to delay queue
-        bool Delay(SqlOperation* sql) { m_sqlQueue.add(sql); return true; }
+        bool Delay(SqlOperation* sql);
+
+        void GetStats(SqlDelayThreadStats& stats) const;
 
         virtual void Stop();                                ///< Stop event
         virtual void run();                                 ///< Main Thread loop
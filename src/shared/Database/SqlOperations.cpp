@@ -65,6 +65,27 @@ bool SqlTransaction::Execute(SqlConnection* conn)
     return conn->CommitTransaction();
 }
 
+bool SqlBarrierRequest::Execute(SqlConnection* conn)
+{
+    {
+        std::unique_lock<std::mutex> guard(m_barrier->m_lock);
+        if (--m_barrier->m_waiting)
+        {
+            m_barrier->m_doneCond.wait(guard, [this] { return m_barrier->m_done; });
+            return true;
+        }
+    }
+
+    bool result = m_barrier->m_op->Execute(conn);
+
+    {
+        std::lock_guard<std::mutex> guard(m_barrier->m_lock);
+        m_barrier->m_done = true;
+    }
+    m_barrier->m_doneCond.notify_all();
+    return result;
+}
+
 SqlPreparedRequest::SqlPreparedRequest(int nIndex, SqlStmtParameters* arg) : m_nIndex(nIndex), m_param(arg)
 {
 }
@@ -107,15 +128,15 @@ void SqlResultQueue::Update()
     }
 }
 
-bool SqlQueryHolder::Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue)
+bool SqlQueryHolder::Execute(MaNGOS::IQueryCallback* callback, Database* db, SqlResultQueue* queue)
 {
-    if (!callback || !thread || !queue)
+    if (!callback || !db || !queue)
         return false;
 
     /// delay the execution of the queries, sync them with the delay thread
     /// which will in turn resync on execution (via the queue) and call back
     SqlQueryHolderEx* holderEx = new SqlQueryHolderEx(this, callback, queue);
-    thread->Delay(holderEx);
+    db->DelayOperation(holderEx, m_shardKey);
     return true;
 }
 
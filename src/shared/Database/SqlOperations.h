@@ -23,6 +23,9 @@
 
 #include "LockedQueue.h"
 #include <queue>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include "Utilities/Callback.h"
 
 /// ---- BASE ---
@@ -56,16 +59,47 @@ class SqlTransaction : public SqlOperation
 {
     private:
         std::vector<SqlOperation* > m_queue;
+        uint32 m_shardKey;
 
     public:
-        SqlTransaction() {}
+        SqlTransaction(uint32 shardKey = 0) : m_shardKey(shardKey) {}
         ~SqlTransaction();
 
         void DelayExecute(SqlOperation* sql) { m_queue.push_back(sql); }
+        uint32 GetShardKey() const { return m_shardKey; }
+        uint32 GetSize() const { return uint32(m_queue.size()); }
 
         bool Execute(SqlConnection* conn) override;
 };
 
+/// Operation without shard key, executed once every async connection finished the operations queued before it
+/// and before any operation queued after it, see Database::DelayOperation()
+class SqlBarrierRequest : public SqlOperation
+{
+    public:
+        struct Barrier
+        {
+            Barrier(SqlOperation* op, uint32 connections) : m_op(op), m_waiting(connections), m_done(false) {}
+            ~Barrier() { delete m_op; }
+
+            std::mutex m_lock;
+            std::condition_variable m_doneCond;
+            SqlOperation* m_op;
+            uint32 m_waiting;                               // connections not at the barrier yet
+            bool m_done;
+        };
+
+        typedef std::shared_ptr<Barrier> BarrierPtr;
+
+        explicit SqlBarrierRequest(BarrierPtr const& barrier) : m_barrier(barrier) {}
+
+        // the last connection reaching the barrier executes the operation, the others wait for it
+        bool Execute(SqlConnection* conn) override;
+
+    private:
+        BarrierPtr m_barrier;
+};
+
 class SqlPreparedRequest : public SqlOperation
 {
     public:
@@ -113,15 +147,19 @@ class SqlQueryHolder
     private:
         typedef std::pair<const char*, QueryResult*> SqlResultPair;
         std::vector<SqlResultPair> m_queries;
+        uint32 m_shardKey;
     public:
-        SqlQueryHolder() {}
+        SqlQueryHolder() : m_shardKey(0) {}
         ~SqlQueryHolder();
+        // queries are executed in order with transactions using the same shard key
+        void SetShardKey(uint32 shardKey) { m_shardKey = shardKey; }
+        uint32 GetShardKey() const { return m_shardKey; }
         bool SetQuery(size_t index, const char* sql);
         bool SetPQuery(size_t index, const char* format, ...) ATTR_PRINTF(3, 4);
         void SetSize(size_t size);
         QueryResult* GetResult(size_t index);
         void SetResult(size_t index, QueryResult* result);
-        bool Execute(MaNGOS::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue);
+        bool Execute(MaNGOS::IQueryCallback* callback, Database* db, SqlResultQueue* queue);
 };
 
 class SqlQueryHolderEx : public SqlOperation
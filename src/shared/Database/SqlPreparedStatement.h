@@ -206,6 +206,8 @@ class MANGOS_DLL_SPEC SqlStatement
 
         bool Execute();
         bool DirectExecute();
+        // synchronous query, result is read with the native (binary) protocol where the DBMS supports it
+        QueryResult* Query();
 
         // templates to simplify 1-4 parameter bindings
         template<typename ParamType1>
@@ -242,6 +244,30 @@ class MANGOS_DLL_SPEC SqlStatement
             return Execute();
         }
 
+        template<typename ParamType1>
+        QueryResult* PQuery(ParamType1 param1)
+        {
+            arg(param1);
+            return Query();
+        }
+
+        template<typename ParamType1, typename ParamType2>
+        QueryResult* PQuery(ParamType1 param1, ParamType2 param2)
+        {
+            arg(param1);
+            arg(param2);
+            return Query();
+        }
+
+        template<typename ParamType1, typename ParamType2, typename ParamType3>
+        QueryResult* PQuery(ParamType1 param1, ParamType2 param2, ParamType3 param3)
+        {
+            arg(param1);
+            arg(param2);
+            arg(param3);
+            return Query();
+        }
+
         // bind parameters with specified type
         void addBool(bool var) { arg(var); }
         void addUInt8(uint8 var) { arg(var); }
@@ -314,6 +340,8 @@ class MANGOS_DLL_SPEC SqlPreparedStatement
 
         // execute statement w/o result set
         virtual bool execute() = 0;
+        // execute query statement, returns nullptr on error or empty result set
+        virtual QueryResult* query() = 0;
 
     protected:
         SqlPreparedStatement(const std::string& fmt, SqlConnection& conn) :
@@ -344,6 +372,8 @@ class MANGOS_DLL_SPEC SqlPlainPreparedStatement : public SqlPreparedStatement
 
         virtual bool execute() override;
 
+        virtual QueryResult* query() override;
+
     protected:
         void DataToString(const SqlStmtFieldData& data, std::ostringstream& fmt);
 
@@ -880,6 +880,14 @@ void Log::outErrorScriptLib(const char* err, ...)
 }
 
 void Log::outWorldPacketDump(uint32 socket, uint32 opcode, char const* opcodeName, ByteBuffer const* packet, bool incoming)
+{
+    if (!worldLogfile)
+        return;
+
+    outWorldPacketDump(socket, opcode, opcodeName, packet->empty() ? nullptr : packet->contents(), packet->size(), incoming);
+}
+
+void Log::outWorldPacketDump(uint32 socket, uint32 opcode, char const* opcodeName, uint8 const* data, size_t size, bool incoming)
 {
     if (!worldLogfile)
         return;
@@ -890,13 +898,13 @@ void Log::outWorldPacketDump(uint32 socket, uint32 opcode, char const* opcodeNam
 
     fprintf(worldLogfile, "\n%s:\nSOCKET: %u\nLENGTH: %u\nOPCODE: %s (0x%.4X)\nDATA:\n",
             incoming ? "CLIENT" : "SERVER",
-            socket, static_cast<uint32>(packet->size()), opcodeName, opcode);
+            socket, static_cast<uint32>(size), opcodeName, opcode);
 
     size_t p = 0;
-    while (p < packet->size())
+    while (p < size)
     {
-        for (size_t j = 0; j < 16 && p < packet->size(); ++j)
-            fprintf(worldLogfile, "%.2X ", (*packet)[p++]);
+        for (size_t j = 0; j < 16 && p < size; ++j)
+            fprintf(worldLogfile, "%.2X ", data[p++]);
 
         fprintf(worldLogfile, "\n");
     }
@@ -0,0 +1,111 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Unbounded lock-free queue for many producers and a single consumer.
+ *
+ * add() never waits: a producer swaps itself in as the newest node and links the previous
+ * one to it afterwards. A node whose link is not written yet looks like the end of the queue
+ * to next(), the consumer simply sees it on its following call. Only one thread at a time may
+ * call next().
+ */
+template <class T>
+class MPSCQueue
+{
+    public:
+        MPSCQueue() : m_size(0)
+        {
+            Node* stub = new Node();
+            m_head.store(stub, std::memory_order_relaxed);
+            m_tail = stub;
+        }
+
+        ~MPSCQueue()
+        {
+            T item;
+            while (next(item)) {}
+
+            delete m_tail;
+        }
+
+        //! Adds an item to the queue, safe from any thread.
+        void add(T const& item)
+        {
+            Node* node = new Node(item);
+
+            m_size.fetch_add(1, std::memory_order_relaxed);
+
+            Node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+            prev->next.store(node, std::memory_order_release);
+        }
+
+        //! Gets the oldest item, if any. Consumer thread only.
+        bool next(T& result)
+        {
+            Node* tail = m_tail;
+            Node* next = tail->next.load(std::memory_order_acquire);
+            if (!next)
+                return false;
+
+            result = next->data;
+            m_tail = next;
+            delete tail;
+
+            m_size.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        //! Gets the oldest item only if the checker accepts it, the item stays queued otherwise. Consumer thread only.
+        template<class Checker>
+        bool next(T& result, Checker& check)
+        {
+            Node* next = m_tail->next.load(std::memory_order_acquire);
+            if (!next || !check.Process(next->data))
+                return false;
+
+            return this->next(result);
+        }
+
+        //! Number of items added and not taken yet, only a snapshot when producers are active.
+        size_t size() const { return m_size.load(std::memory_order_relaxed); }
+
+    private:
+        struct Node
+        {
+            Node() : data(), next(nullptr) {}
+            explicit Node(T const& item) : data(item), next(nullptr) {}
+
+            T data;
+            std::atomic<Node*> next;
+        };
+
+        MPSCQueue(MPSCQueue const&);
+        MPSCQueue& operator=(MPSCQueue const&);
+
+        std::atomic<Node*> m_head;                          // newest node, producers swap here
+        Node* m_tail;                                       // already consumed node, its next is the oldest item
+        std::atomic<size_t> m_size;
+};
+
+#endif
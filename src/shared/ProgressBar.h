@@ -30,6 +30,7 @@ class MANGOS_DLL_SPEC BarGoLink
         void step();
 
         static void SetOutputState(bool on);
+        static bool GetOutputState();
     private:
         void init(int row_count);
 
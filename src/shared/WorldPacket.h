@@ -23,6 +23,8 @@
 #include "ByteBuffer.h"
 #include "Opcodes.h"
 
+#include <memory>
+
 // Note: m_opcode and size stored in platfom dependent format
 // ignore endianess until send, and converted at receive
 class WorldPacket : public ByteBuffer
@@ -49,7 +51,81 @@ class WorldPacket : public ByteBuffer
         void SetOpcode(Opcodes opcode) { m_opcode = opcode; }
         inline const char* GetOpcodeName() const { return LookupOpcodeName(m_opcode); }
 
+        // hand over written data without copying it, packet is empty afterwards
+        void ReleaseStorage(std::vector<uint8>& storage)
+        {
+            storage.clear();
+            storage.swap(_storage);
+            clear();
+        }
+
     protected:
         Opcodes m_opcode;
 };
+
+// Read only packet with reference counted data, queued on sockets without copying it again.
+// Used for packets sent to many players: data is copied (or taken over) at most once and every
+// socket keeps a reference until the packet is written.
+class SharedWorldPacket
+{
+    public:
+        typedef std::shared_ptr<std::vector<uint8> const> DataPtr;
+
+        // refers to the packet, its data is copied only when a socket has to queue it or the object is copied
+        // (broadcast batches), so packets merged into every output buffer are never copied here
+        // the packet must not change or be destroyed before this object
+        explicit SharedWorldPacket(WorldPacket const& packet) : m_opcode(packet.GetOpcode()), m_source(&packet) {}
+
+        // take over packet data, packet is empty afterwards
+        explicit SharedWorldPacket(WorldPacket&& packet) : m_opcode(packet.GetOpcode()), m_source(nullptr)
+        {
+            std::shared_ptr<std::vector<uint8> > data = std::make_shared<std::vector<uint8> >();
+            packet.ReleaseStorage(*data);
+            m_data = data;
+        }
+
+        // copies share the data, which is copied from the source packet first if it was not yet
+        SharedWorldPacket(SharedWorldPacket const& other) : m_opcode(other.m_opcode), m_data(other.GetData()), m_source(nullptr) {}
+
+        SharedWorldPacket& operator=(SharedWorldPacket const& other)
+        {
+            m_opcode = other.m_opcode;
+            m_data = other.GetData();
+            m_source = nullptr;
+            return *this;
+        }
+
+        Opcodes GetOpcode() const { return m_opcode; }
+        inline const char* GetOpcodeName() const { return LookupOpcodeName(m_opcode); }
+
+        size_t size() const { return m_source ? m_source->size() : m_data->size(); }
+        bool empty() const { return size() == 0; }
+        uint8 const* contents() const
+        {
+            if (m_source)
+                return m_source->empty() ? nullptr : m_source->contents();
+
+            return m_data->empty() ? nullptr : &(*m_data)[0];
+        }
+
+        DataPtr const& GetData() const
+        {
+            if (m_source)
+            {
+                if (m_source->empty())
+                    m_data = std::make_shared<std::vector<uint8> const>();
+                else
+                    m_data = std::make_shared<std::vector<uint8> const>(m_source->contents(), m_source->contents() + m_source->size());
+
+                m_source = nullptr;
+            }
+
+            return m_data;
+        }
+
+    private:
+        Opcodes m_opcode;
+        mutable DataPtr m_data;
+        mutable WorldPacket const* m_source;                // data not copied yet
+};
 #endif
@@ -2,5 +2,5 @@
 #define __REVISION_SQL_H__
  #define REVISION_DB_REALMD "required_10008_01_realmd_realmd_db_version"
  #define REVISION_DB_CHARACTERS "required_12937_01_characters_pvpstats"
- #define REVISION_DB_MANGOS "required_12938_01_mangos_scriptdev2_tables"
+ #define REVISION_DB_MANGOS "required_12949_01_mangos_command"
 #endif // __REVISION_SQL_H__